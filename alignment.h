@@ -12,25 +12,38 @@ Contiene funciones para crear e imprimir los códigos de edición de los alineam
 
 Esta librería utiliza las siguientes estructuras como base::
 
+		typedef struct PathNode_struct
+		// Entrada de un camino del traceback, los caminos que empiezan igual (desde la entrada inicial) comparten sus nodos
+		{
+			int I, J;//Posición de la entrada en la matriz
+			int Pointer;//Puntero que sigue el camino desde esta entrada, -1 en la entrada donde termina
+			int Depth;//Número de entradas desde la inicial (0 en la inicial)
+			const struct PathNode_struct *Parent;//Entrada anterior del camino (más cercana a la inicial), NULL en la inicial
+			
+		} PathNode;
+		//___________________________________________________________
+		
+		
 		typedef struct Path_struct
 		// Elemento fundamental de la estructura Traceback
 		{
-			int iSize;//Número de entradas inicializadas
-			int uSize;//Número de entradas no inicializadas
+			int iSize;//Número de entradas del camino
 			float pScore;//Score del camino
-			int **Path;//Arreglo de entradas, cada entrada consiste de tres enteros, que comprenden una posición en la matriz y un puntero
+			const PathNode *Last;//Entrada donde termina el camino (sin punteros); el camino completo se recorre hacia atrás por los Parent
 		} Path;
 		//___________________________________________________________
 		
 		
 		typedef struct Traceback_struct
-		//Contiene implícitamente cada alineamiento desde una celda de una matriz de alineamiento A_Matrix
+		//Contiene implícitamente cada alineamiento desde una celda de una matriz de alineamiento A_Matrix, como un árbol de entradas compartidas
 		{
-			char *Str1;
-			char *Str2;
+			const char *Str1;//Las de la matriz, no se copian
+			const char *Str2;
 			int iPaths;//Número de caminos inicializados
 			int uPaths;//Número de caminos no inicializados
 			Path *Paths;//Arreglo de caminos
+			Arena *Pool;//Arena de la que salen los nodos de todos los caminos, se libera de una sola vez
+			size_t nNodes;//Número de nodos: la memoria es proporcional a las entradas distintas del árbol, no a caminos por longitud
 			
 		} Traceback;
 		//___________________________________________________________
@@ -42,6 +55,7 @@ Esta librería utiliza las siguientes estructuras como base::
 			float Score;
 			char *Align1;
 			char *Align2;
+			char *EditTr;//Código de edición; las tres cadenas están en un solo bloque que empieza en Align1 (ver AllocExplAlign())
 			
 		} Align;
 		//___________________________________________________________
@@ -49,26 +63,80 @@ Esta librería utiliza las siguientes estructuras como base::
 
 Las siguientes son las funciones declaradas aquí:
 
-:void GlobalAlignment(const char *str1, const char *str2, const char *type, const float *scores):
+:void GlobalAlignment(const char *str1, const char *str2, const char *type, const float *scores, const AlignOptions *options):
 	Obtiene e imprime todos los alineamientos globales óptimos de str1 y str2 con las características especificadas.
+	options puede ser NULL para usar las opciones por defecto.
+	
+:void LocalAlignment(const char *str1, const char *str2, const char *type, const float *scores, const AlignOptions *options):
+	Obtiene e imprime todos los alineamientos locales óptimos (Smith-Waterman) de str1 y str2 que terminan en la mejor entrada de la matriz.
+	
+:void GlobalAlignmentScore(const char *str1, const char *str2, const char *type, const float *scores, const AlignOptions *options):
+	Obtiene e imprime sólo el puntaje óptimo del alineamiento global, con memoria O(min(m,n)); en los formatos de registros, como un registro sin CIGAR.
+
+:void PrintAlignHeader(const char *title, const char *str1, const char *str2, const char *type, const float *scores):
+	Imprime el encabezado de un alineamiento: título, cadenas, scores y tipo de matriz.
 	
 :Align *ExplAlignsFromTraceback(const Traceback *traceback):
 	Obtiene los alineamientos desde los caminos obtenidos.
 	
-:void PrintExplAlign(const Align *align):
-	Muestra el alineamiento explícito Align.
+:void ExplAlignFromPath(const Traceback *traceback, const int path, Align *align):
+	Arma en align el alineamiento del camino path, recorriendo sus nodos hacia atrás (sólo cuando se pide).
+
+:void AllocExplAlign(Align *align, const int len):
+	Aloja en un solo bloque Align1, Align2 y EditTr, con espacio para len columnas.
+
+:void SetAlignColumn(Align *align, const int k, const char c1, const char c2):
+	Escribe la columna k del alineamiento y su letra del código de edición, en cualquier orden y en tiempo constante.
+
+:void EndExplAlign(Align *align, const int len):
+	Termina las tres cadenas del alineamiento después de len columnas.
+
+:char EditOp(const char c1, const char c2):
+	Letra del código de edición (M, R, I o D) de la columna con c1 sobre c2.
+	
+:Align *ExplAlignFromPointers(const char *str1, const char *str2, const char *pointers, const int n_pointers, const float score):
+	Genera un arreglo con un solo alineamiento a partir de los punteros de un camino, ordenados desde la entrada (0,0).
+	
+:Align *ExplAlignFromOps(const char *str1, const char *str2, const float *scores, char *ops):
+	Genera un arreglo con un solo alineamiento a partir de ops, donde ops[i+j] es el puntero que llega a la entrada (i,j) del camino (o 0).
+	
+:void PrintExplAlign(Writer *out, const Align *align):
+	Escribe en out el alineamiento explícito Align.
 	
-:void PrintAlignments(const Align *align):
-	Imprime los alineamientos en el arreglo alignments.
+:void PrintAlignments(const Align *align, const char *str1, const char *str2, const AlignOptions *options):
+	Imprime los alineamientos de str1 y str2 en el arreglo alignments en options->Out, con su formato; con options->CigarOnly, sólo sus corridas.
+	
+:void PrintTraceback(Writer *out, const Traceback *traceback, const int cigar_only):
+	Escribe en out los alineamientos de todos los caminos de traceback (ver TracebackFromMatrixEntry()), con el formato de out.
+	
+:int PrintAlignIterator(AlignIterator *iterator, const int max_aligns, Writer *out, const int cigar_only):
+	Imprime en out a lo más max_aligns alineamientos del iterador (ver AllocAlignIterator()) conforme se obtienen, 0 para todos. Devuelve cuántos fueron.
+	Si cigar_only, sólo imprime sus corridas (ver NextCigar()) y nunca arma las cadenas con huecos.
+
+:void PrintStackAlign(Writer *out, AlignIterator *iterator, const int cigar_only):
+	Escribe en out el alineamiento del camino que está en la pila del iterador, con el formato de out.
+	
+:void PrintAlignsFromEntry(const A_Matrix *AlignMatrix, const int i, const int j, const AlignOptions *options):
+	Imprime los alineamientos óptimos desde la entrada (i,j) de la matriz conforme se obtienen, o sólo cuántos son (options->CountOnly).
+	Con options->MaxAligns>0 se detiene después de ese número de alineamientos e indica si quedaron más.
+	Con options->Sample>0 imprime ese número de alineamientos elegidos al azar con probabilidad uniforme.
+	Con options->CigarOnly imprime cada alineamiento como sus corridas (CIGAR), sin armar las cadenas con huecos.
+	Con options->TreeTraceback obtiene primero todos los caminos, en un árbol de nodos (ver TracebackFromMatrixEntry()), y luego los imprime.
+	
+:void PrintAlignNumber(Writer *out, const Align *align, const int number):
+	Escribe en out un alineamiento con su número y su código de edición.
 	
 :void FreeAligns(Align *alignments):
 	Libera el espacio ocupado por la estructura alignments previamente alojada por ExplAlignsFromTraceback().
+
+:void FreeExplAlign(Align *align):
+	Libera el bloque de las cadenas de un alineamiento alojado con AllocExplAlign().
 	
 :char *EditTrFromExplAlign(const Align *align):
-	Genera el código de edición asociado al alineamiento Align.
+	Genera el código de edición asociado al alineamiento Align, en tiempo lineal.
 	
-void PrintEditTr(const char *edit_tr):
-	Muestra el código de edición en el mismo formato en que se muestra el alineamiento en PrintExplAlign().
+:void PrintEditTr(Writer *out, const char *edit_tr):
+	Escribe en out el código de edición en el mismo formato en que se muestra el alineamiento en PrintExplAlign().
 
 
 Los prototipos de las funciones y las estructuras están declarados en el archivo alignments_headers.h
@@ -87,6 +155,7 @@ Los algoritmos están basados en los encontrados en el libro:
 # include <assert.h>//Para verificar errores con la función assert()
 # include <stdlib.h>//Para usar malloc(), calloc(), realloc(), free()
 # include <string.h>//Para usar strlen() y strcpy()
+# include <unistd.h>//Para usar STDOUT_FILENO
 # include "alignments_headers.h"
 
 int debug; // Variable global para debugear :P
@@ -99,112 +168,214 @@ int debug; // Variable global para debugear :P
 */
 
 
-void GlobalAlignment(const char *str1, const char *str2, const char *type, const float *scores)
+void GlobalAlignment(const char *str1, const char *str2, const char *type, const float *scores, const AlignOptions *options)
 /*
  * A partir de las cadenas, costos y el tipo de alineamiento, obtiene los alineamientos globales óptimos
+ * options (o NULL para las opciones por defecto) elige el motor de llenado, sus hilos, si se imprime su rendimiento
+ * y el semiancho inicial de la banda (options->Band<0 para llenar la matriz completa).
+ * Con costos unitarios (distancia de Levenshtein) y el motor automático, la distancia se calcula primero por vectores de bits (ver myers.h)
+ * y sólo se llena la banda que contiene a todos los alineamientos óptimos, con los mismos resultados que la matriz completa.
+ * Si options->XDrop no es negativo y type es "max", la matriz se llena con la terminación X-drop (ver xdrop.h) y se imprimen
+ * las mejores extensiones: los alineamientos óptimos de prefijos de str1 y str2 que terminan en la mejor entrada calculada.
+ * Si options->Subst no es NULL, los apareamientos y reemplazos se califican con esa matriz de sustitución en lugar de M y R.
+ * Si options->CountOnly es verdadero sólo se imprime cuántos alineamientos óptimos hay (ver CountAlignments()),
+ * si options->MaxAligns es positivo se imprimen a lo más ese número de alineamientos y si options->Sample es positivo,
+ * ese número de alineamientos elegidos al azar.
  */
 {
 	//char *align_type=strdup("global");
 	char align_type[]="global";
-	printf("\n====================\nAlineamiento Global.\n====================\n\n");
-	printf("Str1:\t%s\nStr2:\t%s\n", str1, str2);//Imprime las cadenas
-	printf("Scores:\t[%f, %f, %f, %f]\n", scores[0], scores[1], scores[2], scores[3]);//Imprime los scores
-	printf("Alineamiento por %s (%s).\n",
-		   (equStr(type, "min") ? "distancia" : "similaridad"), type); // Imprime el modo de encontrar el score
+	const S_Matrix *subst=(options != NULL ? (options->Subst) : NULL);
+	PrintAlignHeader("Alineamiento Global.", str1, str2, type, scores);
+	if(subst != NULL)
+		printf("Matriz de sustitución:\t%s (en lugar de M y R)\n", (subst->Name));
 	
-	//Obtiene la matriz de alineamiento
-	A_Matrix *AlignMatrix = AllocAlignMatrix(str1, str2, type, align_type, scores);//Genera espacio para la matriz
+	//Obtiene la matriz de alineamiento, completa o sólo una banda alrededor de la diagonal principal
+	int band=(options != NULL ? (options->Band) : -1);
+	if(band < 0 && (options == NULL || (options->Engine) == NULL) && subst == NULL && UnitCostScores(type, scores))
+		band=MyersBand(str1, str2);//Distancia de Levenshtein: la banda más angosta que contiene a todos los alineamientos óptimos
+	A_Matrix *AlignMatrix = AllocBandedAlignMatrix(str1, str2, type, align_type, scores, band);//Genera espacio para la matriz
+	if(options != NULL)
+	{
+		(AlignMatrix->Engine) = (options->Engine);//Motor de llenado elegido (NULL para elegirlo automáticamente)
+		(AlignMatrix->Threads) = (options->Threads);//Hilos para el llenado por bloques
+		(AlignMatrix->XDrop) = (options->XDrop);//Umbral de la terminación X-drop (negativo para no usarla)
+		SetSubstMatrix(AlignMatrix, subst);//Apareamientos y reemplazos de la matriz de sustitución (si hay)
+	}
 	
-	FillAlignMatrix(AlignMatrix);//Llena la matriz
+	FillAlignMatrix(AlignMatrix);//Llena la matriz (duplicando la banda si hace falta)
+	if(options != NULL && (options->Stats))
+		PrintFillStats(AlignMatrix);
 	//PrintAlignMatrix(AlignMatrix);
 	
-	//Obtén los caminos
-	Traceback *traceback=TracebackFromMatrixEntry(AlignMatrix,-1, -1);
+	if(equStr(AlignMatrix->Engine, "xdrop"))
+	{
+		printf("\nCeldas omitidas (X-drop):\t%.0f\n", (AlignMatrix->Skipped));
+		printf("Mejor entrada:\t(%d, %d)\tScore:\t%f\n", (AlignMatrix->BestRow), (AlignMatrix->BestCol),
+			   GetValue(AlignMatrix, AlignMatrix->BestRow, AlignMatrix->BestCol));
+		PackTraceback(AlignMatrix, (AlignMatrix->BestRow), (AlignMatrix->BestCol));
+		//Las mejores extensiones: desde la mejor entrada hasta la (0,0), la única entrada viva sin punteros
+		PrintAlignsFromEntry(AlignMatrix, (AlignMatrix->BestRow), (AlignMatrix->BestCol), options);
+		FreeAlignMatrix(AlignMatrix);
+		return;
+	}
+	
+	//Recorre los caminos sólo con los punteros empacados
+	PackTraceback(AlignMatrix, (AlignMatrix->Rows)-1, (AlignMatrix->Cols)-1);
+	
+	//Imprime los alineamientos globales óptimos conforme se obtienen, uno por uno (o sólo cuántos son)
+	PrintAlignsFromEntry(AlignMatrix, -1, -1, options);
 	
 	//Libera el espacio ocupado por la matriz
 	FreeAlignMatrix(AlignMatrix);
+}//___________________________________________________________
+
+
+
+void LocalAlignment(const char *str1, const char *str2, const char *type, const float *scores, const AlignOptions *options)
+/*
+ * A partir de las cadenas y costos, obtiene los alineamientos locales óptimos: los de las subcadenas de str1 y str2 con el mejor puntaje.
+ * La matriz se llena con el alineamiento local (ver FillAlignMatrix()), que siempre es de similaridad (type "max"),
+ * y se recuperan todos los alineamientos óptimos que terminan en la mejor entrada (AlignMatrix->BestRow, BestCol).
+ * options (o NULL para las opciones por defecto) elige el motor de llenado, sus hilos, si se imprime su rendimiento
+ * y la matriz de sustitución (options->Subst, NULL para usar M y R); la banda no se usa.
+ */
+{
+	char align_type[]="local";
+	if(type == NULL || !equStr(type, "max"))
+	{
+		printf("\nADVERTENCIA: El alineamiento local requiere una matriz de similaridad, se ha usado el tipo \"max\"\n");
+		type="max";
+	}
+	PrintAlignHeader("Alineamiento Local.", str1, str2, type, scores);
+	if(options != NULL && (options->Subst) != NULL)
+		printf("Matriz de sustitución:\t%s (en lugar de M y R)\n", (options->Subst)->Name);
 	
-	//Obtén los alineamientos globales óptimos de la matriz
-	Align *aligns=ExplAlignsFromTraceback(traceback);//El arreglo de alineamientos
-	
-	//Libera el espacio ocupado por los caminos
-	FreeTraceback(traceback);
+	A_Matrix *AlignMatrix = AllocAlignMatrix(str1, str2, type, align_type, scores);//Genera espacio para la matriz completa
+	if(options != NULL)
+	{
+		(AlignMatrix->Engine) = (options->Engine);//Motor de llenado elegido (NULL para elegirlo automáticamente)
+		(AlignMatrix->Threads) = (options->Threads);//Hilos para el llenado por bloques
+		SetSubstMatrix(AlignMatrix, options->Subst);//Apareamientos y reemplazos de la matriz de sustitución (si hay)
+	}
 	
-	//Imprime los alineamientos
-	PrintAlignments(aligns);
+	FillAlignMatrix(AlignMatrix);//Llena la matriz y encuentra la mejor entrada
+	if(options != NULL && (options->Stats))
+		PrintFillStats(AlignMatrix);
+	printf("\nMejor entrada:\t(%d, %d)\tScore:\t%f\n", (AlignMatrix->BestRow), (AlignMatrix->BestCol),
+		   GetValue(AlignMatrix, AlignMatrix->BestRow, AlignMatrix->BestCol));
+	PackTraceback(AlignMatrix, (AlignMatrix->BestRow), (AlignMatrix->BestCol));//Sólo se necesitan los punteros
 	
-	FreeAligns(aligns);
+	//Imprime los caminos desde la mejor entrada conforme se obtienen, terminan donde el puntaje vuelve a 0
+	PrintAlignsFromEntry(AlignMatrix, (AlignMatrix->BestRow), (AlignMatrix->BestCol), options);
+	FreeAlignMatrix(AlignMatrix);
+}//___________________________________________________________
+
+
+
+void GlobalAlignmentScore(const char *str1, const char *str2, const char *type, const float *scores, const AlignOptions *options)
+/*
+ * Obtiene e imprime sólo el puntaje óptimo del alineamiento global, sin matriz de alineamiento ni traceback.
+ * Usa memoria O(min(m,n)) por medio de GlobalScore().
+ * Si options->Out es de un formato de registros (TSV, JSONL, SAM o binario) el puntaje se escribe ahí como un registro
+ * sin corridas (ver WriteAlignRecord()), uno por cada par de cadenas; si no (o si options es NULL), se imprime con printf().
+ */
+{
+	Writer *out=(options != NULL ? (options->Out) : NULL);
+	PrintAlignHeader("Alineamiento Global.", str1, str2, type, scores);
+	float score=GlobalScore(str1, str2, type, scores);
+	if(out == NULL || (out->Format) == FORMAT_TEXT)
+	{
+		printf("\nScore:\t%f\n", score);
+		return;
+	}
+	Cigar cigar;//Sin corridas: no se obtuvo el alineamiento
+	(cigar.Score)=score, (cigar.Start1)=0, (cigar.Start2)=0, (cigar.nRuns)=0, (cigar.Size)=0, (cigar.Lengths)=NULL, (cigar.Ops)=NULL;
+	WriteAlignRecord(out, &cigar, 1, str1, str2);
+	FlushWriter(out);
+}//___________________________________________________________
+
+
+
+void PrintAlignHeader(const char *title, const char *str1, const char *str2, const char *type, const float *scores)
+/*
+ * Imprime el encabezado de un alineamiento: el título subrayado, las cadenas, los scores y el modo (distancia o similaridad).
+ */
+{
+	int i, len=strlen(title);
+	printf("\n");
+	for(i=0; i<len; i++)
+		printf("=");
+	printf("\n%s\n", title);
+	for(i=0; i<len; i++)
+		printf("=");
+	printf("\n\n");
+	printf("Str1:\t%s\nStr2:\t%s\n", str1, str2);//Imprime las cadenas
+	printf("Scores:\t[%f, %f, %f, %f]\n", scores[0], scores[1], scores[2], scores[3]);//Imprime los scores
+	printf("Alineamiento por %s (%s).\n",
+		   (equStr(type, "min") ? "distancia" : "similaridad"), type); // Imprime el modo de encontrar el score
 }//___________________________________________________________
 
 
 
 Align *ExplAlignsFromTraceback(const Traceback *traceback)
 /*
- * Genera un arreglo de alineaminetos explícitos a partir de los caminos contenidos en traceback
+ * Genera un arreglo de alineaminetos explícitos a partir de los caminos contenidos en traceback, cada uno armado con ExplAlignFromPath().
+ * Los caminos globales terminan en la entrada (0,0), por lo que sus alineamientos incluyen las cadenas completas;
+ * los locales, en la entrada (i0,j0) sin punteros donde empiezan, y sólo incluyen las subcadenas alineadas (ver ExplAlignFromPath()).
+ * El arreglo termina con un alineamiento nulo.
  */
 {
-#define	STR1	(traceback->Str1)
-#define	STR2	(traceback->Str2)
-#define PATHSCORE(align)	((traceback->Paths)[align].pScore)
-#define	POINTER(align, align_pos)	((traceback->Paths)[align].Path)[align_pos][2]
-#define	NO_POINTERS	-1
-#define ALIGN1(align)	(aligns[align].Align1)
-#define ALIGN2(align)	(aligns[align].Align2)
-#define ALIGNSCORE(align)	(aligns[align].Score)
-#define DIAG	'\\'
-#define VERT	'|'
-#define HORI	'-'
-	//Inicializa variables importantes
-	int align, n_aligns=(traceback->iPaths), endS1, endS2, pos,i , j;
+	int align, n_aligns=(traceback->iPaths);
 	//Inicializa el espacio para el arreglo de alineamientos
 	Align *aligns=(Align *) malloc((n_aligns+1) * sizeof(Align));
 	assert(aligns != NULL);
 	//Obtén los alineamientos
 	for(align=0; align < n_aligns; align++)//Itera sobre cada camino
+		ExplAlignFromPath(traceback, align, &aligns[align]);
+	//Marca el final del arreglo con un alineamiento nulo.
+	aligns[n_aligns].Align1=NULL, aligns[n_aligns].Align2=NULL, aligns[n_aligns].EditTr=NULL;
+	return aligns;
+}//___________________________________________________________
+
+
+
+void ExplAlignFromPath(const Traceback *traceback, const int path, Align *align)
+/*
+ * Arma en align (alojando sus cadenas) el alineamiento explícito del camino path de traceback, sin tocar los demás caminos.
+ * El camino se recorre hacia atrás desde su último nodo (la entrada sin punteros (i0,j0) donde empieza el alineamiento) por los Parent:
+ * cada nodo, con su puntero hacia (i,j) desde (i',j'), es la siguiente columna (de izquierda a derecha) del alineamiento
+ * de Str1[j0..j) con Str2[i0..i), donde (i,j) es la entrada inicial del camino.
+ */
+{
+#define	STR1	(traceback->Str1)
+#define	STR2	(traceback->Str2)
+#define DIAG	'\\'
+#define VERT	'|'
+#define HORI	'-'
+	const PathNode *node=(traceback->Paths)[path].Last;
+	int len=(traceback->Paths)[path].iSize - 1, k, i, j;//Una columna del alineamiento por cada puntero del camino
+	(align->Score)=(traceback->Paths)[path].pScore;
+	AllocExplAlign(align, len);
+	for(node=(node->Parent), k=0; node != NULL; node=(node->Parent), k++)
 	{
-		//Obtén ambos alineamientos en reversa
-		endS1=strlen(STR1), endS2=strlen(STR2);//Obtén las dimensiones de los textos
-		//Inicializa el alineamineto número align
-		ALIGNSCORE(align)=PATHSCORE(align);//Coloca el score correspondiente
-		ALIGN1(align) = dupStr(STR1);//Copia la primera cadena
-		assert(ALIGN1(align) != NULL);
-		ALIGN2(align) = dupStr(STR2);//Copia la segunda cadena
-		assert(ALIGN2(align) != NULL);
-		//Arma los alineamientos
-		for(pos=0; POINTER(align, pos) != NO_POINTERS; pos++)
+		i=(node->I), j=(node->J);
+		switch(node->Pointer)
 		{
-			switch(POINTER(align, pos))//Dependiendo del tipo de puntero
-			{
-				case DIAG ://Hubo una coincidencia o reemplazo
-				{
-					break;
-				}
-				case HORI ://Hubo la eliminación de una letra de STR1 en STR2
-				{
-					insert('_', endS2-pos, ALIGN2(align));
-					endS2++;
-					break;
-				}
-				case VERT ://Hubo una inserción de una letra en STR1 para transformarla en STR2
-				{
-					insert('_', endS1-pos, ALIGN1(align));
-					endS1++;
-					break;
-				}
-			}
+			case DIAG ://Coincidencia o reemplazo
+				SetAlignColumn(align, k, STR1[j-1], STR2[i-1]);
+				break;
+			case VERT ://Inserción de una letra en STR1
+				SetAlignColumn(align, k, '_', STR2[i-1]);
+				break;
+			case HORI ://Eliminación de una letra de STR1
+				SetAlignColumn(align, k, STR1[j-1], '_');
+				break;
 		}
 	}
-	//Marca el final del arreglo con un alineamiento nulo.
-	ALIGN1(n_aligns)=NULL, ALIGN2(n_aligns)=NULL;
-	return aligns;
+	EndExplAlign(align, len);
 #undef STR1
 #undef STR2
-#undef PATHSCORE
-#undef POINTER
-#undef NO_POINTERS
-#undef ALIGN1
-#undef ALIGN2
-#undef ALIGNSCORE
 #undef DIAG
 #undef VERT
 #undef HORI
@@ -212,44 +383,177 @@ Align *ExplAlignsFromTraceback(const Traceback *traceback)
 
 
 
-void PrintExplAlign(const Align *align)
+void AllocExplAlign(Align *align, const int len)
+/*
+ * Aloja un solo bloque para las tres cadenas de un alineamiento de hasta len columnas: Align1, Align2 y EditTr, en ese orden,
+ * cada una con len+1 caracteres. Las columnas se escriben con SetAlignColumn() en cualquier orden (los caminos se recorren
+ * desde cualquiera de sus extremos) y las cadenas se terminan con EndExplAlign(), así que armar un alineamiento es O(len).
+ * El bloque se libera con FreeExplAlign().
+ */
+{
+	char *block=(char *) malloc(3 * ((size_t)len+1) * sizeof(char));
+	assert(block != NULL);
+	(align->Align1)=block, (align->Align2)=block + len+1, (align->EditTr)=block + 2*((size_t)len+1);
+	EndExplAlign(align, len);
+}//___________________________________________________________
+
+
+
+void SetAlignColumn(Align *align, const int k, const char c1, const char c2)
+/*
+ * Escribe la columna k del alineamiento: c1 en Align1, c2 en Align2 y su letra del código de edición en EditTr.
+ */
+{
+	(align->Align1)[k]=c1, (align->Align2)[k]=c2, (align->EditTr)[k]=EditOp(c1, c2);
+}//___________________________________________________________
+
+
+
+void EndExplAlign(Align *align, const int len)
+/*
+ * Termina Align1, Align2 y EditTr después de len columnas (a lo más las que se alojaron con AllocExplAlign()).
+ */
+{
+	(align->Align1)[len]='\0', (align->Align2)[len]='\0', (align->EditTr)[len]='\0';
+}//___________________________________________________________
+
+
+
+char EditOp(const char c1, const char c2)
+/*
+ * Devuelve la letra del código de edición de la columna con c1 (de Str1) sobre c2 (de Str2):
+ * I si c1 es un hueco, D si lo es c2, M si coinciden y R si no.
+ */
+{
+	if(c1 == '_')
+		return 'I';
+	if(c2 == '_')
+		return 'D';
+	return (c1 == c2 ? 'M' : 'R');
+}//___________________________________________________________
+
+
+
+Align *ExplAlignFromPointers(const char *str1, const char *str2, const char *pointers, const int n_pointers, const float score)
+/*
+ * Genera un arreglo con un solo alineamiento explícito a partir de los punteros de un camino,
+ * ordenados desde la entrada (0,0) hasta la última entrada de la matriz.
+ * El arreglo termina con un alineamiento nulo, igual que el de ExplAlignsFromTraceback().
+ */
+{
+#define DIAG	'\\'
+#define VERT	'|'
+#define HORI	'-'
+	Align *aligns=(Align *) malloc(2 * sizeof(Align));
+	assert(aligns != NULL);
+	AllocExplAlign(&aligns[0], n_pointers);
+	int k, i, j;
+	for(k=0, i=0, j=0; k<n_pointers; k++)
+	{
+		switch(pointers[k])
+		{
+			case DIAG ://Coincidencia o reemplazo
+				SetAlignColumn(&aligns[0], k, str1[j++], str2[i++]);
+				break;
+			case VERT ://Inserción de una letra en STR1
+				SetAlignColumn(&aligns[0], k, '_', str2[i++]);
+				break;
+			case HORI ://Eliminación de una letra de STR1
+				SetAlignColumn(&aligns[0], k, str1[j++], '_');
+				break;
+		}
+	}
+	EndExplAlign(&aligns[0], n_pointers);
+	aligns[0].Score=score;
+	aligns[1].Align1=NULL, aligns[1].Align2=NULL, aligns[1].EditTr=NULL;//Marca el final del arreglo
+	return aligns;
+#undef DIAG
+#undef VERT
+#undef HORI
+}//___________________________________________________________
+
+
+
+Align *ExplAlignFromOps(const char *str1, const char *str2, const float *scores, char *ops)
+/*
+ * Genera un arreglo con un solo alineamiento explícito a partir del camino en ops (de longitud strlen(str1)+strlen(str2)+1),
+ * donde ops[i+j] es el puntero que llega a la entrada (i,j) del camino, o 0 si el camino no pasa por la antidiagonal i+j.
+ * Compacta los punteros al principio de ops (que se modifica) y calcula el puntaje del camino con los costos scores.
+ */
+{
+#define DIAG	'\\'
+#define VERT	'|'
+#define HORI	'-'
+	int len1=strlen(str1), len2=strlen(str2);
+	int k, n, i, j;
+	float score=0;
+	for(k=1, n=0, i=0, j=0; k<=len1+len2; k++)
+	{
+		if(ops[k] == 0)
+			continue;
+		switch(ops[k])
+		{
+			case DIAG:
+				score+=(str1[j]!=str2[i] ? scores[1] : scores[0]);
+				i++, j++;
+				break;
+			case VERT:
+				score+=scores[2];
+				i++;
+				break;
+			case HORI:
+				score+=scores[3];
+				j++;
+				break;
+		}
+		ops[n++]=ops[k];
+	}
+	return ExplAlignFromPointers(str1, str2, ops, n, score);
+#undef DIAG
+#undef VERT
+#undef HORI
+}//___________________________________________________________
+
+
+
+void PrintExplAlign(Writer *out, const Align *align)
+/*
+ * Escribe en out el puntaje y las dos cadenas con huecos del alineamiento, un caracter y un espacio por columna.
+ */
 {
 #define ALIGN1 (align->Align1)
 #define ALIGN2 (align->Align2)
 #define SCORE (align->Score)
-	printf("Score:\t%f\n", SCORE);
+	WriteFormat(out, "Score:\t%f\n", SCORE);
 	int len=strlen(ALIGN1),i;
-	printf("Str1:\t");
+	WriteStr(out, "Str1:\t");
 	for(i=0; i<len; i++)
-		printf("%c ", ALIGN1[i]);
-	printf("\nStr2:\t");
+		WriteChar(out, ALIGN1[i]), WriteChar(out, ' ');
+	WriteStr(out, "\nStr2:\t");
 	for(i=0; i<len; i++)
-		printf("%c ", ALIGN2[i]);
-	printf("\n");
+		WriteChar(out, ALIGN2[i]), WriteChar(out, ' ');
+	WriteChar(out, '\n');
 #undef ALIGN1
 #undef ALIGN2
+#undef SCORE
 }//___________________________________________________________
 
 
 
 char *EditTrFromExplAlign(const Align *align)
+/*
+ * Genera (alojándolo) el código de edición del alineamiento, una letra por columna (ver EditOp()), en tiempo lineal.
+ * Los alineamientos armados con AllocExplAlign() ya lo tienen en align->EditTr.
+ */
 {
 #define ALIGN1 (align->Align1)
 #define ALIGN2 (align->Align2)
-	int i;
-	char *EditTr=(char *) calloc(1, sizeof(char));
-	EditTr=strcpy(EditTr, "");
-	for(i=strlen(ALIGN1)-1; i>=0; i--)
-	{
-		if(ALIGN1[i]=='_')
-			insert('I', 0, EditTr);
- 		else if(ALIGN2[i]=='_')
- 			insert('D', 0, EditTr);
- 		else if(ALIGN1[i]==ALIGN2[i])
- 			insert('M', 0, EditTr);
- 		else
- 			insert('R', 0, EditTr);
-	}
+	int i, len=strlen(ALIGN1);
+	char *EditTr=(char *) malloc((len+1) * sizeof(char));
+	assert(EditTr != NULL);
+	for(i=0; i<len; i++)
+		EditTr[i]=EditOp(ALIGN1[i], ALIGN2[i]);
+	EditTr[len]='\0';
 	return EditTr;
 #undef ALIGN1
 #undef ALIGN2
@@ -257,29 +561,216 @@ char *EditTrFromExplAlign(const Align *align)
 
 
 
-void PrintEditTr(const char *EditTr)
+void PrintEditTr(Writer *out, const char *EditTr)
+/*
+ * Escribe en out el código de edición en el mismo formato que las cadenas de PrintExplAlign().
+ */
 {
 	int len=strlen(EditTr),i;
-	printf("EditTr:\t");
+	WriteStr(out, "EditTr:\t");
 	for(i=0; i<len; i++)
-		printf("%c ", EditTr[i]);
-	printf("\n");
+		WriteChar(out, EditTr[i]), WriteChar(out, ' ');
+	WriteChar(out, '\n');
 }//___________________________________________________________
 
 
 
-void PrintAlignments(const Align *alignments)
+void PrintAlignments(const Align *alignments, const char *str1, const char *str2, const AlignOptions *options)
 /*
- * 
+ * Imprime los alineamientos del arreglo alignments de str1 y str2, que termina con un alineamiento nulo, en options->Out
+ * (o en la salida estándar con el formato de texto si options o options->Out es NULL).
+ * Con options->CigarOnly, o en los formatos de registros, sólo se escriben las corridas de cada uno (ver CigarFromExplAlign()).
  */
 {
 	int i;
+	Writer *out=(options != NULL ? (options->Out) : NULL), *own=NULL;
+	if(out == NULL)
+		out=own=AllocWriter(STDOUT_FILENO, FORMAT_TEXT);
+	int cigar_only=((out->Format) != FORMAT_TEXT || (options != NULL && (options->CigarOnly)));
+	Cigar cigar;
+	AllocCigar(&cigar, 16);
 	for(i=0; (alignments[i].Align1)!=NULL; i++)
 	{
-		printf("\nAlineamiento número %d:\n", i+1);
-		PrintExplAlign(&alignments[i]);
-		PrintEditTr(EditTrFromExplAlign(&alignments[i]));
+		if(!cigar_only)
+		{
+			PrintAlignNumber(out, &alignments[i], i+1);
+			continue;
+		}
+		CigarFromExplAlign(&alignments[i], &cigar);
+		if((out->Format) == FORMAT_TEXT)
+			PrintCigarNumber(out, &cigar, i+1);
+		else
+			WriteAlignRecord(out, &cigar, i+1, str1, str2);
 	}
+	FreeCigar(&cigar);
+	FlushWriter(out);
+	FreeWriter(own);
+}//___________________________________________________________
+
+
+
+void PrintTraceback(Writer *out, const Traceback *traceback, const int cigar_only)
+/*
+ * Escribe en out, numerados desde 1, los alineamientos de todos los caminos de traceback (ver ExplAlignsFromTraceback()):
+ * como en PrintStackAlign(), en los formatos de registros o con cigar_only sólo se escriben sus corridas.
+ * Cada camino termina en la entrada (i0,j0) donde empieza su alineamiento, que es Start1=j0 y Start2=i0 en las corridas.
+ */
+{
+	int k;
+	const PathNode *start;
+	Align *aligns=ExplAlignsFromTraceback(traceback);
+	Cigar cigar;
+	AllocCigar(&cigar, 16);
+	for(k=0; (aligns[k].Align1)!=NULL; k++)
+	{
+		if((out->Format) == FORMAT_TEXT && !cigar_only)
+		{
+			PrintAlignNumber(out, &aligns[k], k+1);
+			continue;
+		}
+		CigarFromExplAlign(&aligns[k], &cigar);
+		start=(traceback->Paths)[k].Last;
+		(cigar.Start1)=(start->J), (cigar.Start2)=(start->I);
+		if((out->Format) == FORMAT_TEXT)
+			PrintCigarNumber(out, &cigar, k+1);
+		else
+			WriteAlignRecord(out, &cigar, k+1, (traceback->Str1), (traceback->Str2));
+	}
+	FreeCigar(&cigar);
+	FreeAligns(aligns);
+	FlushWriter(out);
+}//___________________________________________________________
+
+
+
+int PrintAlignIterator(AlignIterator *iterator, const int max_aligns, Writer *out, const int cigar_only)
+/*
+ * Imprime en out los alineamientos del iterador conforme NextPath() los obtiene, sin esperar a tenerlos todos (ver PrintStackAlign()):
+ * nunca hay más de uno en memoria y la salida se escribe por bloques. Devuelve el número de alineamientos impresos.
+ * Si max_aligns es positivo se detiene después de imprimir max_aligns alineamientos, sin recorrer los demás caminos.
+ * Al terminar vacía out, así que después se puede volver a usar printf().
+ */
+{
+	while((max_aligns <= 0 || (iterator->Count) < max_aligns) && NextPath(iterator))
+	{
+		(iterator->Count)++;
+		PrintStackAlign(out, iterator, cigar_only);
+	}
+	FlushWriter(out);
+	return (iterator->Count);
+}//___________________________________________________________
+
+
+
+void PrintStackAlign(Writer *out, AlignIterator *iterator, const int cigar_only)
+/*
+ * Escribe en out, con el número iterator->Count, el alineamiento del camino que está en la pila del iterador:
+ * en los formatos de registros (TSV, JSONL, SAM) o con cigar_only sólo se arman sus corridas (ver CigarFromStack());
+ * si no, también las cadenas con huecos y el código de edición (ver AlignFromStack()).
+ */
+{
+	const A_Matrix *AlignMatrix=(iterator->AlignMatrix);
+	if((out->Format) != FORMAT_TEXT)
+	{
+		CigarFromStack(iterator);
+		WriteAlignRecord(out, &(iterator->Runs), (iterator->Count), (AlignMatrix->Str1), (AlignMatrix->Str2));
+	}
+	else if(cigar_only)
+	{
+		CigarFromStack(iterator);
+		PrintCigarNumber(out, &(iterator->Runs), (iterator->Count));
+	}
+	else
+	{
+		AlignFromStack(iterator);
+		PrintAlignNumber(out, &(iterator->Current), (iterator->Count));
+	}
+}//___________________________________________________________
+
+
+
+void PrintAlignsFromEntry(const A_Matrix *AlignMatrix, const int i, const int j, const AlignOptions *options)
+/*
+ * Imprime los alineamientos óptimos desde la entrada (i,j) de la matriz llenada ((-1,-1) para la última) conforme se obtienen.
+ * Si options->CountOnly es verdadero sólo los cuenta con CountAlignments(), sin obtenerlos, e imprime cuántos son.
+ * Si options->MaxAligns es positivo imprime a lo más ese número de alineamientos; si quedaron más caminos (el iterador todavía
+ * encuentra uno) lo indica junto con el total de alineamientos óptimos, que se cuenta sin obtenerlos.
+ * Si options->Sample es positivo imprime ese número de alineamientos elegidos al azar con probabilidad uniforme (ver SampleAlign()),
+ * con la semilla options->Seed.
+ * Si options->CigarOnly es verdadero cada alineamiento se imprime como sus corridas (ver PrintCigarNumber()), sin armar las cadenas con huecos.
+ * Si options->TreeTraceback es verdadero se obtienen primero todos los caminos con TracebackFromMatrixEntry(), con sus nodos en una arena,
+ * y después se imprimen (ver PrintTraceback()), en el mismo orden que el iterador; con options->Stats se indica cuántos nodos ocuparon.
+ * Los alineamientos se escriben en options->Out con su formato (ver PrintStackAlign()), o en la salida estándar como texto si es NULL;
+ * los demás mensajes se imprimen con printf().
+ */
+{
+	if(options != NULL && (options->CountOnly))
+	{
+		char count[PATH_COUNT_DIGITS];
+		PathCount n=CountAlignments(AlignMatrix, i, j);
+		printf("\nAlineamientos óptimos:\t%s%s\n", (n == PATH_COUNT_MAX ? "al menos " : ""), PathCountStr(n, count));
+		return;
+	}
+	int max_aligns=(options != NULL ? (options->MaxAligns) : 0), cigar_only=(options != NULL && (options->CigarOnly));
+	Writer *out=(options != NULL ? (options->Out) : NULL), *own=NULL;
+	if(out == NULL)
+		out=own=AllocWriter(STDOUT_FILENO, FORMAT_TEXT);
+	if(options != NULL && (options->TreeTraceback))
+	{
+		//Todos los caminos a la vez: comparten sus nodos desde la entrada inicial y se liberan juntos con la arena
+		Traceback *traceback=TracebackFromMatrixEntry(AlignMatrix, i, j);
+		PrintTraceback(out, traceback, cigar_only);
+		FreeWriter(own);
+		if(options->Stats)
+			printf("\nTraceback en árbol:\t%d caminos, %zu nodos\n", (traceback->iPaths), (traceback->nNodes));
+		FreeTraceback(traceback);
+		return;
+	}
+	AlignIterator *iterator=AllocAlignIterator(AlignMatrix, i, j);
+	if(options != NULL && (options->Sample) > 0)
+	{
+		//Una muestra uniforme: contar los caminos una vez y elegir cada uno en O(m+n)
+		unsigned long long seed=(options->Seed);
+		printf("\nMuestra aleatoria uniforme de %d alineamientos óptimos (semilla %llu, con reemplazo)\n", (options->Sample), (options->Seed));
+		while((iterator->Count) < (options->Sample) && SamplePath(iterator, &seed))
+		{
+			(iterator->Count)++;
+			PrintStackAlign(out, iterator, cigar_only);
+		}
+		FlushWriter(out);
+		FreeWriter(own);
+		FreeAlignIterator(iterator);
+		return;
+	}
+	int printed=PrintAlignIterator(iterator, max_aligns, out, cigar_only);
+	FreeWriter(own);
+	if(max_aligns > 0 && printed == max_aligns && NextPath(iterator))
+	{
+		char count[PATH_COUNT_DIGITS];
+		PathCount n=CountAlignments(AlignMatrix, i, j);
+		printf("\nLista truncada:\tse imprimieron %d de %s%s alineamientos óptimos (--max-alignments=%d)\n",
+			   printed, (n == PATH_COUNT_MAX ? "al menos " : ""), PathCountStr(n, count), max_aligns);
+	}
+	FreeAlignIterator(iterator);
+}//___________________________________________________________
+
+
+
+void PrintAlignNumber(Writer *out, const Align *align, const int number)
+/*
+ * Escribe en out el alineamiento align con su número, su puntaje y su código de edición.
+ */
+{
+	WriteFormat(out, "\nAlineamiento número %d:\n", number);
+	PrintExplAlign(out, align);
+	if((align->EditTr) != NULL)//Armado junto con las cadenas (ver AllocExplAlign())
+	{
+		PrintEditTr(out, align->EditTr);
+		return;
+	}
+	char *edit_tr=EditTrFromExplAlign(align);
+	PrintEditTr(out, edit_tr);
+	free(edit_tr);
 }//___________________________________________________________
 
 
@@ -291,11 +782,19 @@ void FreeAligns(Align *alignments)
 {
 	int i;
 	for(i=0; (alignments[i].Align1)!=NULL; i++)
-	{
-		free(alignments[i].Align1);
-		free(alignments[i].Align2);
-	}
+		FreeExplAlign(&alignments[i]);
 	free(alignments);
 }//___________________________________________________________
 
+
+
+void FreeExplAlign(Align *align)
+/*
+ * Libera el bloque con Align1, Align2 y EditTr de un alineamiento alojado con AllocExplAlign() (pero no la estructura align).
+ */
+{
+	free(align->Align1);
+	(align->Align1)=NULL, (align->Align2)=NULL, (align->EditTr)=NULL;
+}//___________________________________________________________
+
 # endif
\ No newline at end of file
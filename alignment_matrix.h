@@ -5,31 +5,39 @@
 Librería: Matriz de Alineamiento.
 =================================
 
-Funciones especializadas para la estructura A_Matrix (y su subsidiaria Entry), que representa una matriz de alineamiento.
+Funciones especializadas para la estructura A_Matrix, que representa una matriz de alineamiento.
 Contiene funciones para crear, llenar, imprimir y destruir matrices de alineamiento.
 
 Esta librería utiliza las siguientes estructuras como base::
 
-		typedef struct Entry_struct
-		 // Estructura correspondiente a cada entrada de la matriz
-		{
-			float Value;
-			int N_Pointers;
-			char Pointers[3];
-
-		} Entry;
-		//___________________________________________________________
-
-
 		typedef struct A_Matrix_struct
 		// Estructura de la matriz de alineamiento, se compone de ambas secuencias de texto y las entradas de la matriz.
+		// Las entradas se guardan en dos bloques contiguos (fila por fila): los puntajes y las máscaras de punteros.
 		{
-			char *Str1;
-			char *Str2;
+			const char *Str1;//Las cadenas del llamador, no se copian (pueden estar en un archivo proyectado, ver LoadSeqFile())
+			const char *Str2;
 			char *Type;
 			char *AlignType;
 			float *Scores;
-			Entry **M;
+			int Rows;//Número de filas (longitud de Str2 + 1)
+			int Cols;//Número de columnas (longitud de Str1 + 1)
+			int ScoreType;//Tipo de los puntajes: SCORE_INT16 (short), SCORE_INT32 (int) o SCORE_FLOAT (float)
+			void *Values;//Puntajes del tipo ScoreType, la entrada (i,j) es Values[i*Stride + j + Shift] (leer con GetValue())
+			unsigned char *Pointers;//Punteros de traceback, la entrada (i,j) es Pointers[i*Stride + j + Shift], combinación de DIAG_BIT, VERT_BIT y HORI_BIT (o DEAD_BIT), leer con GetPointers()
+			const char *Engine;//Motor de llenado: NULL (automático), "scalar", "simd", "sse4.1" o "tiled"; después de FillAlignMatrix() es el nombre del motor usado ("banded" para las bandas, "striped-avx2" o "striped-sse4.1" para el local vectorial, "xdrop" para el X-drop)
+			int Threads;//Hilos para el llenado por bloques (0 para usar todos los procesadores)
+			double FillTime;//Segundos que tomó FillAlignMatrix()
+			int Band;//Semiancho K de la banda (sólo las entradas con BandLo<=j-i<=BandHi), -1 si se guarda la matriz completa
+			int BandLo, BandHi;//Primera y última diagonal j-i guardadas
+			int Stride, Shift;//Acomodo de las entradas: (i,j) está en la posición i*Stride + j + Shift (Cols y 0 para la matriz completa)
+			int BestRow, BestCol;//Entrada con el mejor puntaje de un alineamiento local o X-drop (la primera por columnas), desde donde empieza el traceback
+			float XDrop;//Umbral X: con similaridad, deja de calcular las entradas X por debajo del mejor puntaje (negativo para llenar toda la matriz)
+			double Skipped;//Entradas que el X-drop no calculó
+			const S_Matrix *Subst;//Matriz de sustitución para los apareamientos y reemplazos (NULL para usar M y R), no pertenece a la matriz
+			void *Profile;//Perfil de Str1 durante el llenado, del tipo ScoreType: la fila ProfileRow[c] tiene el puntaje de cada Str1[j-1] contra c (ver BuildProfile())
+			int *ProfileRow;//Fila del perfil de cada caracter de Str2 (256 entradas, -1 si no aparece)
+			int Packed;//Verdadero después de PackTraceback(): Pointers guarda dos entradas por byte (4 bits cada una) y Values ya se liberó
+			float EndScore;//Con los punteros empacados, el puntaje de la entrada desde donde empieza el traceback (el único que se conserva)
 
 		} A_Matrix;
 		//___________________________________________________________
@@ -40,6 +48,12 @@ Las siguientes son las funciones declaradas aquí:
 :A_Matrix *AllocAlignMatrix(const char *str1, const char *str2, const char *type, const char *aligntype, const float *scores):
 	Genera espacio para una matriz de alineamiento general con las cadenas de texto Str1 y Str2.
 
+:A_Matrix *AllocBandedAlignMatrix(const char *str1, const char *str2, const char *type, const char *aligntype, const float *scores, const int band):
+	Genera espacio sólo para las entradas de la matriz a distancia a lo más band de la diagonal principal (la matriz completa si band<0).
+
+:void SetMatrixBand(A_Matrix *AlignMatrix, const int band):
+	Vuelve a alojar las entradas de AlignMatrix (sin llenar) para la banda de semiancho band, o para la matriz completa si la banda la cubre.
+
 :float *getScores(const char *scoreStr):
 	Obtiene los costos de operación expresados en scoreStr.
 
@@ -47,7 +61,11 @@ Las siguientes son las funciones declaradas aquí:
 	LLena la entrada i,j de la matriz AlignMatrix utilizando la función Compare para seleccionar la entrada correcta
 
 :void FillAlignMatrix(A_Matrix *AlignMatrix):
-	LLena la matriz AlignMatrix con los valores y punteros correspondientes con ayuda de la función Score()
+	LLena la matriz AlignMatrix con los valores y punteros correspondientes con un núcleo escalar especializado (scalar_fill.h),
+	por bloques entre varios hilos (tiled_fill.h) si AlignMatrix->Threads lo permite,
+	o con un motor vectorial por antidiagonales (simd_fill.h) si el procesador lo soporta.
+	Las matrices por bandas se llenan con banded.h, duplicando la banda mientras el óptimo pueda estar fuera de ella.
+	Los alineamientos locales (AlignType "local") se llenan con los núcleos locales y el motor rayado de striped_fill.h.
 
 :void PrintAlignMatrixNoPointers(const A_Matrix *AlignMatrix):
 	Imprime sólo las entradas de la matriz de alineamiento AlignMatrix (sin punteros)
@@ -55,9 +73,53 @@ Las siguientes son las funciones declaradas aquí:
 :void PrintAlignMatrix(const A_Matrix *AlignMatrix):
 	Imprime la matriz de alineamiento AlignMatrix, incluyendo los punteros de traceback, estos son: \(diagonal) |(vertical) y _(horizontal)
 
+:void PrintFillStats(const A_Matrix *AlignMatrix):
+	Imprime el motor con el que se llenó AlignMatrix, el tiempo que tomó y su rendimiento en GCUPS.
+
+:void FindBestEntry(A_Matrix *AlignMatrix):
+	Coloca en AlignMatrix->BestRow y AlignMatrix->BestCol la entrada con el mejor puntaje (la primera por columnas), desde donde empieza el alineamiento local.
+
+:float GlobalScore(const char *str1, const char *str2, const char *type, const float *scores):
+	Calcula sólo el puntaje óptimo del alineamiento global de str1 y str2, sin punteros y con memoria O(min(m,n)).
+
 :void FreeAlignMatrix(A_Matrix *AlignMatrix):
 	Libera el espacio de una estructura a_matrix previamente alojada con AllocAlignMatrix().
 
+:int PointerCount(const unsigned char pointers):
+	Número de punteros en la máscara pointers.
+
+:char NthPointer(const unsigned char pointers, const int p):
+	El p-ésimo puntero de la máscara pointers, como caracter: \\(diagonal) |(vertical) y -(horizontal).
+	Los punteros se recorren siempre en el orden diagonal, vertical, horizontal.
+
+:int ChooseScoreType(const float *scores, const int len1, const int len2):
+	El tipo de puntaje más angosto (SCORE_INT16, SCORE_INT32 o SCORE_FLOAT) que no se desborda al alinear
+	cadenas de longitudes len1 y len2 con los costos scores. Si algún costo no es entero, SCORE_FLOAT.
+
+:size_t ScoreTypeSize(const int score_type):
+	Tamaño en bytes de un puntaje del tipo score_type.
+
+:const char *ScoreTypeName(const int score_type):
+	Nombre del tipo de puntaje score_type: "int16", "int32" o "float".
+
+:float GetValue(const A_Matrix *AlignMatrix, const int i, const int j):
+	El puntaje de la entrada (i,j) de AlignMatrix, sin importar su tipo.
+
+:void SetValue(A_Matrix *AlignMatrix, const int i, const int j, const float value):
+	Coloca el puntaje value en la entrada (i,j) de AlignMatrix, convertido a su tipo.
+
+:unsigned char GetPointers(const A_Matrix *AlignMatrix, const int i, const int j):
+	Los punteros de la entrada (i,j) de AlignMatrix, empacados o no (ver PackTraceback()).
+
+:void PackTraceback(A_Matrix *AlignMatrix, const int i, const int j):
+	Empaca los punteros de la matriz ya llena a 4 bits por entrada y libera los puntajes, salvo el de la entrada (i,j) donde empezará el traceback.
+
+:size_t EntryIndex(const A_Matrix *AlignMatrix, const int i, const int j):
+	Posición de la entrada (i,j) en AlignMatrix->Values y AlignMatrix->Pointers, tanto en la matriz completa como en una banda.
+
+:int InBand(const A_Matrix *AlignMatrix, const int i, const int j):
+	Verdadero si la entrada (i,j) existe y está guardada en AlignMatrix (siempre, para la matriz completa).
+
 
 Los prototipos de las funciones y las estructuras están declarados en el archivo alignments_headers.h
 
@@ -75,6 +137,9 @@ Los algoritmos están basados en los encontrados en el libro:
 # include <assert.h>//Para verificar errores con la función assert()
 # include <stdlib.h>//Para usar malloc(), calloc(), realloc(), free()
 # include <string.h>//Para usar strlen() y strcpy()
+# include <time.h>//Para usar clock_gettime()
+# include <math.h>//Para usar fabs()
+# include <limits.h>//Para usar SHRT_MAX e INT_MAX
 # include "alignments_headers.h"
 //Definiciones globales
 #define DEFAULT_TYPE "min"
@@ -92,15 +157,31 @@ A_Matrix *AllocAlignMatrix(const char *str1, const char *str2, const char *type,
 Aloja espacio para crear una matriz de  alineamiento o similaridad de los textos Str1 y Str2.
 Srt1 es representada en las columnas y Str2 en las filas.
 La matriz resultante tiene una estructura como la que se muestra:
-	matrix[i]={fila i},	donde i=0...m,
-	matrix[i][j]=elemento(i,j)
+	matrix->Values[i*Cols + j]=puntaje del elemento(i,j),	donde i=0...m, j=0...n
+	(del tipo más angosto que no se desborda, ver ChooseScoreType(), se lee con GetValue())
+	matrix->Pointers[i*Cols + j]=punteros del elemento(i,j)
+Ambos arreglos son un solo bloque contiguo, recorrido fila por fila.
 	matrix->Str1=Cadena de texto a transformar.
 	matrix->Str2=Cadena de texto objetivo.
+Las cadenas no se copian: la matriz apunta a str1 y str2, que deben existir hasta FreeAlignMatrix().
 	matrix->Scores=[M, R, I, D] (arreglo con los costos de operación usados para llenar la matriz
 Devuelve un puntero a una estructura de matriz.
  */
 {
-	int i,j;
+	return AllocBandedAlignMatrix(str1, str2, type, aligntype, scores, -1);//La matriz completa
+}//___________________________________________________________
+
+
+
+A_Matrix *AllocBandedAlignMatrix(const char *str1, const char *str2, const char *type, const char *aligntype, const float *scores, const int band)
+/*
+Igual que AllocAlignMatrix(), pero si band>=0 sólo aloja las entradas (i,j) de la banda alrededor de la diagonal principal,
+es decir, con min(0,n-m)-band <= j-i <= max(0,n-m)+band (la banda siempre contiene a las entradas (0,0) y (m,n)).
+Cada fila guarda las BandHi-BandLo+1 diagonales de la banda, la entrada (i,j) está en Values[i*Stride + j + Shift] (ver EntryIndex()).
+Si la banda cubre toda la matriz se aloja la matriz completa (Band=-1).
+ */
+{
+	int i;
 	int rows=strlen(str2)+1, cols=strlen(str1)+1;//Inicializa para crear la matriz
 
 	//Crea la estructura donde se aloja la matriz_____________________________
@@ -108,10 +189,8 @@ Devuelve un puntero a una estructura de matriz.
 	assert(A != NULL);
 
 	//Define las cadenas a alinear____________________________________________
-	(A->Str1) = strdup(str1);//Almacena las cadenas en la estructura
-	assert((A->Str1) != NULL);
-	(A->Str2) = strdup(str2);
-	assert((A->Str2) != NULL);
+	(A->Str1) = str1;//Apunta a las cadenas sin copiarlas: pueden ser registros de varios GB de un archivo proyectado
+	(A->Str2) = str2;
 
 	//Define el tipo de matriz_________________________________________________
 	if(type==NULL)
@@ -140,22 +219,63 @@ Devuelve un puntero a una estructura de matriz.
 	}
 
 	//Genera las entradas de la matriz________________________________________
-	Entry **M=(Entry **) malloc(rows * sizeof(Entry *));//Genera el espacio para la matriz, en específico para los punteros a las filas
-	for(i=0; i<rows; i++)
-	{
-		M[i]=(Entry *) malloc(cols * sizeof(Entry));//Genera espacio para las filas, M[i] es una fila
-		for(j=0; j<cols; j++)
-		{
-			M[i][j].N_Pointers = 0;//Inicializa el número de punteros como nulo
-		}
-	}
-	(A->M)=M;
+	(A->Rows) = rows, (A->Cols) = cols;
+	(A->ScoreType) = ChooseScoreType(A->Scores, cols-1, rows-1);//Puntajes enteros de 16 o 32 bits si no se desbordan
+	(A->Values) = NULL, (A->Pointers) = NULL;
+	SetMatrixBand(A, band);//Aloja las entradas de la banda (o de la matriz completa)
+	(A->Engine) = NULL;//El motor de llenado se elige automáticamente
+	(A->Threads) = 1;//Por defecto se llena en el hilo actual
+	(A->FillTime) = 0;
+	(A->BestRow) = 0, (A->BestCol) = 0;//Sin alineamiento local hasta llenar la matriz
+	(A->XDrop) = -1, (A->Skipped) = 0;//Por defecto se calcula toda la matriz
+	(A->Subst) = NULL;//Apareamientos y reemplazos con M y R (ver SetSubstMatrix())
+	(A->Profile) = NULL, (A->ProfileRow) = NULL;//El perfil sólo existe durante el llenado
+	(A->Packed) = 0, (A->EndScore) = 0;//Un byte de punteros por entrada hasta PackTraceback()
 
 	return A;
 }//___________________________________________________________
 
 
 
+void SetMatrixBand(A_Matrix *AlignMatrix, const int band)
+/*
+ * Libera las entradas de AlignMatrix y aloja otras para la banda de semiancho band (la matriz completa si band<0 o si la banda la cubre).
+ * Los puntajes quedan sin inicializar y las entradas sin punteros, la matriz se debe volver a llenar.
+ */
+{
+	int rows=(AlignMatrix->Rows), cols=(AlignMatrix->Cols);
+	int diff=cols-rows;//Diagonal j-i de la última entrada
+	size_t width;//Entradas guardadas por fila
+	free(AlignMatrix->Values);
+	free(AlignMatrix->Pointers);
+	if(band < 0 || ((diff < 0 ? diff : 0) - band <= -(rows-1) && (diff > 0 ? diff : 0) + band >= cols-1))
+	{
+		//Matriz completa, fila por fila
+		(AlignMatrix->Band) = -1;
+		(AlignMatrix->BandLo) = -(rows-1), (AlignMatrix->BandHi) = cols-1;
+		(AlignMatrix->Stride) = cols, (AlignMatrix->Shift) = 0;
+		width=cols;
+	}
+	else
+	{
+		//Sólo las diagonales BandLo...BandHi, la diagonal BandLo es la primera entrada de cada fila
+		(AlignMatrix->Band) = band;
+		(AlignMatrix->BandLo) = (diff < 0 ? diff : 0) - band, (AlignMatrix->BandHi) = (diff > 0 ? diff : 0) + band;
+		if((AlignMatrix->BandLo) < -(rows-1))
+			(AlignMatrix->BandLo) = -(rows-1);
+		if((AlignMatrix->BandHi) > cols-1)
+			(AlignMatrix->BandHi) = cols-1;
+		width=(AlignMatrix->BandHi) - (AlignMatrix->BandLo) + 1;
+		(AlignMatrix->Stride) = width-1, (AlignMatrix->Shift) = -(AlignMatrix->BandLo);//i*(width-1) + j - BandLo = i*width + (j-i-BandLo)
+	}
+	(AlignMatrix->Values) = malloc((size_t)rows * width * ScoreTypeSize(AlignMatrix->ScoreType));//Un solo bloque para todos los puntajes
+	assert((AlignMatrix->Values) != NULL);
+	(AlignMatrix->Pointers) = (unsigned char *) calloc((size_t)rows * width, sizeof(unsigned char));//Inicializa todas las entradas sin punteros
+	assert((AlignMatrix->Pointers) != NULL);
+}//___________________________________________________________
+
+
+
 float *getScores(const char *scoreStr)
 /*Obtiene un arreglo con los costos de operación con el formato: [ M, R, I, D] (Match, Replacement, Insertion, Deletion).
  * Recibe una string donde se especifican pares operación costo, por ejemplo, si se requiere que M=1, I=-1, R=0,
@@ -225,9 +345,9 @@ void PrintAlignMatrixNoPointers(const A_Matrix *AlignMatrix)
 #define TYPE	(AlignMatrix->Type)
 #define ALIGN_TYPE	(AlignMatrix->AlignType)
 #define SCORES	(AlignMatrix->Scores)
-#define VALUE(i,j)	(AlignMatrix->M)[i][j].Value
+#define VALUE(i,j)	GetValue(AlignMatrix, i, j)
 
-	int rows=(strlen(STR2)+1), cols=(strlen(STR1)+1);//Recupera el tamaño de la matriz
+	int rows=(AlignMatrix->Rows), cols=(AlignMatrix->Cols);//Recupera el tamaño de la matriz
 	int i,j;
 
 	//Imprime los costos, el tipo de matriz y las secuencias asociadas
@@ -252,7 +372,10 @@ void PrintAlignMatrixNoPointers(const A_Matrix *AlignMatrix)
 		printf("\t%c", (i==0 ? ' ':STR2[i-1]));//Imprime la cadena de texto asociada a las filas.
 		for(j=0; j<cols; j++)//Lee el j-ésimo elemento de la i-ésima fila.
 		{
-			printf("\t%f", VALUE(i,j));//Imprime la entrada i,j de la matriz
+			if(InBand(AlignMatrix, i, j) && !(GetPointers(AlignMatrix, i, j) & DEAD_BIT))
+				printf("\t%f", VALUE(i,j));//Imprime la entrada i,j de la matriz
+			else
+				printf("\t");//Fuera de la banda o descartada por el X-drop
 		}
 		printf("\n");
 	}
@@ -274,15 +397,12 @@ void PrintAlignMatrix(const A_Matrix *AlignMatrix)
 #define TYPE	(AlignMatrix->Type)
 #define ALIGN_TYPE	(AlignMatrix->AlignType)
 #define SCORES	(AlignMatrix->Scores)
-#define MATRIX (AlignMatrix->M)
-#define VALUE(i,j) MATRIX[i][j].Value
-#define N_POINTERS MATRIX[i][j].N_Pointers
-#define POINTER(p) MATRIX[i][j].Pointers[p]
-#define DIAG '\\'
-#define VERT '|'
-#define HORI '-'
-
-	int rows=(strlen(STR2)+1), cols=(strlen(STR1)+1);//Recupera el tamaño de la matriz
+#define VALUE(i,j) GetValue(AlignMatrix, i, j)
+#define POINTERS GetPointers(AlignMatrix, i, j)
+#define N_POINTERS PointerCount(POINTERS)
+#define POINTER(p) NthPointer(POINTERS, p)
+
+	int rows=(AlignMatrix->Rows), cols=(AlignMatrix->Cols);//Recupera el tamaño de la matriz
 	int i,j,p;
 
 	//Imprime los costos, el tipo de matriz y las secuencias asociadas
@@ -307,17 +427,14 @@ void PrintAlignMatrix(const A_Matrix *AlignMatrix)
 		printf("\t%c\t", (i==0 ? ' ':STR2[i-1]));//Imprime la cadena de texto asociada a las filas.
 		for(j=0; j<cols; j++)//Lee el j-ésimo elemento de la i-ésima fila.
 		{
+			if(!InBand(AlignMatrix, i, j) || (POINTERS & DEAD_BIT))
+			{
+				printf("\t");//Fuera de la banda o descartada por el X-drop
+				continue;
+			}
 			printf("%d(", (int)VALUE(i,j));
 			for(p=0; p<N_POINTERS; p++)
-			{
 				printf("%c", POINTER(p));
-// 				if(POINTER(p)==DIAG)
-// 					printf("\\");
-// 				if(POINTER(p)==VERT)
-// 					printf("|");
-// 				if(POINTER(p)==HORI)
-// 					printf("-");
-			}
 			printf(")\t");
 		}
 		printf("\n\n\n");
@@ -327,113 +444,90 @@ void PrintAlignMatrix(const A_Matrix *AlignMatrix)
 #undef TYPE
 #undef ALIGN_TYPE
 #undef SCORES
-#undef MATRIX
 #undef VALUE
+#undef POINTERS
 #undef N_POINTERS
 #undef POINTER
-#undef DIAG
-#undef VERT
-#undef HORI
 }//___________________________________________________________
 
 
 
 void Score(A_Matrix *Al, const int i, const int j, float (*Compare)(const float *numbers, const int size))
-/*Llena el elemento i,j de la matriz de alineamiento Al. (Al->M)[i][j]=MATRIX[i][j] contiene el puntaje y los punteros.
-La entrada MATRIX[i][j][0]=ENTRY(i,j) Contiene el puntaje de alineamiento entre Str1[i] y Str2[j], el puntaje se calcula según el esquema contenido en Al->Scores como sigue:
+/*Llena el elemento i,j de la matriz de alineamiento Al. VALUE(i,j) contiene el puntaje (del tipo Al->ScoreType) y POINTERS(i,j) los punteros.
+La entrada VALUE(i,j) Contiene el puntaje de alineamiento entre Str1[i] y Str2[j], el puntaje se calcula según el esquema contenido en Al->Scores como sigue:
 	M=(Al->Scores)[0] es el puntaje por emparejar,
-	R=(Al->Scores)[1] es el puntaje por reemplazo,
+	R=(Al->Scores)[1] es el puntaje por reemplazo (si Al->Subst no es NULL, ambos se toman de la matriz de sustitución, ver PairScore()),
 	I=(Al->Scores)[2] es el puntaje por insertar letras,
 	D=(Al->Scores)[3] es el puntaje por eliminar letras.
-La entrada MATRIX[i][j].N_Pointers Contiene el número de punteros desde esa entrada
-La entrada MATRIX[i][j].Pointers[p] Contiene el p-ésimo puntero, la codificación de los punteros es la siguiente:
-	0=DIAG Es un puntero diagonal, 1=VERT Es un puntero vertical, 2=HORI Es un puntero horizontal.
+La entrada POINTERS(i,j) Contiene los punteros desde esa entrada como máscara de bits:
+	DIAG_BIT Es un puntero diagonal, VERT_BIT Es un puntero vertical, HORI_BIT Es un puntero horizontal.
 La función Compare() que se pasa como argumento es Min() o Max() dependiendo del tipo de matriz (similaridad o distancia)
+En una matriz por bandas sólo se consideran los vecinos guardados en la banda (la entrada diagonal siempre lo está).
+En un alineamiento local (AlignType "local") las orillas valen 0 y un puntaje que no es positivo se reemplaza por 0 sin punteros:
+ahí empieza el alineamiento local (Smith-Waterman), el traceback se detiene en esa entrada.
 */
 {
 #define STR1 (Al->Str1)
 #define STR2 (Al->Str2)
-#define MATRIX (Al->M)
-#define N_POINTERS MATRIX[i][j].N_Pointers
-#define VALUE(i,j) MATRIX[i][j].Value
-#define POINTER(p) MATRIX[i][j].Pointers[p]
-#define DIAGP '\\'
-#define VERTP '|'
-#define HORIP '-'
-#define DIAG 0
-#define VERT 1
-#define HORI 2
-#define MM (Al->Scores)[0]
-#define R (Al->Scores)[1]
+#define VALUE(i,j) GetValue(Al, i, j)
+#define POINTERS(i,j) (Al->Pointers)[EntryIndex(Al, i, j)]
 #define I (Al->Scores)[2]
 #define D (Al->Scores)[3]
 	//Inicializa
-	N_POINTERS=0;//Número de punteros inicial nulo.
+	unsigned char pointers=0;//Sin punteros inicialmente.
+	int local=equStr(Al->AlignType, "local");//Alineamiento local: los puntajes no bajan de 0
 
 
 	if(i==0 || j==0)//Si está a la orilla
 	{
 		//.................................................
 		//------------------------------------------------Condiciones base Score(0,j)=j*D, Score(i,0)=i*I.
-		VALUE(i,j)=(i==0 ? j*D:i*I);//Coloca en la distancia inicial(condición base)
+		SetValue(Al, i, j, (local ? 0 : (i==0 ? j*D:i*I)));//Coloca en la distancia inicial(condición base), 0 en el local
 		//Coloca el puntero correcto
-		if(i!=0)
-		{
-			POINTER(N_POINTERS)=VERTP;//Coloca el puntero vertical
-			N_POINTERS++;//Incrementa la cuenta de punteros
-		}
-		else if(j!=0)//Coloca el puntero correcto
-		{
-			POINTER(N_POINTERS)=HORIP;//Coloca el puntero hacia la entrada horizontal
-			N_POINTERS++;//Incrementa la cuenta de punteros
-		}
+		if(local)
+			pointers=0;//Un alineamiento local puede empezar en cualquier orilla
+		else if(i!=0)
+			pointers|=VERT_BIT;//Coloca el puntero vertical
+		else if(j!=0)
+			pointers|=HORI_BIT;//Coloca el puntero hacia la entrada horizontal
 	}
 	else//Si no, calcula el valor de la relación de recurrencia
 	{
 		//..................................................................
 		//------------------------------------------------------------------Relación de recurrencia
 		float pos_dist[3];//Inicializa arreglo de los posibles valores del score
-		//Calcula los posibles puntajes
-		if(STR1[j-1]!=STR2[i-1])//Calcula el valor de un posible apareamiento o reemplazo
-			pos_dist[DIAG]=(VALUE(i-1,j-1) + R);
-		else
-			pos_dist[DIAG]=(VALUE(i-1, j-1) + MM);
-		pos_dist[VERT]=(VALUE(i-1, j) + I);//Calcula el valor de una posible inserción
-		pos_dist[HORI]=(VALUE(i, j-1) + D);//Calcula el valor de una posible deleción
-
-		//Finalmente, calcula la verdadera distancia y coloca los punteros adecuados
-		VALUE(i,j)=Compare(pos_dist, 3);//Coloca el valor de la distancia en la matriz
-		//Coloca los punteros
-		if(pos_dist[DIAG]==VALUE(i,j))//Si la distancia fue dada por la entrada diagonal
-		{
-			POINTER(N_POINTERS)=DIAGP;//Coloca el puntero diagonal
-			N_POINTERS++;//Incrementa la cuenta de punteros
-		}
-		if(pos_dist[VERT]==VALUE(i,j))//Si la distancia provino de la vertical
+		unsigned char pos_bits[3];//El puntero correspondiente a cada posible valor
+		int n=0, k;
+		//Calcula los posibles puntajes, en el orden diagonal, vertical, horizontal
+		pos_dist[n]=(VALUE(i-1,j-1) + PairScore(Al, STR1[j-1], STR2[i-1]));//Calcula el valor de un posible apareamiento o reemplazo
+		pos_bits[n++]=DIAG_BIT;
+		if(InBand(Al, i-1, j))
 		{
-			POINTER(N_POINTERS)=VERTP;//Coloca el puntero vertical
-			N_POINTERS++;//Incrementa la cuenta de punteros
+			pos_dist[n]=(VALUE(i-1, j) + I);//Calcula el valor de una posible inserción
+			pos_bits[n++]=VERT_BIT;
 		}
-		if(pos_dist[HORI]==VALUE(i,j))//Si la distancia provino de la entrada horizontal
+		if(InBand(Al, i, j-1))
 		{
-			POINTER(N_POINTERS)=HORIP;//Coloca el puntero hacia la entrada horizontal
-			N_POINTERS++;//Incrementa la cuenta de punteros
+			pos_dist[n]=(VALUE(i, j-1) + D);//Calcula el valor de una posible deleción
+			pos_bits[n++]=HORI_BIT;
 		}
+
+		//Finalmente, calcula la verdadera distancia y coloca los punteros adecuados
+		float best=Compare(pos_dist, n);
+		int start=(local && best <= 0);//El alineamiento local empieza aquí (puntaje 0, sin punteros)
+		if(start)
+			best=0;
+		SetValue(Al, i, j, best);//Coloca el valor de la distancia en la matriz
+		//Coloca los punteros, con puntajes enteros las comparaciones son exactas
+		for(k=0; k<n && !start; k++)
+			if(pos_dist[k]==best)//Si la distancia provino de este vecino
+				pointers|=pos_bits[k];//Coloca su puntero
 	}
+	POINTERS(i,j)=pointers;//Guarda los punteros de la entrada
 #undef STR1
 #undef STR2
-#undef MATRIX
-#undef N_POINTERS
 #undef VALUE
-#undef POINTER
-#undef DIAG
-#undef VERT
-#undef HORI
-#undef DIAGP
-#undef VERTP
-#undef HORIP
-#undef MM
-#undef R
+#undef POINTERS
 #undef I
 #undef D
 }//___________________________________________________________
@@ -442,13 +536,28 @@ La función Compare() que se pasa como argumento es Min() o Max() dependiendo de
 
 void FillAlignMatrix(A_Matrix *AlignMatrix)
 /*Llena la matriz de de alineamiento A con las los puntajes obtenidos con la función Score
-*La llena una fila a la vez.
+*Las orillas se llenan con Score(), el interior por bloques entre AlignMatrix->Threads hilos (ver tiled_fill.h) si la matriz es grande,
+*si no, con un motor vectorial por antidiagonales (ver simd_fill.h) si el procesador lo soporta, o si no, una fila a la vez.
+*El objetivo (mínimo o máximo) y el tipo de puntaje se resuelven aquí una sola vez: los motores usan núcleos especializados
+*al compilar (ver scalar_fill.h) en lugar de llamar a Score() por cada entrada. Todos los motores dan los mismos puntajes y punteros.
+*AlignMatrix->Engine permite forzar el motor ("scalar", "simd", "sse4.1" o "tiled"), al terminar contiene el nombre del motor usado.
+*Si AlignMatrix es una matriz por bandas (ver AllocBandedAlignMatrix()) se llena sólo la banda (ver banded.h); mientras el óptimo
+*pueda estar fuera de ella, se duplica la banda y se vuelve a llenar (con los motores de arriba si llega a cubrir la matriz completa).
+*Si AlignMatrix->AlignType es "local" (Smith-Waterman, siempre de similaridad) se llena la matriz completa con los núcleos locales:
+*el vectorial rayado de Farrar (ver striped_fill.h) en lugar del de antidiagonales, y al final AlignMatrix->BestRow y BestCol
+*indican la entrada con el mejor puntaje (ver FindBestEntry()).
+*Si AlignMatrix->XDrop no es negativo y la matriz es de similaridad, se llena con la terminación X-drop (ver xdrop.h): sólo las
+*entradas que no caen XDrop por debajo del mejor puntaje, AlignMatrix->BestRow y BestCol indican el final de la mejor extensión.
+*Los núcleos leen los puntajes de apareamiento y reemplazo del perfil de Str1 (ver BuildProfile()), calculado aquí una sola vez
+*con M y R o con la matriz de sustitución AlignMatrix->Subst; el motor por antidiagonales sólo se usa sin matriz de sustitución.
 */
 {
 #define STR1 (AlignMatrix->Str1)
 #define STR2 (AlignMatrix->Str2)
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);//Mide el tiempo de llenado
 	//Recupera el tamaño de la matriz
-	int rows=(strlen(STR2)+1), cols=(strlen(STR1)+1);
+	int rows=(AlignMatrix->Rows), cols=(AlignMatrix->Cols);
 	//Recupera el tipo de matriz, si de distancia (mínimo puntaje) o de similaridad (máximo puntaje)
 	float (*Compare)(const float *numbers, const int size);//Puntero a función que seleccionará si se calcula el mínimo o máximo de los puntajes
 	//Dependiendo del tipo de matriz(distancia o similaridad) elije la función para comparar
@@ -465,47 +574,381 @@ void FillAlignMatrix(A_Matrix *AlignMatrix)
 		printf("\nADVERTENCIA: Función de comparación no es ni min o max \"%s\" al obtener costos, se ha colocado la opción por defecto \"%s\"\n", (AlignMatrix->Type), DEFAULT_TYPE);
 		Compare= (equStr(DEFAULT_TYPE, "min") ? Min : Max);//Si no es min o max, asigna la opción por default.
 	}
+	int local=equStr(AlignMatrix->AlignType, "local");
+	int xdrop=(!local && (AlignMatrix->XDrop) >= 0);
+	if(xdrop && Compare != Max)
+	{
+		printf("\nADVERTENCIA: El X-drop sólo se usa con matrices de similaridad (max), se ha llenado toda la matriz\n");
+		xdrop=0;
+	}
+	if(xdrop && (AlignMatrix->Band) >= 0)
+		SetMatrixBand(AlignMatrix, -1);//El X-drop decide qué entradas calcular
+	if(local)
+	{
+		Compare=Max;//El alineamiento local sólo tiene sentido con similaridad
+		if((AlignMatrix->Band) >= 0)
+			SetMatrixBand(AlignMatrix, -1);//El alineamiento local puede estar en cualquier parte de la matriz
+	}
 
 	int i,j;
-	//Primero coloca los elementos correspondientes a las condiciones base, i.e, con i=0 o j=0
-	for(i=0; i<rows; i++)//En la primera columna
-		Score(AlignMatrix, i, 0, Compare);
-	for(j=0; j<cols; j++)//Llena la primera fila
-		Score(AlignMatrix, 0, j, Compare);
-	//Llena los demás elementos
-	for(i=1; i<rows; i++)//Fila por fila
+	BuildProfile(AlignMatrix);//Los puntajes diagonales de los núcleos, una sola vez por matriz
+	FillBlockKernel fill=(local ? ChooseLocalFillBlock(AlignMatrix->ScoreType)//Núcleo escalar especializado, elegido una sola vez
+		: ChooseFillBlock(AlignMatrix->ScoreType, Compare == Max));
+	//Si es una matriz por bandas, llena la banda y duplícala hasta que contenga al óptimo
+	while((AlignMatrix->Band) >= 0)
 	{
-		for(j=1; j<cols; j++)//Coloca el j-ésimo elemento de la i-ésima fila.
+		FillAlignMatrixBanded(AlignMatrix, fill, Compare);
+		if(BandHoldsOptimum(AlignMatrix, Compare == Max))
+			break;
+		SetMatrixBand(AlignMatrix, ((AlignMatrix->Band) == 0 ? 1 : 2*(AlignMatrix->Band)));//Puede cubrir ya la matriz completa (Band=-1)
+	}
+	if(xdrop)
+		FillAlignMatrixXDrop(AlignMatrix);//Incluidas las orillas, siempre sin banda
+	else if((AlignMatrix->Band) < 0)
+	{
+		//Primero coloca los elementos correspondientes a las condiciones base, i.e, con i=0 o j=0
+		for(i=0; i<rows; i++)//En la primera columna
+			Score(AlignMatrix, i, 0, Compare);
+		for(j=0; j<cols; j++)//Llena la primera fila
+			Score(AlignMatrix, 0, j, Compare);
+		//Llena los demás elementos, por bloques entre varios hilos o con el motor vectorial si se puede
+		int scalar=((AlignMatrix->Engine) != NULL && equStr(AlignMatrix->Engine, "scalar"));
+		int simd=((AlignMatrix->Engine) != NULL && (equStr(AlignMatrix->Engine, "simd") || equStr(AlignMatrix->Engine, "sse4.1")));
+		int striped=0;//El núcleo local rayado encuentra la mejor entrada al llenar
+		if( scalar
+			|| !( (!simd && FillAlignMatrixTiled(AlignMatrix, fill))
+				|| (local ? (striped=FillAlignMatrixStriped(AlignMatrix)) : FillAlignMatrixSIMD(AlignMatrix, Compare == Max)) ) )
 		{
-			Score(AlignMatrix, i, j, Compare);
+			fill(AlignMatrix, 1, rows, 1, cols);//Todo el interior, fila por fila
+			(AlignMatrix->Engine)="scalar";
 		}
+		if(local && !striped)
+			FindBestEntry(AlignMatrix);
 	}
+	else
+		(AlignMatrix->Engine)="banded";
+
+	FreeProfile(AlignMatrix);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	(AlignMatrix->FillTime)=(end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec)*1e-9;
 #undef STR1
 #undef STR2
 }//___________________________________________________________
 
 
 
-void FreeAlignMatrix(A_Matrix *AlignMatrix)
+void PrintFillStats(const A_Matrix *AlignMatrix)
 /*
- * Libera el espacio de una estructura a_matrix previamente alojada con AllocAlignMatrix()
+ * Imprime el motor con el que se llenó AlignMatrix, el tipo de sus puntajes, el tiempo que tomó y su rendimiento
+ * en GCUPS (miles de millones de entradas de la matriz por segundo). Con el X-drop sólo cuentan las entradas calculadas.
  */
 {
+	double cells=0;
+	int i;
+	for(i=0; i<(AlignMatrix->Rows); i++)//Entradas guardadas en cada fila (todas, si la matriz es completa)
+		cells+=MIN((AlignMatrix->Cols)-1, i+(AlignMatrix->BandHi)) - MAX(0, i+(AlignMatrix->BandLo)) + 1;
+	cells-=(AlignMatrix->Skipped);//Las que el X-drop no calculó
+	printf("Motor:\t%s\n", (AlignMatrix->Engine) == NULL ? "ninguno" : (AlignMatrix->Engine));
+	if((AlignMatrix->Band) >= 0)
+		printf("Banda:\t%d\n", (AlignMatrix->Band));
+	printf("Tipo:\t%s\n", ScoreTypeName(AlignMatrix->ScoreType));
+	printf("Celdas:\t%.0f\n", cells);
+	printf("Tiempo:\t%f s\n", (AlignMatrix->FillTime));
+	printf("GCUPS:\t%f\n", ((AlignMatrix->FillTime) > 0 ? cells / (AlignMatrix->FillTime) * 1e-9 : 0.0));
+}//___________________________________________________________
+
+
 
-	int i, rows=(strlen(AlignMatrix->Str2)+1);
+void FindBestEntry(A_Matrix *AlignMatrix)
+/*
+ * Coloca en AlignMatrix->BestRow y BestCol la entrada con el mejor (máximo) puntaje de la matriz llena, la primera recorriendo
+ * la matriz columna por columna (la de menor j y, con la misma j, la de menor i), igual que el núcleo rayado de striped_fill.h.
+ * Se recorre fila por fila (en el orden en que está guardada) y los empates se resuelven con esa regla.
+ */
+{
+	int rows=(AlignMatrix->Rows), cols=(AlignMatrix->Cols);
+	int i, j, best_i=0, best_j=0;
+	float best=GetValue(AlignMatrix, 0, 0), value;
 	for(i=0; i<rows; i++)
+		for(j=0; j<cols; j++)
+		{
+			value=GetValue(AlignMatrix, i, j);
+			if(value > best || (value == best && j < best_j))//Las filas se recorren en orden, un empate en la misma columna ya es peor
+				best=value, best_i=i, best_j=j;
+		}
+	(AlignMatrix->BestRow)=best_i, (AlignMatrix->BestCol)=best_j;
+}//___________________________________________________________
+
+
+
+float GlobalScore(const char *str1, const char *str2, const char *type, const float *scores)
+/*
+ * Calcula únicamente el puntaje óptimo del alineamiento global de str1 y str2, sin construir la matriz de alineamiento ni sus punteros.
+ * Conserva sólo una fila de la matriz (más la entrada diagonal anterior), por lo que usa memoria O(min(m,n)).
+ * Si str1 es más larga que str2 se recorre la matriz transpuesta, intercambiando los costos de inserción y deleción.
+ * El valor obtenido es idéntico al de la entrada final de la matriz llenada con FillAlignMatrix().
+ * Con costos unitarios y matriz de distancia usa el algoritmo de vectores de bits de Myers, 64 entradas por operación.
+ */
+{
+	const float default_scores[4]={0, 1, 1, 1};//Los costos por default, igual que en AllocAlignMatrix()
+	if(scores == NULL)
+		scores=default_scores;
+	int maximize=(type != NULL && equStr(type, "max"));//Por default, matriz de distancia (mínimo)
+	if(UnitCostScores((type == NULL ? "min" : type), scores))
+		return scores[1] * MyersDistance(str1, str2);//Distancia de Levenshtein por vectores de bits (ver myers.h)
+
+	//Elige la cadena más corta para las columnas (la fila que se conserva)
+	const char *cols_str=str1, *rows_str=str2;
+	float hori=scores[3], vert=scores[2];//Costo horizontal (deleción) y vertical (inserción)
+	if(strlen(str1) > strlen(str2))
 	{
-		free((AlignMatrix->M)[i]);
+		cols_str=str2, rows_str=str1;//Recorre la matriz transpuesta
+		hori=scores[2], vert=scores[3];
+	}
+	int rows=strlen(rows_str)+1, cols=strlen(cols_str)+1;
+	float match=scores[0], repl=scores[1];
+
+	float *row=(float *) malloc(cols * sizeof(float));//La única fila de la matriz
+	assert(row != NULL);
+	float diag, up, best;
+	int i, j;
+	for(j=0; j<cols; j++)//Condición base de la primera fila
+		row[j]=j*hori;
+#define FILL_ROWS(BEST)\
+	for(i=1; i<rows; i++)\
+	{\
+		diag=row[0];\
+		row[0]=i*vert;/*Condición base de la primera columna*/\
+		for(j=1; j<cols; j++)\
+		{\
+			up=row[j];\
+			best=diag + (cols_str[j-1]!=rows_str[i-1] ? repl : match);\
+			best=BEST(best, up + vert);\
+			best=BEST(best, row[j-1] + hori);\
+			diag=up;\
+			row[j]=best;\
+		}\
 	}
-	free(AlignMatrix->M);
-	free(AlignMatrix->Str1);
-	free(AlignMatrix->Str2);
+	if(maximize)
+		FILL_ROWS(MAX)
+	else
+		FILL_ROWS(MIN)
+#undef FILL_ROWS
+
+	best=row[cols-1];
+	free(row);
+	return best;
+}//___________________________________________________________
+
+
+
+void FreeAlignMatrix(A_Matrix *AlignMatrix)
+/*
+ * Libera el espacio de una estructura a_matrix previamente alojada con AllocAlignMatrix(), pero no sus cadenas (no le pertenecen)
+ */
+{
+	free(AlignMatrix->Values);
+	free(AlignMatrix->Pointers);
 	free(AlignMatrix->Scores);
 	free(AlignMatrix->Type);
 	free(AlignMatrix->AlignType);
+	FreeProfile(AlignMatrix);
 	free(AlignMatrix);
 }//___________________________________________________________
+
+
+
+int PointerCount(const unsigned char pointers)
+// Devuelve el número de punteros contenidos en la máscara pointers.
+{
+	return ((pointers & DIAG_BIT) != 0) + ((pointers & VERT_BIT) != 0) + ((pointers & HORI_BIT) != 0);
+}//___________________________________________________________
+
+
+
+char NthPointer(const unsigned char pointers, const int p)
+/*
+ * Devuelve el p-ésimo puntero de la máscara pointers, como caracter: '\\'(diagonal), '|'(vertical) o '-'(horizontal).
+ * Los punteros se cuentan en el orden diagonal, vertical, horizontal. Si no existe el p-ésimo puntero devuelve '\0'.
+ */
+{
+	const unsigned char bits[3]={DIAG_BIT, VERT_BIT, HORI_BIT};
+	const char chars[3]={'\\', '|', '-'};
+	int b, n;
+	for(b=0, n=0; b<3; b++)
+	{
+		if(pointers & bits[b])
+		{
+			if(n == p)
+				return chars[b];
+			n++;
+		}
+	}
+	return '\0';
+}//___________________________________________________________
+
+
+
+int ChooseScoreType(const float *scores, const int len1, const int len2)
+/*
+ * Elige el tipo de puntaje más angosto para alinear cadenas de longitudes len1 y len2 con los costos scores=[M, R, I, D].
+ * Cualquier entrada (i,j) de la matriz, y cualquier candidato de la relación de recurrencia, es la suma de a lo más len1+len2 costos,
+ * por lo que su valor absoluto está acotado por (len1+len2)*max|costo|. Si la cota cabe en 16 bits usa SCORE_INT16, si cabe en 32 bits SCORE_INT32.
+ * Si algún costo no es entero (o la cota no cabe en 32 bits) usa SCORE_FLOAT.
+ */
+{
+	int k;
+	double max_cost=0;
+	for(k=0; k<4; k++)
+	{
+		if(scores[k] != (float)(long)scores[k])//Costo no entero
+			return SCORE_FLOAT;
+		if(fabs(scores[k]) > max_cost)
+			max_cost=fabs(scores[k]);
+	}
+	double bound=((double)len1 + len2 + 1) * max_cost;//Un costo más, por los candidatos de la última entrada
+	if(bound <= SHRT_MAX)
+		return SCORE_INT16;
+	if(bound <= INT_MAX)
+		return SCORE_INT32;
+	return SCORE_FLOAT;
+}//___________________________________________________________
+
+
+
+size_t ScoreTypeSize(const int score_type)
+/*
+ * Tamaño en bytes de un puntaje del tipo score_type.
+ */
+{
+	switch(score_type)
+	{
+		case SCORE_INT16:
+			return sizeof(short);
+		case SCORE_INT32:
+			return sizeof(int);
+		default:
+			return sizeof(float);
+	}
+}//___________________________________________________________
+
+
+
+const char *ScoreTypeName(const int score_type)
+/*
+ * Nombre del tipo de puntaje score_type.
+ */
+{
+	switch(score_type)
+	{
+		case SCORE_INT16:
+			return "int16";
+		case SCORE_INT32:
+			return "int32";
+		default:
+			return "float";
+	}
+}//___________________________________________________________
+
+
+
+float GetValue(const A_Matrix *AlignMatrix, const int i, const int j)
+/*
+ * El puntaje de la entrada (i,j) de AlignMatrix, convertido a float (es exacto para los puntajes enteros elegidos por ChooseScoreType()).
+ */
+{
+	size_t k=EntryIndex(AlignMatrix, i, j);
+	switch(AlignMatrix->ScoreType)
+	{
+		case SCORE_INT16:
+			return ((short *)(AlignMatrix->Values))[k];
+		case SCORE_INT32:
+			return ((int *)(AlignMatrix->Values))[k];
+		default:
+			return ((float *)(AlignMatrix->Values))[k];
+	}
+}//___________________________________________________________
+
+
+
+void SetValue(A_Matrix *AlignMatrix, const int i, const int j, const float value)
+/*
+ * Coloca el puntaje value en la entrada (i,j) de AlignMatrix, convertido al tipo AlignMatrix->ScoreType.
+ */
+{
+	size_t k=EntryIndex(AlignMatrix, i, j);
+	switch(AlignMatrix->ScoreType)
+	{
+		case SCORE_INT16:
+			((short *)(AlignMatrix->Values))[k]=(short)value;
+			break;
+		case SCORE_INT32:
+			((int *)(AlignMatrix->Values))[k]=(int)value;
+			break;
+		default:
+			((float *)(AlignMatrix->Values))[k]=value;
+	}
+}//___________________________________________________________
+
+
+
+unsigned char GetPointers(const A_Matrix *AlignMatrix, const int i, const int j)
+/*
+ * La máscara de punteros de la entrada (i,j) de AlignMatrix. Si los punteros están empacados (ver PackTraceback()),
+ * la entrada k=EntryIndex(i,j) está en los 4 bits bajos (k par) o altos (k impar) del byte k/2.
+ */
+{
+	size_t k=EntryIndex(AlignMatrix, i, j);
+	if(AlignMatrix->Packed)
+		return ((AlignMatrix->Pointers)[k >> 1] >> ((k & 1) << 2)) & 0x0F;
+	return (AlignMatrix->Pointers)[k];
+}//___________________________________________________________
+
+
+
+void PackTraceback(A_Matrix *AlignMatrix, const int i, const int j)
+/*
+ * Una vez llena la matriz, el traceback sólo necesita los punteros (DIAG_BIT, VERT_BIT, HORI_BIT y DEAD_BIT caben en 4 bits)
+ * y el puntaje de la entrada donde empieza. Empaca los punteros dos entradas por byte (en el mismo arreglo, que luego se reduce),
+ * guarda en AlignMatrix->EndScore el puntaje de la entrada (i,j) y libera los puntajes: con puntajes int16 la matriz pasa
+ * de 3 bytes a medio byte por entrada. Después sólo se pueden leer los punteros (con GetPointers()) y el traceback debe empezar en (i,j).
+ */
+{
+	if(AlignMatrix->Packed)
+		return;
+	size_t n=(size_t)(AlignMatrix->Rows) * ((AlignMatrix->Band) < 0 ? (AlignMatrix->Cols) : (AlignMatrix->BandHi) - (AlignMatrix->BandLo) + 1), k;//Entradas guardadas (ver SetMatrixBand())
+	unsigned char *pointers=(AlignMatrix->Pointers);
+	(AlignMatrix->EndScore)=(InBand(AlignMatrix, i, j) ? GetValue(AlignMatrix, i, j) : 0);
+	for(k=0; k<n; k+=2)//El byte k/2 ya se leyó cuando se escribe (k/2 <= k)
+		pointers[k >> 1]=(pointers[k] & 0x0F) | (k+1 < n ? (pointers[k+1] & 0x0F) << 4 : 0);
+	(AlignMatrix->Pointers)=(unsigned char *) realloc(pointers, (n+1) >> 1);
+	assert((AlignMatrix->Pointers) != NULL);
+	free(AlignMatrix->Values);
+	(AlignMatrix->Values)=NULL;
+	(AlignMatrix->Packed)=1;
+}//___________________________________________________________
+
+
+
+size_t EntryIndex(const A_Matrix *AlignMatrix, const int i, const int j)
+/*
+ * Posición de la entrada (i,j) en AlignMatrix->Values y AlignMatrix->Pointers: i*Cols + j en la matriz completa,
+ * i*(BandHi-BandLo+1) + (j-i-BandLo) en una banda. La entrada debe estar guardada (ver InBand()).
+ */
+{
+	return (size_t)i * (AlignMatrix->Stride) + j + (AlignMatrix->Shift);
+}//___________________________________________________________
+
+
+
+int InBand(const A_Matrix *AlignMatrix, const int i, const int j)
+/*
+ * Verdadero si la entrada (i,j) está dentro de la matriz y de su banda (en la matriz completa, todas las entradas lo están).
+ */
+{
+	return i >= 0 && j >= 0 && i < (AlignMatrix->Rows) && j < (AlignMatrix->Cols)
+		&& j-i >= (AlignMatrix->BandLo) && j-i <= (AlignMatrix->BandHi);
+}//___________________________________________________________
 #undef DEFAULT_TYPE
 #undef DEFAULT_ALIGN
-
 # endif
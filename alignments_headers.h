@@ -1,5 +1,7 @@
 # ifndef STRING_ALIGN_ALIGNMENT_HEADERS
 # define STRING_ALIGN_ALIGNMENT_HEADERS
+# include <pthread.h>//Para las estructuras de ThreadPool
+# include <stdint.h>//Para los enteros de tamaño fijo de los registros binarios
 /*
 ===============================================================
 Declaraciones básicas para programa de alineamiento de cadenas.
@@ -19,50 +21,136 @@ Andrés García García @ Sab 26/Mar/2016. (Proyecto inició 19 Oct '15)
 	~~~~~~~~~~~~~~~~~~~~~~~
 	Declaración de las estructuras básicas utilizadas en el programa.
 */
-		typedef struct Entry_struct
-		 // Estructura correspondiente a cada entrada de la matriz
+		// Codificación de los punteros de traceback de cada entrada como máscara de bits
+		# define DIAG_BIT 1 // Puntero diagonal '\\'
+		# define VERT_BIT 2 // Puntero vertical '|'
+		# define HORI_BIT 4 // Puntero horizontal '-'
+		# define DEAD_BIT 8 // Entrada descartada por el X-drop: no tiene puntaje ni punteros
+
+		// Tipos de los puntajes de una matriz de alineamiento, se elige el más angosto que no se desborda
+		# define SCORE_INT16 0 // Enteros de 16 bits (short)
+		# define SCORE_INT32 1 // Enteros de 32 bits (int)
+		# define SCORE_FLOAT 2 // Punto flotante (float), para costos no enteros o matrices enormes
+
+		// Número de caminos (alineamientos óptimos), entero de 128 bits que se satura en PATH_COUNT_MAX en lugar de desbordarse
+		typedef unsigned __int128 PathCount;
+		# define PATH_COUNT_MAX (~(PathCount)0)
+		# define PATH_COUNT_DIGITS 40 // Caracteres para escribir cualquier PathCount en decimal (39 dígitos y el nulo)
+
+		// Formatos de salida de los alineamientos (ver WriteAlignRecord())
+		# define FORMAT_TEXT 0 // Texto para leerse: cadenas con huecos y código de edición (o CIGAR con --cigar)
+		# define FORMAT_TSV 1 // Un registro por línea separado por tabuladores, con encabezado
+		# define FORMAT_JSONL 2 // Un objeto JSON por línea
+		# define FORMAT_SAM 3 // Formato SAM, Str1 como referencia y Str2 como lectura
+		# define FORMAT_BIN 4 // Registros binarios de tamaño fijo con las corridas empacadas (ver binary.h)
+
+		// Formato de los registros binarios (ver binary.h)
+		# define BIN_MAGIC "GALN" // Firma al principio del archivo
+		# define BIN_VERSION 1 // Versión del formato que se escribe (y la mayor que se lee)
+		# define BIN_HEADER_SIZE 16 // Bytes del encabezado del archivo
+		# define BIN_RECORD_SIZE 40 // Bytes de la parte fija de cada registro
+
+
+		typedef struct S_Matrix_struct
+		// Matriz de sustitución: el puntaje de alinear cada par de caracteres
 		{
-			float Value;
-			int N_Pointers;
-			char Pointers[3];
+			char *Name;//Nombre de la matriz ("BLOSUM62" o el archivo de donde se leyó)
+			int Size;//Número de símbolos más uno, el último índice es el de los caracteres que no están en la matriz
+			int Index[256];//Índice de cada caracter en la tabla
+			float *Table;//Table[Index[a]*Size + Index[b]] es el puntaje de alinear el caracter a de Str1 con el b de Str2
+			float Max, Min;//El mayor y el menor puntaje de la tabla
+			int Integer;//Verdadero si todos los puntajes son enteros
 
-		} Entry;
+		} S_Matrix;
 		//___________________________________________________________
 
 
 		typedef struct A_Matrix_struct
 		// Estructura de la matriz de alineamiento, se compone de ambas secuencias de texto y las entradas de la matriz.
+		// Las entradas se guardan en dos bloques contiguos (fila por fila): los puntajes y las máscaras de punteros.
 		{
-			char *Str1;
-			char *Str2;
+			const char *Str1;//Las cadenas del llamador, no se copian (pueden estar en un archivo proyectado, ver LoadSeqFile())
+			const char *Str2;
 			char *Type;
 			char *AlignType;
 			float *Scores;
-			Entry **M;
+			int Rows;//Número de filas (longitud de Str2 + 1)
+			int Cols;//Número de columnas (longitud de Str1 + 1)
+			int ScoreType;//Tipo de los puntajes: SCORE_INT16 (short), SCORE_INT32 (int) o SCORE_FLOAT (float)
+			void *Values;//Puntajes del tipo ScoreType, la entrada (i,j) es Values[i*Stride + j + Shift] (leer con GetValue())
+			unsigned char *Pointers;//Punteros de traceback, la entrada (i,j) es Pointers[i*Stride + j + Shift], combinación de DIAG_BIT, VERT_BIT y HORI_BIT (o DEAD_BIT), leer con GetPointers()
+			const char *Engine;//Motor de llenado: NULL (automático), "scalar", "simd", "sse4.1" o "tiled"; después de FillAlignMatrix() es el nombre del motor usado ("banded" para las bandas, "striped-avx2" o "striped-sse4.1" para el local vectorial, "xdrop" para el X-drop)
+			int Threads;//Hilos para el llenado por bloques (0 para usar todos los procesadores)
+			double FillTime;//Segundos que tomó FillAlignMatrix()
+			int Band;//Semiancho K de la banda (sólo las entradas con BandLo<=j-i<=BandHi), -1 si se guarda la matriz completa
+			int BandLo, BandHi;//Primera y última diagonal j-i guardadas
+			int Stride, Shift;//Acomodo de las entradas: (i,j) está en la posición i*Stride + j + Shift (Cols y 0 para la matriz completa)
+			int BestRow, BestCol;//Entrada con el mejor puntaje de un alineamiento local o X-drop (la primera por columnas), desde donde empieza el traceback
+			float XDrop;//Umbral X: con similaridad, deja de calcular las entradas X por debajo del mejor puntaje (negativo para llenar toda la matriz)
+			double Skipped;//Entradas que el X-drop no calculó
+			const S_Matrix *Subst;//Matriz de sustitución para los apareamientos y reemplazos (NULL para usar M y R), no pertenece a la matriz
+			void *Profile;//Perfil de Str1 durante el llenado, del tipo ScoreType: la fila ProfileRow[c] tiene el puntaje de cada Str1[j-1] contra c (ver BuildProfile())
+			int *ProfileRow;//Fila del perfil de cada caracter de Str2 (256 entradas, -1 si no aparece)
+			int Packed;//Verdadero después de PackTraceback(): Pointers guarda dos entradas por byte (4 bits cada una) y Values ya se liberó
+			float EndScore;//Con los punteros empacados, el puntaje de la entrada desde donde empieza el traceback (el único que se conserva)
 
 		} A_Matrix;
 		//___________________________________________________________
 
 
+		typedef struct ArenaBlock_struct
+		// Bloque de una arena, sus datos empiezan ARENA_HEADER bytes después del inicio del bloque
+		{
+			struct ArenaBlock_struct *Next;//Bloque alojado antes que éste
+			size_t Size;//Bytes de datos del bloque
+			size_t Used;//Bytes de datos ya entregados
+
+		} ArenaBlock;
+		//___________________________________________________________
+
+
+		typedef struct Arena_struct
+		// Arena de memoria: entrega espacio en O(1) recorriendo un apuntador dentro de bloques grandes, que sólo se liberan todos juntos
+		{
+			ArenaBlock *Blocks;//Bloque actual, el primero de la lista
+			size_t BlockSize;//Bytes de datos de cada bloque nuevo (más si una petición no cabe)
+
+		} Arena;
+		//___________________________________________________________
+
+
+		typedef struct PathNode_struct
+		// Entrada de un camino del traceback, los caminos que empiezan igual (desde la entrada inicial) comparten sus nodos
+		{
+			int I, J;//Posición de la entrada en la matriz
+			int Pointer;//Puntero que sigue el camino desde esta entrada, -1 en la entrada donde termina
+			int Depth;//Número de entradas desde la inicial (0 en la inicial)
+			const struct PathNode_struct *Parent;//Entrada anterior del camino (más cercana a la inicial), NULL en la inicial
+
+		} PathNode;
+		//___________________________________________________________
+
+
 		typedef struct Path_struct
 		// Elemento fundamental de la estructura Traceback
 		{
-			int iSize;//Número de entradas inicializadas
-			int uSize;//Número de entradas no inicializadas
+			int iSize;//Número de entradas del camino
 			float pScore;//Score del camino
-			int **Path;//Arreglo de entradas, cada entrada consiste de tres enteros, que comprenden una posición en la matriz y un puntero
+			const PathNode *Last;//Entrada donde termina el camino (sin punteros); el camino completo se recorre hacia atrás por los Parent
 		} Path;
 		//___________________________________________________________
 
 
 		typedef struct Traceback_struct
-		//Contiene implícitamente cada alineamiento desde una celda de una matriz de alineamiento A_Matrix
+		//Contiene implícitamente cada alineamiento desde una celda de una matriz de alineamiento A_Matrix, como un árbol de entradas compartidas
 		{
-			char *Str1;
-			char *Str2;
+			const char *Str1;//Las de la matriz, no se copian
+			const char *Str2;
 			int iPaths;//Número de caminos inicializados
 			int uPaths;//Número de caminos no inicializados
 			Path *Paths;//Arreglo de caminos
+			Arena *Pool;//Arena de la que salen los nodos de todos los caminos, se libera de una sola vez
+			size_t nNodes;//Número de nodos: la memoria es proporcional a las entradas distintas del árbol, no a caminos por longitud
 
 		} Traceback;
 		//___________________________________________________________
@@ -74,11 +162,215 @@ Andrés García García @ Sab 26/Mar/2016. (Proyecto inició 19 Oct '15)
 			float Score;
 			char *Align1;
 			char *Align2;
+			char *EditTr;//Código de edición; las tres cadenas están en un solo bloque que empieza en Align1 (ver AllocExplAlign())
 
 		} Align;
 		//___________________________________________________________
 
 
+		typedef struct Cigar_struct
+		//Alineamiento compacto: las corridas de su código de edición (como el CIGAR de SAM, p. ej. 5M1I3M2D)
+		{
+			float Score;
+			int Start1, Start2;//Posición de Str1 y de Str2 donde empieza el alineamiento (0 en los globales)
+			int nRuns;//Número de corridas
+			int Size;//Corridas alojadas
+			int *Lengths;//Longitud de cada corrida
+			char *Ops;//Letra de cada corrida: M, R, I o D (ver EditOp())
+
+		} Cigar;
+		//___________________________________________________________
+
+
+		typedef struct TracebackFrame_struct
+		// Entrada del camino en construcción de un AlignIterator
+		{
+			int I, J;//Posición de la entrada en la matriz
+			unsigned char Pointers;//Máscara de punteros de la entrada (ver GetPointers())
+			unsigned char Next;//Índice (como en NthPointer()) del puntero que sigue el camino
+
+		} TracebackFrame;
+		//___________________________________________________________
+
+
+		typedef struct AlignIterator_struct
+		// Recorre uno por uno los alineamientos óptimos desde una entrada de una matriz de alineamiento, con una búsqueda en profundidad
+		{
+			const A_Matrix *AlignMatrix;//Matriz con los punteros, no pertenece al iterador y debe existir mientras se use
+			TracebackFrame *Stack;//Camino actual desde la entrada inicial, a lo más Rows+Cols-1 entradas
+			int Depth;//Entradas del camino actual
+			int Started;//Verdadero después de la primera llamada a NextPath()
+			int Count;//Alineamientos devueltos hasta ahora
+			Align Current;//Último alineamiento devuelto, sus cadenas pertenecen al iterador
+			int StartI, StartJ;//Entrada inicial de los caminos
+			double *Weights;//Caminos óptimos desde cada entrada, en el orden de Pointers (ver SamplePath()), NULL hasta el primer muestreo
+			int *Scales;//Exponente de la escala de cada fila de Weights: la fila r guarda los caminos por 2^-Scales[r]
+			Cigar Runs;//Corridas del último camino (ver CigarFromStack()), pertenecen al iterador
+
+		} AlignIterator;
+		//___________________________________________________________
+
+
+		typedef struct Sequence_struct
+		//Registro de un archivo FASTA o FASTQ, separado en su lugar dentro de la proyección del archivo
+		{
+			const char *Name;//Nombre: la primera palabra del encabezado, sin '>' ni '@'
+			const char *Seq;//Secuencia, terminada en '\0'
+			size_t Length;//Longitud de la secuencia
+
+		} Sequence;
+		//___________________________________________________________
+
+
+		typedef struct SeqFile_struct
+		//Archivo FASTA o FASTQ proyectado en memoria y sus registros
+		{
+			char *Data;//Contenido del archivo (proyección privada, NULL si está vacío)
+			size_t Size;//Bytes del archivo
+			int nSeqs;//Número de registros
+			int Alloc;//Registros alojados en Seqs
+			Sequence *Seqs;//Los registros, en el orden del archivo
+			char *Tail;//Copia de la última secuencia si no cupo su '\0' en la proyección (NULL casi siempre)
+
+		} SeqFile;
+		//___________________________________________________________
+
+
+		typedef struct Writer_struct
+		//Salida con búfer: junta lo escrito y lo escribe en su descriptor con una llamada a write() por bloque
+		{
+			int Fd;//Descriptor donde se escribe (STDOUT_FILENO normalmente)
+			int Format;//Formato de los alineamientos: FORMAT_TEXT, FORMAT_TSV, FORMAT_JSONL, FORMAT_SAM o FORMAT_BIN
+			char *Buffer;//Búfer de WRITER_SIZE bytes
+			size_t Used;//Bytes del búfer pendientes de escribir
+			const char *Name1, *Name2;//Nombres de Str1 y Str2 en los registros, no pertenecen al Writer
+			unsigned int Id1, Id2;//Números de los registros de Str1 y Str2 en sus archivos para los registros binarios, desde 1 (0 para las cadenas de la línea de comandos)
+			long long Records;//Registros escritos
+			int Header;//Verdadero si ya se escribió el encabezado del formato (antes del primer registro, ver WriteSamHeader())
+
+		} Writer;
+		//___________________________________________________________
+
+
+		typedef struct BinRecord_struct
+		//Registro binario de un alineamiento (ver binary.h), con su parte fija ya decodificada
+		{
+			uint32_t Number;//Número del alineamiento
+			uint32_t Id1, Id2;//Números de los registros de Str1 y Str2 en sus archivos, desde 1 (0 para las cadenas de la línea de comandos)
+			float Score;
+			int32_t Start1, End1, Start2, End2;//Str1[Start1..End1) y Str2[Start2..End2) son las partes alineadas
+			uint32_t nRuns;//Número de corridas
+			uint32_t Edits;//Columnas que no son apareamientos
+			const unsigned char *Runs;//Las nRuns corridas empacadas, 4 bytes cada una (ver GetBinRun())
+
+		} BinRecord;
+		//___________________________________________________________
+
+
+		typedef struct BinFile_struct
+		//Archivo de registros binarios proyectado en memoria
+		{
+			const unsigned char *Data;//Contenido del archivo (NULL si está vacío)
+			size_t Size;//Bytes del archivo
+			size_t Pos;//Posición del siguiente registro
+			int Version;//Versión del formato del archivo
+			int RecordSize;//Bytes de la parte fija de cada registro
+
+		} BinFile;
+		//___________________________________________________________
+
+
+		typedef struct AlignOptions_struct
+		//Opciones de ejecución de un alineamiento, normalmente obtenidas de la línea de comandos
+		{
+			const char *Engine;//Motor de llenado de la matriz: NULL (automático), "scalar", "simd", "sse4.1" o "tiled"
+			int Threads;//Hilos para el llenado por bloques (0 para usar todos los procesadores)
+			int Stats;//Verdadero para imprimir el motor de llenado y su rendimiento
+			int Band;//Semiancho inicial de la banda alrededor de la diagonal principal (-1 para la matriz completa)
+			float XDrop;//Umbral de la terminación X-drop para similaridad (negativo para llenar toda la matriz)
+			const S_Matrix *Subst;//Matriz de sustitución en lugar de M y R (NULL para no usarla)
+			int CountOnly;//Verdadero para imprimir sólo el número de alineamientos óptimos, sin obtenerlos
+			int MaxAligns;//Máximo de alineamientos óptimos que se obtienen e imprimen (0 para todos)
+			int Sample;//Número de alineamientos óptimos elegidos al azar (con probabilidad uniforme) que se imprimen, 0 para no muestrear
+			unsigned long long Seed;//Semilla del muestreo
+			int CigarOnly;//Verdadero para imprimir los alineamientos como sus corridas (CIGAR), sin las cadenas con huecos
+			int TreeTraceback;//Verdadero para obtener todos los caminos a la vez, en un árbol de nodos de una arena (ver TracebackFromMatrixEntry()), en lugar del iterador
+			Writer *Out;//Salida de los alineamientos y su formato (NULL para texto en la salida estándar)
+
+		} AlignOptions;
+		//___________________________________________________________
+
+
+		typedef struct PoolTask_struct
+		// Tarea pendiente en la cola de un ThreadPool
+		{
+			void (*Function)(void *arg);//Función a ejecutar
+			void *Arg;//Argumento de la función
+			struct PoolTask_struct *Next;//Siguiente tarea en la cola
+
+		} PoolTask;
+		//___________________________________________________________
+
+
+		typedef struct ThreadPool_struct
+		// Conjunto de hilos que ejecutan las tareas de una cola compartida
+		{
+			int nThreads;//Número de hilos
+			pthread_t *Threads;//Los hilos
+			pthread_mutex_t Lock;//Protege la cola y los contadores
+			pthread_cond_t TaskReady;//Señala que hay tareas en la cola (o que se debe terminar)
+			pthread_cond_t AllDone;//Señala que ya no hay tareas pendientes
+			PoolTask *Head;//Primera tarea de la cola
+			PoolTask *Tail;//Última tarea de la cola
+			int Pending;//Tareas encoladas o en ejecución
+			int Shutdown;//Verdadero cuando los hilos deben terminar
+
+		} ThreadPool;
+		//___________________________________________________________
+
+
+		typedef struct Hirschberg_struct
+		// Datos compartidos por todos los subproblemas de un alineamiento de Hirschberg
+		{
+			const char *Str1;
+			const char *Str2;
+			const char *Type;
+			const float *Scores;
+			int Maximize;//Verdadero si es alineamiento por similaridad (max)
+			char *Ops;//Ops[i+j] es el puntero que llega a la entrada (i,j) del camino óptimo, o 0 si el camino no pasa por la antidiagonal i+j
+			ThreadPool *Pool;//Hilos entre los que se reparten los subproblemas (NULL para resolverlos en el hilo actual)
+
+		} Hirschberg;
+		//___________________________________________________________
+
+
+		typedef struct HirschbergTask_struct
+		// Subproblema: alinear Str2[I0..I1) con Str1[J0..J1)
+		{
+			Hirschberg *H;
+			int I0, J0;
+			int I1, J1;
+
+		} HirschbergTask;
+		//___________________________________________________________
+
+
+		typedef void (*FillBlockKernel)(A_Matrix *AlignMatrix, const int row0, const int row1, const int col0, const int col1);
+		// Núcleo escalar especializado que llena las entradas (i,j) con row0<=i<row1 y col0<=j<col1 de una matriz (ver scalar_fill.h)
+
+
+		typedef struct FillTile_struct
+		// Bloque de una matriz de alineamiento: las entradas (i,j) con Row0<=i<Row1 y Col0<=j<Col1
+		{
+			A_Matrix *A;//Matriz a la que pertenece el bloque
+			FillBlockKernel Fill;//Núcleo especializado según el tipo de matriz y de puntaje
+			int Row0, Col0;
+			int Row1, Col1;
+
+		} FillTile;
+		//___________________________________________________________
+
+
 
 /*
 	~~~~~~~~~~~~~~~~~~~
@@ -90,16 +382,22 @@ Andrés García García @ Sab 26/Mar/2016. (Proyecto inició 19 Oct '15)
 		float Min(const float *numbers, const int size); // Encuentra el mínimo de los valores en numbers, de longitud size
 		float Max(const float *numbers, const int size); // Encuentra el máximo de los valores en numbers, donde numbers tiene size entradas
 		void swap(char *s, const int a, const int b); // Intercambia los valores s[a] y s[b] en la cadena de texto str
-		void insert(const char c, const int pos, char *s); //Inserta el caracter c en la cadena de texto str, de tal manera que str[pos]=c, los otros valores se recorren al final de la cadena
+		char *insert(const char c, const int pos, char *s); //Inserta el caracter c en la cadena de texto str, de tal manera que str[pos]=c, los otros valores se recorren al final de la cadena. Devuelve la cadena (puede cambiar de lugar)
 		float *getNum(const char *str, const int pos); //Obtiene el valor numérico en la cadena str desde la posición pos, además de la posición del siguiente caracter no numérico.
 		char ***getArgs(char **argv, const int argc); //De la lista de strings argv con argc cadenas, obtiene las variables declaradas como "--var=val".
 		char *getVar(const char *str); //str es una declaración de variable de la forma "--variable=valor". Obtiene "variable".
 		char *getVal(const char *str); //str es una declaración de variable de la forma "--variable=valor". Obtiene "valor".
         char *searchArg(char *arg_name, char ***args); // Busca la variable arg_name entre los las variables contenidas en args, devuelve su valor.
+        int hasArg(char *arg_name, char ***args); // Verdadero (1) si la variable arg_name fué declarada en args, aunque no tenga valor (p. ej. "--score-only").
         void freeArgs(char ***args); // Libera el espacio ocupado por el arreglo args, previamente declarado con la función getArgs().
 		int equStr(const char *str1, const char *str2); //Verdadero (1) si str1 es igual a str2.
 		char *dupStr(const char *ref_str); //Genera un duplicado de la cadena de referencia ref_str y devuelve un puntero a la copia
 		void copyStr(char *copy, const char *ref_str); // Copia ref_str a copy, asumiendo que el espacio es suficiente hasta el primer caracter nulo
+		unsigned long long randNext(unsigned long long *state); // Siguiente número pseudoaleatorio de 64 bits (SplitMix64) de la semilla state, que avanza
+		double randUnit(unsigned long long *state); // Número pseudoaleatorio uniforme en [0,1) de la semilla state, que avanza
+		Arena *allocArena(const size_t block_size); // Genera una arena vacía que aloja bloques de block_size bytes
+		void *arenaAlloc(Arena *arena, const size_t bytes); // Entrega bytes bytes de la arena (alineados a 16), en O(1)
+		void freeArena(Arena *arena); // Libera la arena y todo el espacio que entregó, de una sola vez
 
 
 
@@ -108,16 +406,32 @@ Andrés García García @ Sab 26/Mar/2016. (Proyecto inició 19 Oct '15)
 	Matriz de alineamiento
 	~~~~~~~~~~~~~~~~~~~~~~
 	Fuente: alignment_matrix.h
-	Funciones especializadas para la estructura A_Matrix (y su subsidiaria Entry), que representa una matriz de alineamiento.
+	Funciones especializadas para la estructura A_Matrix, que representa una matriz de alineamiento.
 	Contiene funciones para crear, llenar, imprimir y destruir matrices de alineamiento.
 ::*/
 		A_Matrix *AllocAlignMatrix(const char *str1, const char *str2, const char *type, const char *aligntype, const float *scores); //Genera espacio para una matriz de alineamiento general con las cadenas de texto Str1 y Str2
+		A_Matrix *AllocBandedAlignMatrix(const char *str1, const char *str2, const char *type, const char *aligntype, const float *scores, const int band); // Genera espacio sólo para las entradas a distancia a lo más band de la diagonal principal (la matriz completa si band<0)
+		void SetMatrixBand(A_Matrix *AlignMatrix, const int band); // Vuelve a alojar las entradas de AlignMatrix para la banda de semiancho band (sin llenar)
 		float *getScores(const char *scoreStr); //Obtiene los costos de operación expresados en scoreStr.
 		void Score(A_Matrix *Al, const int i, const int j, float (*Compare)(const float *numbers, const int size)); // LLena la entrada i,j de la matriz AlignMatrix utilizando la función Compare para seleccionar la entrada correcta
-		void FillAlignMatrix(A_Matrix *AlignMatrix); // LLena la matriz AlignMatrix con los valores y punteros correspondientes con ayuda de la función Score()
+		void FillAlignMatrix(A_Matrix *AlignMatrix); // LLena la matriz AlignMatrix con los valores y punteros correspondientes con ayuda de la función Score() o de un motor vectorial
 		void PrintAlignMatrixNoPointers(const A_Matrix *AlignMatrix);//Imprime sólo las entradas de la matriz de alineamiento AlignMatrix (sin punteros)
 		void PrintAlignMatrix(const A_Matrix *AlignMatrix); //Imprime la matriz de alineamiento AlignMatrix, incluyendo los punteros de traceback, estos son: \(diagonal) |(vertical) y _(horizontal)
+		void PrintFillStats(const A_Matrix *AlignMatrix); // Imprime el motor con el que se llenó AlignMatrix, el tiempo que tomó y su rendimiento en GCUPS
+		void FindBestEntry(A_Matrix *AlignMatrix); // Coloca en AlignMatrix->BestRow y BestCol la entrada con el mejor puntaje (la primera por columnas)
+		float GlobalScore(const char *str1, const char *str2, const char *type, const float *scores); // Calcula sólo el puntaje óptimo del alineamiento global de str1 y str2, sin punteros y con memoria O(min(m,n))
 		void FreeAlignMatrix(A_Matrix *AlignMatrix); //  Libera el espacio de una estructura a_matrix previamente alojada con AllocAlignMatrix()
+		int PointerCount(const unsigned char pointers); // Número de punteros en la máscara pointers
+		char NthPointer(const unsigned char pointers, const int p); // El p-ésimo puntero de la máscara pointers, como caracter: \\(diagonal) |(vertical) y -(horizontal)
+		int ChooseScoreType(const float *scores, const int len1, const int len2); // El tipo de puntaje más angosto que no se desborda al alinear cadenas de longitudes len1 y len2 con los costos scores
+		size_t ScoreTypeSize(const int score_type); // Tamaño en bytes de un puntaje del tipo score_type
+		const char *ScoreTypeName(const int score_type); // Nombre del tipo de puntaje score_type: "int16", "int32" o "float"
+		float GetValue(const A_Matrix *AlignMatrix, const int i, const int j); // El puntaje de la entrada (i,j) de AlignMatrix, sin importar su tipo
+		void SetValue(A_Matrix *AlignMatrix, const int i, const int j, const float value); // Coloca el puntaje value en la entrada (i,j) de AlignMatrix, convertido a su tipo
+		unsigned char GetPointers(const A_Matrix *AlignMatrix, const int i, const int j); // Los punteros de la entrada (i,j) de AlignMatrix, empacados o no
+		void PackTraceback(A_Matrix *AlignMatrix, const int i, const int j); // Empaca los punteros a 4 bits por entrada y libera los puntajes, salvo el de la entrada (i,j)
+		size_t EntryIndex(const A_Matrix *AlignMatrix, const int i, const int j); // Posición de la entrada (i,j) en AlignMatrix->Values y AlignMatrix->Pointers
+		int InBand(const A_Matrix *AlignMatrix, const int i, const int j); // Verdadero si la entrada (i,j) existe y está guardada en AlignMatrix
 
 
 
@@ -133,9 +447,21 @@ Andrés García García @ Sab 26/Mar/2016. (Proyecto inició 19 Oct '15)
 		Traceback *AllocTracebackForMatrix(const A_Matrix *AlignMatrix);
 		Traceback *TracebackFromMatrixEntry(const A_Matrix *AlignMatrix, const int i, const int j);
 		void FreeTraceback(Traceback *traceback); // Libera el espacio ocupado por la estructura traceback previamente alojada por AllocTracebackForMatrix()
-		void AllocMorePaths(Traceback *traceback, const int extra_entries, const int path_size);
-		void ExtendPath(Path *path, const int extra_entries);
-		void PathCopy(const Path *p1, Path *p2, const int skip);//Copia el camino en p1 a p2, excepto las últimas skip entradas
+		void AllocMorePaths(Traceback *traceback, const int extra_paths); // Haz espacio para extra_paths caminos nuevos, todavía sin entradas
+		const PathNode *NewPathNode(Traceback *traceback, const int i, const int j, const int pointer, const PathNode *parent); // Nodo de la arena del traceback con la entrada (i,j) y su puntero, hijo de parent
+		AlignIterator *AllocAlignIterator(const A_Matrix *AlignMatrix, const int i, const int j); // Iterador sobre los alineamientos óptimos desde la entrada (i,j), (-1,-1) para la última
+		const Align *NextAlign(AlignIterator *iterator); // El siguiente alineamiento óptimo del iterador, NULL si ya no hay más
+		const Cigar *NextCigar(AlignIterator *iterator); // Las corridas del siguiente alineamiento óptimo del iterador, sin armar las cadenas, NULL si ya no hay más
+		int NextPath(AlignIterator *iterator); // Deja en la pila del iterador el siguiente camino óptimo, 0 si ya no hay más
+		void AlignFromStack(AlignIterator *iterator); // Arma en iterator->Current el alineamiento del camino que está en la pila, a partir de sus corridas
+		void CigarFromStack(AlignIterator *iterator); // Coloca en iterator->Runs las corridas del camino que está en la pila, desde sus punteros
+		double *PathWeights(const A_Matrix *AlignMatrix, const int i, const int j, int *scales); // Número de caminos hasta una entrada sin punteros desde cada entrada (r,c) con r<=i, c<=j, escalado por filas
+		const Align *SampleAlign(AlignIterator *iterator, unsigned long long *seed); // Un alineamiento óptimo al azar, con probabilidad uniforme, NULL si no hay
+		const Cigar *SampleCigar(AlignIterator *iterator, unsigned long long *seed); // Las corridas de un alineamiento óptimo al azar, NULL si no hay
+		int SamplePath(AlignIterator *iterator, unsigned long long *seed); // Deja en la pila del iterador un camino óptimo al azar, 0 si no hay
+		void FreeAlignIterator(AlignIterator *iterator); // Libera el espacio de un iterador previamente alojado con AllocAlignIterator()
+		PathCount CountAlignments(const A_Matrix *AlignMatrix, const int i, const int j); // Número de alineamientos óptimos desde la entrada (i,j), sin obtenerlos
+		char *PathCountStr(const PathCount count, char *str); // Escribe count en decimal en str (al menos PATH_COUNT_DIGITS caracteres) y lo devuelve
 
 
 
@@ -149,12 +475,270 @@ Andrés García García @ Sab 26/Mar/2016. (Proyecto inició 19 Oct '15)
 	Contiene funciones especializadas para crear, llenar, imprimir y destruir alineamientos.
 	Contiene funciones para crear e imprimir los códigos de edición de los alineamientos.
 ::*/
-		void GlobalAlignment(const char *str1, const char *str2, const char *type, const float *scores); // Obtiene e imprime todos los alineamientos globales óptimos de str1 y str2 con las características especificadas.
+		void GlobalAlignment(const char *str1, const char *str2, const char *type, const float *scores, const AlignOptions *options); // Obtiene e imprime todos los alineamientos globales óptimos de str1 y str2 con las características especificadas.
+		void LocalAlignment(const char *str1, const char *str2, const char *type, const float *scores, const AlignOptions *options); // Obtiene e imprime todos los alineamientos locales óptimos de str1 y str2 que terminan en la mejor entrada.
+		void GlobalAlignmentScore(const char *str1, const char *str2, const char *type, const float *scores, const AlignOptions *options); // Obtiene e imprime sólo el puntaje óptimo del alineamiento global, con memoria O(min(m,n)) (un registro sin CIGAR en options->Out).
+		void PrintAlignHeader(const char *title, const char *str1, const char *str2, const char *type, const float *scores); // Imprime el encabezado de un alineamiento: título, cadenas, scores y tipo de matriz.
+		Align *ExplAlignFromPointers(const char *str1, const char *str2, const char *pointers, const int n_pointers, const float score); // Genera un arreglo con un solo alineamiento a partir de los punteros de un camino, ordenados desde la entrada (0,0).
 		Align *ExplAlignsFromTraceback(const Traceback *traceback); // Obtiene los alineamientos desde los caminos obtenidos.
-		void PrintExplAlign(const Align *align); // Muestra el alineamiento explícito Align.
-		void PrintAlignments(const Align *align); // Imprime los alineamientos en el arreglo alignments.
+		void ExplAlignFromPath(const Traceback *traceback, const int path, Align *align); // Arma en align el alineamiento del camino path, recorriendo sus nodos hacia atrás.
+		void AllocExplAlign(Align *align, const int len); // Aloja en un solo bloque las dos cadenas y el código de edición de un alineamiento de hasta len columnas.
+		void SetAlignColumn(Align *align, const int k, const char c1, const char c2); // Escribe la columna k del alineamiento y su letra del código de edición.
+		void EndExplAlign(Align *align, const int len); // Termina las tres cadenas del alineamiento después de len columnas.
+		char EditOp(const char c1, const char c2); // Letra del código de edición (M, R, I o D) de una columna del alineamiento.
+		Align *ExplAlignFromOps(const char *str1, const char *str2, const float *scores, char *ops); // Genera un arreglo con un solo alineamiento a partir de ops[i+j], el puntero que llega a la entrada (i,j) del camino.
+		void PrintExplAlign(Writer *out, const Align *align); // Escribe en out el alineamiento explícito Align.
+		void PrintAlignments(const Align *align, const char *str1, const char *str2, const AlignOptions *options); // Imprime los alineamientos en el arreglo alignments en options->Out (sólo sus CIGAR con options->CigarOnly).
+		void PrintTraceback(Writer *out, const Traceback *traceback, const int cigar_only); // Escribe en out todos los alineamientos de los caminos de traceback, con el formato de out.
+		int PrintAlignIterator(AlignIterator *iterator, const int max_aligns, Writer *out, const int cigar_only); // Imprime en out a lo más max_aligns alineamientos del iterador (0 para todos) conforme se obtienen, devuelve cuántos fueron.
+		void PrintStackAlign(Writer *out, AlignIterator *iterator, const int cigar_only); // Escribe en out el alineamiento del camino que está en la pila del iterador, con el formato de out.
+		void PrintAlignsFromEntry(const A_Matrix *AlignMatrix, const int i, const int j, const AlignOptions *options); // Imprime los alineamientos óptimos desde la entrada (i,j), o sólo cuántos son.
+		void PrintAlignNumber(Writer *out, const Align *align, const int number); // Escribe en out un alineamiento con su número y su código de edición.
 		void FreeAligns(Align *alignments); // Libera el espacio ocupado por la estructura alignments previamente alojada por ExplAlignsFromTraceback().
+		void FreeExplAlign(Align *align); // Libera el bloque de las cadenas de un alineamiento alojado con AllocExplAlign().
 		char *EditTrFromExplAlign(const Align *align); // Genera el código de edición asociado al alineamiento Align.
-		void PrintEditTr(const char *edit_tr); // Muestra el código de edición en el mismo formato en que se muestra el alineamiento en PrintExplAlign().
+		void PrintEditTr(Writer *out, const char *edit_tr); // Escribe en out el código de edición en el mismo formato en que se muestra el alineamiento en PrintExplAlign().
+
+
+
+/*
+	~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Representación compacta de alineamientos
+	~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Fuente: cigar.h
+	Alineamientos guardados como las corridas de su código de edición (CIGAR, p. ej. 5M1I3M2D), armados sólo al imprimirse.
+::*/
+		void AllocCigar(Cigar *cigar, const int size); // Aloja espacio para size corridas en un CIGAR vacío
+		void AddCigarRun(Cigar *cigar, const char op, const int len); // Agrega len columnas con la letra op, alargando la última corrida si tiene la misma letra
+		void CigarFromExplAlign(const Align *align, Cigar *cigar); // Coloca en cigar las corridas del código de edición de align
+		int CigarLength(const Cigar *cigar); // Número de columnas del alineamiento
+		void CigarSpan(const Cigar *cigar, int *len1, int *len2); // Número de caracteres de Str1 y de Str2 que cubre el alineamiento
+		void AlignFromCigar(const Cigar *cigar, const char *str1, const char *str2, Align *align); // Arma en align las cadenas con huecos y el código de edición de cigar
+		void PrintCigar(Writer *out, const Cigar *cigar); // Escribe en out el CIGAR en una línea y dónde empieza el alineamiento si no es en el principio de las cadenas
+		void PrintCigarNumber(Writer *out, const Cigar *cigar, const int number); // Escribe en out un alineamiento compacto con su número y su puntaje
+		void FreeCigar(Cigar *cigar); // Libera las corridas del CIGAR
+
+
+
+/*
+	~~~~~~~~~~~~~~~
+	Salida con búfer
+	~~~~~~~~~~~~~~~
+	Fuente: writer.h
+	Escritura por bloques de la salida y registros de una línea por alineamiento (TSV, JSONL o SAM).
+::*/
+		Writer *AllocWriter(const int fd, const int format); // Aloja una salida con búfer hacia el descriptor fd con el formato format
+		int ParseFormat(const char *name); // Formato con el nombre name ("text", "tsv", "jsonl" o "sam"), -1 si no existe
+		void WriteBytes(Writer *out, const char *bytes, const size_t n); // Agrega n bytes al búfer, escribiéndolo cuando se llena
+		void WriteChar(Writer *out, const char c); // Agrega un caracter al búfer
+		void WriteStr(Writer *out, const char *str); // Agrega una cadena al búfer
+		void WriteInt(Writer *out, const int n); // Agrega un entero en decimal al búfer, sin pasar por printf()
+		void WriteFormat(Writer *out, const char *format, ...); // Agrega texto con formato de printf() al búfer
+		void WriteScore(Writer *out, const float score); // Agrega un puntaje: en decimal si es entero, si no con %.9g (el float exacto)
+		void WriteJsonStr(Writer *out, const char *str); // Agrega una cadena entre comillas con los caracteres especiales escapados para JSON
+		void WriteSamHeader(Writer *out, const Sequence *refs, const int n); // Escribe el encabezado SAM con n referencias
+		void WriteAlignRecord(Writer *out, const Cigar *cigar, const int number, const char *str1, const char *str2); // Escribe un alineamiento compacto como un registro de una línea en el formato de out
+		void FlushWriter(Writer *out); // Escribe lo que queda en el búfer
+		void FreeWriter(Writer *out); // Escribe lo que queda en el búfer y libera la salida
+
+
+
+/*
+	~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Registros binarios de alineamientos
+	~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Fuente: binary.h
+	Registros de tamaño fijo con las corridas empacadas (--format=bin) y su lectura con mmap() sin analizar texto.
+::*/
+		void PutU32(unsigned char *bytes, const uint32_t value); // Escribe value en 4 bytes en little-endian
+		uint32_t GetU32(const unsigned char *bytes); // Lee un entero little-endian de 4 bytes
+		void PackBinHeader(unsigned char *bytes); // Escribe el encabezado del archivo de registros
+		void PackBinRecord(unsigned char *bytes, const BinRecord *record); // Escribe la parte fija de un registro
+		uint32_t PackBinRun(const char op, const int len); // Corrida empacada de len columnas con la letra op
+		void GetBinRun(const BinRecord *record, const int k, char *op, int *len); // Letra y longitud de la corrida k del registro
+		BinFile *OpenBinFile(const char *name); // Proyecta en memoria un archivo de registros y verifica su encabezado, NULL si no se pudo
+		int NextBinRecord(BinFile *file, BinRecord *record); // Decodifica el siguiente registro, 0 si ya no hay más
+		void CloseBinFile(BinFile *file); // Libera la proyección del archivo
+
+
+
+/*
+	~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Lectura de archivos FASTA y FASTQ
+	~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Fuente: seq_file.h
+	Registros separados en su lugar dentro de la proyección privada del archivo, sin copiar las secuencias.
+::*/
+		SeqFile *LoadSeqFile(const char *name); // Proyecta en memoria un archivo FASTA o FASTQ y separa sus registros en su lugar, NULL si no se pudo
+		size_t SeqLine(const char *data, size_t pos, const size_t size); // Posición del fin de la línea que empieza en pos
+		void AddSequence(SeqFile *file, const char *name, const char *seq, const size_t length); // Agrega un registro al arreglo de registros
+		void FreeSeqFile(SeqFile *file); // Libera la proyección del archivo y sus registros
+
+
+
+/*
+	~~~~~~~~~~~~~~~~~
+	Conjunto de hilos
+	~~~~~~~~~~~~~~~~~
+	Fuente: thread_pool.h
+	Funciones para repartir tareas independientes entre varios hilos de ejecución.
+::*/
+		ThreadPool *AllocThreadPool(int n_threads); // Genera un conjunto de n_threads hilos en espera de tareas (todos los procesadores si n_threads<=0)
+		void PoolSubmit(ThreadPool *pool, void (*function)(void *arg), void *arg); // Encola la tarea function(arg), si pool es NULL la ejecuta inmediatamente
+		void PoolWait(ThreadPool *pool); // Espera a que terminen todas las tareas encoladas
+		void FreeThreadPool(ThreadPool *pool); // Termina los hilos y libera el espacio de un conjunto previamente alojado con AllocThreadPool()
+		int DefaultThreads(void); // Número de procesadores disponibles
+		void *PoolWorker(void *arg); // Ciclo de cada hilo, toma y ejecuta tareas de la cola
+
+
+
+/*
+	~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Alineamiento de Hirschberg
+	~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Fuente: hirschberg.h
+	Alineamiento global óptimo con memoria lineal por divide y vencerás, los subproblemas se reparten entre varios hilos.
+::*/
+		void HirschbergAlignment(const char *str1, const char *str2, const char *type, const float *scores, const AlignOptions *options); // Obtiene e imprime un alineamiento global óptimo con memoria lineal
+		Align *HirschbergAlign(const char *str1, const char *str2, const char *type, const float *scores, const int threads); // Obtiene un alineamiento global óptimo con memoria lineal
+		void HirschbergRow(const char *str1, const int len1, const char *str2, const int len2, const int reverse, const int maximize, const float *scores, float *row); // Calcula la última fila de la matriz de str2 contra str1 (al revés si reverse)
+		void HirschbergSolve(void *task); // Resuelve un subproblema HirschbergTask, dividiéndolo o directamente
+		void HirschbergBase(Hirschberg *h, const int i0, const int j0, const int i1, const int j1); // Resuelve un subproblema pequeño con una matriz completa
+
+
+
+/*
+	~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Llenado escalar especializado
+	~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Fuente: scalar_fill.h (núcleos generados con la plantilla scalar_fill_kernel.h)
+	Núcleos escalares especializados al compilar por objetivo (mínimo, máximo o local) y tipo de puntaje, idénticos al llenado con Score().
+::*/
+		FillBlockKernel ChooseFillBlock(const int score_type, const int maximize); // El núcleo especializado para puntajes del tipo score_type y el objetivo dado
+		void FillBlockMinInt16(A_Matrix *AlignMatrix, const int row0, const int row1, const int col0, const int col1); // Llena un bloque de una matriz de distancia con puntajes int16
+		void FillBlockMinInt32(A_Matrix *AlignMatrix, const int row0, const int row1, const int col0, const int col1); // Llena un bloque de una matriz de distancia con puntajes int32
+		void FillBlockMinFloat(A_Matrix *AlignMatrix, const int row0, const int row1, const int col0, const int col1); // Llena un bloque de una matriz de distancia con puntajes float
+		void FillBlockMaxInt16(A_Matrix *AlignMatrix, const int row0, const int row1, const int col0, const int col1); // Llena un bloque de una matriz de similaridad con puntajes int16
+		void FillBlockMaxInt32(A_Matrix *AlignMatrix, const int row0, const int row1, const int col0, const int col1); // Llena un bloque de una matriz de similaridad con puntajes int32
+		void FillBlockMaxFloat(A_Matrix *AlignMatrix, const int row0, const int row1, const int col0, const int col1); // Llena un bloque de una matriz de similaridad con puntajes float
+		FillBlockKernel ChooseLocalFillBlock(const int score_type); // El núcleo especializado del alineamiento local para puntajes del tipo score_type
+		void FillBlockLocalInt16(A_Matrix *AlignMatrix, const int row0, const int row1, const int col0, const int col1); // Llena un bloque de una matriz local con puntajes int16
+		void FillBlockLocalInt32(A_Matrix *AlignMatrix, const int row0, const int row1, const int col0, const int col1); // Llena un bloque de una matriz local con puntajes int32
+		void FillBlockLocalFloat(A_Matrix *AlignMatrix, const int row0, const int row1, const int col0, const int col1); // Llena un bloque de una matriz local con puntajes float
+
+
+
+/*
+	~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Llenado vectorial (SIMD)
+	~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Fuente: simd_fill.h (núcleos generados con la plantilla simd_fill_kernel.h)
+	Motores vectoriales por antidiagonales para llenar matrices de alineamiento, idénticos al llenado con Score().
+::*/
+		int FillAlignMatrixSIMD(A_Matrix *AlignMatrix, const int maximize); // Llena el interior de AlignMatrix con el mejor motor vectorial disponible, 0 si no hay ninguno
+		const char *BestSIMDEngine(void); // Nombre del mejor motor vectorial que soporta el procesador, o NULL
+		void FillAntiDiagAVX2Int16(A_Matrix *AlignMatrix, const int maximize); // Núcleo por antidiagonales con AVX2 y puntajes int16, 16 entradas por instrucción
+		void FillAntiDiagAVX2Int32(A_Matrix *AlignMatrix, const int maximize); // Núcleo por antidiagonales con AVX2 y puntajes int32, 8 entradas por instrucción
+		void FillAntiDiagAVX2Float(A_Matrix *AlignMatrix, const int maximize); // Núcleo por antidiagonales con AVX2 y puntajes float, 8 entradas por instrucción
+		void FillAntiDiagSSE41Int16(A_Matrix *AlignMatrix, const int maximize); // Núcleo por antidiagonales con SSE4.1 y puntajes int16, 8 entradas por instrucción
+		void FillAntiDiagSSE41Int32(A_Matrix *AlignMatrix, const int maximize); // Núcleo por antidiagonales con SSE4.1 y puntajes int32, 4 entradas por instrucción
+		void FillAntiDiagSSE41Float(A_Matrix *AlignMatrix, const int maximize); // Núcleo por antidiagonales con SSE4.1 y puntajes float, 4 entradas por instrucción
+
+
+
+/*
+	~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Llenado paralelo por bloques
+	~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Fuente: tiled_fill.h
+	Llenado de matrices de alineamiento por antidiagonales de bloques repartidos entre varios hilos, idéntico al llenado con Score().
+::*/
+		int FillAlignMatrixTiled(A_Matrix *AlignMatrix, FillBlockKernel fill); // Llena el interior de AlignMatrix por bloques entre varios hilos, 0 si no vale la pena dividirla
+		void FillTileTask(void *tile); // Llena, fila por fila, las entradas de un bloque FillTile
+
+
+
+/*
+	~~~~~~~~~~~~~~~~~~~~~~~~~
+	Alineamiento por bandas
+	~~~~~~~~~~~~~~~~~~~~~~~~~
+	Fuente: banded.h
+	Llenado de sólo las entradas cercanas a la diagonal principal, duplicando la banda mientras el óptimo pueda estar fuera de ella.
+::*/
+		void FillAlignMatrixBanded(A_Matrix *AlignMatrix, FillBlockKernel fill, float (*Compare)(const float *numbers, const int size)); // Llena las entradas de la banda de AlignMatrix, incluidas las orillas
+		int BandHoldsOptimum(const A_Matrix *AlignMatrix, const int maximize); // Verdadero si ningún camino que sale de la banda puede superar el puntaje de la banda
+
+
+
+/*
+	~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Distancia de edición por bits (Myers)
+	~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Fuente: myers.h
+	Distancia de Levenshtein (costos unitarios) por vectores de bits, 64 filas de la matriz por palabra de máquina.
+::*/
+		int UnitCostScores(const char *type, const float *scores); // Verdadero si type es "min" y los costos son unitarios (M=0 y R=I=D>0)
+		int MyersDistance(const char *str1, const char *str2); // La distancia de Levenshtein entre str1 y str2, por bloques de 64 filas
+		int MyersBand(const char *str1, const char *str2); // El semiancho de la banda que contiene a todos los alineamientos óptimos de costo unitario
+
+
+
+/*
+	~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Alineamiento O(ND) por diagonales
+	~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Fuente: ond.h
+	Alineamiento global de costo unitario en tiempo O((m+n)*D) y memoria lineal, por puntos más lejanos en cada diagonal.
+::*/
+		void DiagonalAlignment(const char *str1, const char *str2, const char *type, const float *scores, const AlignOptions *options); // Obtiene e imprime un alineamiento global óptimo de costo unitario en tiempo O((m+n)*D)
+		Align *DiagonalAlign(const char *str1, const char *str2, const float *scores); // Obtiene un alineamiento global óptimo de costo unitario con memoria lineal
+		int FurthestReaching(const char *str1, const int len1, const char *str2, const int len2, const int reverse, const int max_d, int *reach); // Puntos más lejanos por diagonal con hasta max_d ediciones, devuelve la distancia o max_d+1
+		void DiagonalSolve(const char *str1, const int j0, const int j1, const char *str2, const int i0, const int i1, const int d, char *ops); // Camino óptimo de (i0,j0) a (i1,j1) con distancia d, dividido por la mitad de las ediciones
+
+
+
+/*
+	~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Llenado vectorial rayado (alineamiento local)
+	~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Fuente: striped_fill.h (núcleos generados con la plantilla striped_fill_kernel.h)
+	Llenado de matrices de alineamiento local (Smith-Waterman) columna por columna con el método rayado de Farrar y un perfil de Str2.
+::*/
+		int FillAlignMatrixStriped(A_Matrix *AlignMatrix); // Llena el interior de la matriz local AlignMatrix y encuentra su mejor entrada, 0 si no hay motor que sirva
+		void FillStripedAVX2Int16(A_Matrix *AlignMatrix); // Núcleo rayado con AVX2 y puntajes int16, 16 filas por instrucción
+		void FillStripedAVX2Int32(A_Matrix *AlignMatrix); // Núcleo rayado con AVX2 y puntajes int32, 8 filas por instrucción
+		void FillStripedSSE41Int16(A_Matrix *AlignMatrix); // Núcleo rayado con SSE4.1 y puntajes int16, 8 filas por instrucción
+		void FillStripedSSE41Int32(A_Matrix *AlignMatrix); // Núcleo rayado con SSE4.1 y puntajes int32, 4 filas por instrucción
+
+
+
+/*
+	~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Terminación temprana (X-drop)
+	~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Fuente: xdrop.h (núcleos generados con la plantilla xdrop_kernel.h)
+	Llenado de matrices de similaridad que descarta las entradas que caen X por debajo del mejor puntaje (extensión de semillas).
+::*/
+		void FillAlignMatrixXDrop(A_Matrix *AlignMatrix); // Llena la matriz de similaridad AlignMatrix con la terminación X-drop y encuentra la mejor entrada
+		void FillXDropInt16(A_Matrix *AlignMatrix); // Núcleo X-drop con puntajes int16
+		void FillXDropInt32(A_Matrix *AlignMatrix); // Núcleo X-drop con puntajes int32
+		void FillXDropFloat(A_Matrix *AlignMatrix); // Núcleo X-drop con puntajes float
+
+
+
+/*
+	~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Matrices de sustitución
+	~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Fuente: subst_matrix.h
+	Puntajes de apareamiento y reemplazo de una matriz de sustitución (BLOSUM62 o leída de un archivo) y el perfil de Str1 para el llenado.
+::*/
+		S_Matrix *LoadSubstMatrix(const char *name); // La matriz de sustitución incluida con ese nombre o la leída del archivo name, NULL si no se pudo leer
+		S_Matrix *ParseSubstMatrix(const char *text, const char *name); // La matriz de sustitución escrita en text con el formato de NCBI, NULL si no es correcto
+		void FreeSubstMatrix(S_Matrix *subst); // Libera el espacio de una matriz de sustitución
+		void SetSubstMatrix(A_Matrix *AlignMatrix, const S_Matrix *subst); // Usa subst en los apareamientos y reemplazos de AlignMatrix, ajustando el tipo de sus puntajes
+		float PairScore(const A_Matrix *AlignMatrix, const char c1, const char c2); // El puntaje de alinear el caracter c1 de Str1 con el c2 de Str2
+		void BuildProfile(A_Matrix *AlignMatrix); // Calcula el perfil de Str1 contra cada caracter distinto de Str2
+		void FreeProfile(A_Matrix *AlignMatrix); // Libera el perfil de AlignMatrix
 
 # endif
@@ -0,0 +1,129 @@
+# ifndef STRING_ALIGN_BANDED
+# define STRING_ALIGN_BANDED
+/*
+=====================================
+Librería: Alineamiento por bandas.
+=====================================
+
+Llenado de matrices de alineamiento (A_Matrix) por bandas: cuando las cadenas son casi idénticas los alineamientos óptimos
+se alejan poco de la diagonal principal, por lo que basta con calcular (y guardar) las entradas (i,j) con BandLo<=j-i<=BandHi,
+es decir, a distancia a lo más K=Band de las diagonales 0 y n-m (ver AllocBandedAlignMatrix()).
+La memoria y el tiempo son O((K+|n-m|)*m) en lugar de O(m*n).
+
+Los vecinos fuera de la banda no se consideran, por lo que el puntaje de la banda puede ser peor que el óptimo.
+BandHoldsOptimum() acota el puntaje de cualquier camino que sale de la banda, si ninguno puede mejorar el de la banda,
+el puntaje de la banda es el óptimo y los punteros dan todos los alineamientos óptimos dentro de ella;
+si no, FillAlignMatrix() duplica K y vuelve a llenar la matriz.
+
+Las siguientes son las funciones declaradas aquí:
+
+:void FillAlignMatrixBanded(A_Matrix *AlignMatrix, FillBlockKernel fill, float (*Compare)(const float *numbers, const int size)):
+	Llena las entradas de la banda de AlignMatrix, incluidas las orillas: las entradas en los bordes de la banda con Score()
+	(que omite a los vecinos fuera de ella) y el resto de cada fila con el núcleo especializado fill.
+
+:int BandHoldsOptimum(const A_Matrix *AlignMatrix, const int maximize):
+	Verdadero si ningún camino que sale de la banda de AlignMatrix puede superar el puntaje de la última entrada.
+
+
+Los prototipos de las funciones y las estructuras están declarados en el archivo alignments_headers.h
+
+:Autor:
+	Andrés García García @ 28/Feb/'16 (Inicio 19 Oct 2015)
+*/
+
+//Librerías
+# include <stdio.h>
+# include <stdlib.h>
+# include <math.h>//Para usar INFINITY
+# include "alignments_headers.h"
+
+
+/*
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Funciones para el llenado por bandas.
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+
+void FillAlignMatrixBanded(A_Matrix *AlignMatrix, FillBlockKernel fill, float (*Compare)(const float *numbers, const int size))
+/*
+ * Llena las entradas de la banda de AlignMatrix fila por fila. En la fila i la banda va de la columna i+BandLo a la i+BandHi:
+ * la primera entrada no tiene vecino horizontal en la banda y la última no tiene vecino vertical, así que se llenan con Score();
+ * las de en medio tienen sus tres vecinos en la banda y se llenan con el núcleo fill (ver scalar_fill.h).
+ */
+{
+	int rows=(AlignMatrix->Rows), cols=(AlignMatrix->Cols);
+	int lo=(AlignMatrix->BandLo), hi=(AlignMatrix->BandHi);
+	int i, j, first, last;
+	//Condiciones base, sólo dentro de la banda
+	for(i=0; i<rows && -i >= lo; i++)//En la primera columna
+		Score(AlignMatrix, i, 0, Compare);
+	for(j=1; j<cols && j <= hi; j++)//En la primera fila
+		Score(AlignMatrix, 0, j, Compare);
+	for(i=1; i<rows; i++)
+	{
+		first=MAX(1, i+lo), last=MIN(cols-1, i+hi);//Columnas de la fila i dentro de la banda
+		if(first > last)
+			continue;
+		if(first == i+lo)//Borde izquierdo de la banda
+			Score(AlignMatrix, i, first++, Compare);
+		if(last == i+hi && last >= first)//Borde derecho de la banda, se llena al final
+			last--;
+		if(first <= last)
+			fill(AlignMatrix, i, i+1, first, last+1);
+		if(i+hi <= cols-1 && i+hi >= first)
+			Score(AlignMatrix, i, i+hi, Compare);
+	}
+}//___________________________________________________________
+
+
+
+int BandHoldsOptimum(const A_Matrix *AlignMatrix, const int maximize)
+/*
+ * Un camino de (0,0) a (m,n) que sale de la banda toca la diagonal BandHi+1 o la BandLo-1. Para tocar la diagonal e>0 necesita
+ * h>=e pasos horizontales (deleciones), y entonces v=h-(n-m) verticales (inserciones) y n-h diagonales; su puntaje es a lo más
+ * (n-h)*mejor(M,R) + h*D + v*I, lineal en h, así que su mejor valor está en h=e o en h=n (análogamente para la diagonal BandLo-1).
+ * Devuelve verdadero si ninguna de esas cotas es estrictamente mejor que el puntaje de la entrada (m,n) de la banda.
+ */
+{
+#define MM (AlignMatrix->Scores)[0]
+#define R (AlignMatrix->Scores)[1]
+#define I (AlignMatrix->Scores)[2]
+#define D (AlignMatrix->Scores)[3]
+#define BETTER(a, b) (maximize ? (a) > (b) : (a) < (b))
+	int len1=(AlignMatrix->Cols)-1, len2=(AlignMatrix->Rows)-1, diff=len1-len2;
+	if((AlignMatrix->Band) < 0)
+		return 1;//La matriz completa
+	double score=GetValue(AlignMatrix, len2, len1);
+	const S_Matrix *subst=(AlignMatrix->Subst);
+	double diag=(subst != NULL ? (maximize ? (subst->Max) : (subst->Min))//El mejor puntaje de un paso diagonal
+		: (maximize ? MAX(MM, R) : MIN(MM, R)));
+	double bound=(maximize ? -INFINITY : INFINITY), value;
+	int k, steps[2];
+	if((AlignMatrix->BandHi)+1 <= len1)//Caminos que tocan la diagonal BandHi+1
+	{
+		steps[0]=(AlignMatrix->BandHi)+1, steps[1]=len1;//Pasos horizontales
+		for(k=0; k<2; k++)
+		{
+			value=(double)(len1-steps[k])*diag + (double)steps[k]*D + (double)(steps[k]-diff)*I;
+			if(BETTER(value, bound))
+				bound=value;
+		}
+	}
+	if((AlignMatrix->BandLo)-1 >= -len2)//Caminos que tocan la diagonal BandLo-1
+	{
+		steps[0]=1-(AlignMatrix->BandLo), steps[1]=len2;//Pasos verticales
+		for(k=0; k<2; k++)
+		{
+			value=(double)(len2-steps[k])*diag + (double)steps[k]*I + (double)(steps[k]+diff)*D;
+			if(BETTER(value, bound))
+				bound=value;
+		}
+	}
+	return !BETTER(bound, score);
+#undef MM
+#undef R
+#undef I
+#undef D
+#undef BETTER
+}//___________________________________________________________
+# endif
@@ -0,0 +1,307 @@
+# ifndef STRING_ALIGN_BINARY
+# define STRING_ALIGN_BINARY
+/*
+=============================================
+Librería: Registros binarios de alineamientos.
+=============================================
+
+Para corridas con muchos pares sólo se necesitan los índices de las cadenas, el puntaje y las operaciones de edición;
+la salida de texto ocupa unas diez veces más que eso y hay que volver a leerla. Con --format=bin cada alineamiento
+se escribe como un registro binario de tamaño fijo seguido de sus corridas empacadas, de modo que el archivo
+se puede proyectar en memoria (mmap) y recorrer sin leer texto (ver OpenBinFile() y NextBinRecord(), y el programa read-aligns).
+
+Formato, versión 1. Todos los enteros son little-endian y el puntaje es un float IEEE 754 de 32 bits; los campos están alineados
+a 4 bytes y el tamaño de cada registro es múltiplo de 4.
+
+	Encabezado del archivo (BIN_HEADER_SIZE = 16 bytes), escrito antes del primer registro aunque no haya alineamientos:
+		0	char[4]		Magic		"GALN"
+		4	uint16		Version		BIN_VERSION (1)
+		6	uint16		HeaderSize	Bytes del encabezado (16)
+		8	uint16		RecordSize	Bytes de la parte fija de cada registro (40)
+		10	uint16		Reserved	0
+		12	uint32		Reserved	0
+
+	Registro (RecordSize = 40 bytes, seguidos de nRuns corridas de 4 bytes):
+		0	uint32		Number		Número del alineamiento (como en el formato de texto)
+		4	uint32		Id1			Número del registro de Str1 en su archivo con --files, desde 1 (0 para las cadenas de la línea de comandos)
+		8	uint32		Id2			Número del registro de Str2 en su archivo
+		12	float32		Score		Puntaje
+		16	int32		Start1		Str1[Start1..End1) es la parte de Str1 alineada
+		20	int32		End1
+		24	int32		Start2		Str2[Start2..End2) es la parte de Str2 alineada
+		28	int32		End2
+		32	uint32		nRuns		Número de corridas
+		36	uint32		Edits		Columnas que no son apareamientos (R, I y D), como NM:i de SAM
+		40	uint32[nRuns]	Runs	Cada corrida es (longitud << 2) | letra, con la letra M=0, R=1, I=2, D=3 (ver cigar.h)
+
+Un lector debe saltar RecordSize bytes (y no 40) antes de las corridas, de modo que versiones futuras puedan agregar campos
+al final de la parte fija sin cambiar de versión; una versión mayor que BIN_VERSION no se lee.
+
+Esta librería utiliza las siguientes estructuras como base::
+
+		typedef struct BinRecord_struct
+		//Registro binario de un alineamiento (ver binary.h), con su parte fija ya decodificada
+		{
+			uint32_t Number;//Número del alineamiento
+			uint32_t Id1, Id2;//Números de los registros de Str1 y Str2 en sus archivos, desde 1 (0 para las cadenas de la línea de comandos)
+			float Score;
+			int32_t Start1, End1, Start2, End2;//Str1[Start1..End1) y Str2[Start2..End2) son las partes alineadas
+			uint32_t nRuns;//Número de corridas
+			uint32_t Edits;//Columnas que no son apareamientos
+			const unsigned char *Runs;//Las nRuns corridas empacadas, 4 bytes cada una (ver GetBinRun())
+
+		} BinRecord;
+		//___________________________________________________________
+
+
+		typedef struct BinFile_struct
+		//Archivo de registros binarios proyectado en memoria
+		{
+			const unsigned char *Data;//Contenido del archivo (NULL si está vacío)
+			size_t Size;//Bytes del archivo
+			size_t Pos;//Posición del siguiente registro
+			int Version;//Versión del formato del archivo
+			int RecordSize;//Bytes de la parte fija de cada registro
+
+		} BinFile;
+		//___________________________________________________________
+
+
+
+Las siguientes son las funciones declaradas aquí:
+
+:void PutU32(unsigned char *bytes, const uint32_t value):
+	Escribe value en los 4 bytes de bytes, en little-endian.
+
+:uint32_t GetU32(const unsigned char *bytes):
+	Lee el entero little-endian de 4 bytes que empieza en bytes.
+
+:void PackBinHeader(unsigned char *bytes):
+	Escribe el encabezado del archivo en los BIN_HEADER_SIZE bytes de bytes.
+
+:void PackBinRecord(unsigned char *bytes, const BinRecord *record):
+	Escribe la parte fija del registro en los BIN_RECORD_SIZE bytes de bytes.
+
+:uint32_t PackBinRun(const char op, const int len):
+	La corrida empacada de len columnas con la letra op.
+
+:void GetBinRun(const BinRecord *record, const int k, char *op, int *len):
+	La letra y la longitud de la corrida k del registro.
+
+:BinFile *OpenBinFile(const char *name):
+	Proyecta en memoria el archivo de registros name y verifica su encabezado. Devuelve NULL si no se pudo.
+
+:int NextBinRecord(BinFile *file, BinRecord *record):
+	Decodifica el siguiente registro del archivo en record. Devuelve 0 si ya no hay más.
+
+:void CloseBinFile(BinFile *file):
+	Libera la proyección del archivo.
+
+
+Los prototipos de las funciones y las estructuras están declarados en el archivo alignments_headers.h
+
+El empacado de las corridas está basado en el de BAM:
+	*The Sequence Alignment/Map format and SAMtools*
+	Heng Li et al., Bioinformatics 25(16) (2009)
+
+:Autor:
+	Andrés García García @ 28/Feb/'16 (Inicio 19 Oct 2015)
+*/
+
+//Librerías
+# include <stdio.h>
+# include <assert.h>//Para verificar errores con la función assert()
+# include <stdlib.h>//Para usar malloc(), free()
+# include <string.h>//Para usar memcpy() y memcmp()
+# include <fcntl.h>//Para usar open()
+# include <unistd.h>//Para usar close()
+# include <sys/mman.h>//Para usar mmap() y munmap()
+# include <sys/stat.h>//Para usar fstat()
+# include "alignments_headers.h"
+
+
+/*
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Funciones para codificar y leer registros binarios.
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+
+void PutU32(unsigned char *bytes, const uint32_t value)
+/*
+ * Escribe value en bytes[0..3] en little-endian, sin importar el orden de bytes del procesador.
+ */
+{
+	bytes[0]=value & 0xFF, bytes[1]=(value >> 8) & 0xFF, bytes[2]=(value >> 16) & 0xFF, bytes[3]=(value >> 24) & 0xFF;
+}//___________________________________________________________
+
+
+
+uint32_t GetU32(const unsigned char *bytes)
+/*
+ * Devuelve el entero little-endian de 4 bytes que empieza en bytes.
+ */
+{
+	return (uint32_t)bytes[0] | (uint32_t)bytes[1] << 8 | (uint32_t)bytes[2] << 16 | (uint32_t)bytes[3] << 24;
+}//___________________________________________________________
+
+
+
+void PackBinHeader(unsigned char *bytes)
+/*
+ * Escribe en bytes[0..BIN_HEADER_SIZE) el encabezado del archivo: la firma, la versión y los tamaños del encabezado y de los registros.
+ */
+{
+	memcpy(bytes, BIN_MAGIC, 4);
+	PutU32(bytes+4, BIN_VERSION | BIN_HEADER_SIZE << 16);//Version y HeaderSize
+	PutU32(bytes+8, BIN_RECORD_SIZE);//RecordSize y el campo reservado
+	PutU32(bytes+12, 0);
+}//___________________________________________________________
+
+
+
+void PackBinRecord(unsigned char *bytes, const BinRecord *record)
+/*
+ * Escribe en bytes[0..BIN_RECORD_SIZE) la parte fija de record, en el orden del formato (ver el principio del archivo).
+ */
+{
+	uint32_t score;
+	memcpy(&score, &(record->Score), sizeof(score));//Los bits del float
+	PutU32(bytes, (record->Number));
+	PutU32(bytes+4, (record->Id1));
+	PutU32(bytes+8, (record->Id2));
+	PutU32(bytes+12, score);
+	PutU32(bytes+16, (uint32_t)(record->Start1));
+	PutU32(bytes+20, (uint32_t)(record->End1));
+	PutU32(bytes+24, (uint32_t)(record->Start2));
+	PutU32(bytes+28, (uint32_t)(record->End2));
+	PutU32(bytes+32, (record->nRuns));
+	PutU32(bytes+36, (record->Edits));
+}//___________________________________________________________
+
+
+
+uint32_t PackBinRun(const char op, const int len)
+/*
+ * Devuelve la corrida de len columnas con la letra op (M, R, I o D) empacada como (len << 2) | código, con M=0, R=1, I=2 y D=3.
+ */
+{
+	uint32_t code=(op == 'M' ? 0 : (op == 'R' ? 1 : (op == 'I' ? 2 : 3)));
+	return (uint32_t)len << 2 | code;
+}//___________________________________________________________
+
+
+
+void GetBinRun(const BinRecord *record, const int k, char *op, int *len)
+/*
+ * Coloca en op y len la letra (M, R, I o D) y la longitud de la corrida k (0 <= k < nRuns) del registro.
+ */
+{
+	uint32_t run=GetU32((record->Runs) + 4*(size_t)k);
+	(*op)="MRID"[run & 3];
+	(*len)=(int)(run >> 2);
+}//___________________________________________________________
+
+
+
+BinFile *OpenBinFile(const char *name)
+/*
+ * Proyecta en memoria (sólo lectura) el archivo de registros binarios name y verifica su encabezado.
+ * Si no se puede abrir, no es un archivo de registros, su versión es mayor que BIN_VERSION o los tamaños del encabezado no caben
+ * (el encabezado más allá del final del archivo, registros más cortos que BIN_RECORD_SIZE), imprime una advertencia y devuelve NULL.
+ */
+{
+	int fd=open(name, O_RDONLY);
+	struct stat st;
+	if(fd < 0 || fstat(fd, &st) != 0)
+	{
+		printf("\nADVERTENCIA: No se pudo abrir el archivo de registros \"%s\"\n", name);
+		if(fd >= 0)
+			close(fd);
+		return NULL;
+	}
+	BinFile *file=(BinFile *) malloc(sizeof(BinFile));
+	assert(file != NULL);
+	(file->Size)=(size_t)st.st_size, (file->Data)=NULL;
+	if((file->Size) > 0)
+	{
+		void *data=mmap(NULL, (file->Size), PROT_READ, MAP_PRIVATE, fd, 0);
+		(file->Data)=(data == MAP_FAILED ? NULL : (const unsigned char *)data);
+	}
+	close(fd);//La proyección sigue siendo válida
+	if((file->Data) == NULL || (file->Size) < BIN_HEADER_SIZE || memcmp((file->Data), BIN_MAGIC, 4) != 0)
+	{
+		printf("\nADVERTENCIA: \"%s\" no es un archivo de registros binarios\n", name);
+		CloseBinFile(file);
+		return NULL;
+	}
+	(file->Version)=GetU32((file->Data)+4) & 0xFFFF;
+	(file->Pos)=GetU32((file->Data)+4) >> 16;//HeaderSize
+	(file->RecordSize)=GetU32((file->Data)+8) & 0xFFFF;
+	if((file->Version) > BIN_VERSION)
+	{
+		printf("\nADVERTENCIA: \"%s\" tiene la versión %d del formato, sólo se leen hasta la %d\n", name, (file->Version), BIN_VERSION);
+		CloseBinFile(file);
+		return NULL;
+	}
+	if((file->Pos) < BIN_HEADER_SIZE || (file->Pos) > (file->Size))
+	{
+		printf("\nADVERTENCIA: \"%s\" tiene un encabezado de %zu bytes, debe tener entre %d y %zu (los bytes del archivo)\n", name, (file->Pos), BIN_HEADER_SIZE, (file->Size));
+		CloseBinFile(file);
+		return NULL;
+	}
+	if((file->RecordSize) < BIN_RECORD_SIZE)
+	{
+		printf("\nADVERTENCIA: \"%s\" tiene registros de %d bytes, menos que los %d de la parte fija\n", name, (file->RecordSize), BIN_RECORD_SIZE);
+		CloseBinFile(file);
+		return NULL;
+	}
+	return file;
+}//___________________________________________________________
+
+
+
+int NextBinRecord(BinFile *file, BinRecord *record)
+/*
+ * Decodifica en record el registro que empieza en file->Pos y avanza al siguiente. Las corridas no se copian:
+ * record->Runs apunta dentro del archivo. Devuelve 0 (sin cambiar record) si ya no hay registros o el último está incompleto.
+ */
+{
+	if((file->Pos) > (file->Size))
+		return 0;
+	const unsigned char *bytes=(file->Data) + (file->Pos);
+	size_t left=(file->Size) - (file->Pos);
+	if(left < (size_t)(file->RecordSize))
+		return 0;
+	uint32_t score, n_runs=GetU32(bytes+32);
+	if((left - (file->RecordSize))/4 < n_runs)
+		return 0;//Registro truncado
+	(record->Number)=GetU32(bytes);
+	(record->Id1)=GetU32(bytes+4);
+	(record->Id2)=GetU32(bytes+8);
+	score=GetU32(bytes+12);
+	memcpy(&(record->Score), &score, sizeof(score));
+	(record->Start1)=(int32_t)GetU32(bytes+16);
+	(record->End1)=(int32_t)GetU32(bytes+20);
+	(record->Start2)=(int32_t)GetU32(bytes+24);
+	(record->End2)=(int32_t)GetU32(bytes+28);
+	(record->nRuns)=n_runs;
+	(record->Edits)=GetU32(bytes+36);
+	(record->Runs)=bytes + (file->RecordSize);
+	(file->Pos)+=(file->RecordSize) + 4*(size_t)n_runs;
+	return 1;
+}//___________________________________________________________
+
+
+
+void CloseBinFile(BinFile *file)
+/*
+ * Libera la proyección del archivo y la estructura file. file puede ser NULL.
+ */
+{
+	if(file == NULL)
+		return;
+	if((file->Data) != NULL)
+		munmap((void *)(file->Data), (file->Size));
+	free(file);
+}//___________________________________________________________
+# endif
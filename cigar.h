@@ -0,0 +1,253 @@
+# ifndef STRING_ALIGN_CIGAR
+# define STRING_ALIGN_CIGAR
+/*
+===========================================================
+Librería: Representación compacta de alineamientos (CIGAR).
+===========================================================
+
+Un alineamiento explícito (Align) guarda dos cadenas con huecos y su código de edición: 3L caracteres para un alineamiento
+de L columnas, por cada alineamiento óptimo. Las columnas del código de edición casi siempre forman corridas largas de la misma letra,
+así que un alineamiento se puede guardar como sus corridas (como el CIGAR del formato SAM), p. ej. 5M1I3M2D:
+cinco apareamientos, una inserción, tres apareamientos y dos eliminaciones. Las letras son las del código de edición (ver EditOp()),
+M (apareamiento), R (reemplazo), I (inserción, hueco en Str1) y D (eliminación, hueco en Str2), por lo que el alineamiento
+completo se puede volver a armar desde las cadenas originales (ver AlignFromCigar()) sólo cuando se imprime.
+
+El iterador de alineamientos (ver AllocAlignIterator()) arma las corridas directamente desde su pila (ver CigarFromStack())
+y con la opción --cigar se imprimen sin armar las cadenas con huecos.
+
+Esta librería utiliza las siguientes estructuras como base::
+
+		typedef struct Align_struct
+		//Estructura que contiene un alineamiento explícito de dos textos
+		{
+			float Score;
+			char *Align1;
+			char *Align2;
+			char *EditTr;//Código de edición; las tres cadenas están en un solo bloque que empieza en Align1 (ver AllocExplAlign())
+
+		} Align;
+		//___________________________________________________________
+
+
+		typedef struct Cigar_struct
+		//Alineamiento compacto: las corridas de su código de edición (como el CIGAR de SAM, p. ej. 5M1I3M2D)
+		{
+			float Score;
+			int Start1, Start2;//Posición de Str1 y de Str2 donde empieza el alineamiento (0 en los globales)
+			int nRuns;//Número de corridas
+			int Size;//Corridas alojadas
+			int *Lengths;//Longitud de cada corrida
+			char *Ops;//Letra de cada corrida: M, R, I o D (ver EditOp())
+
+		} Cigar;
+		//___________________________________________________________
+
+
+
+Las siguientes son las funciones declaradas aquí:
+
+:void AllocCigar(Cigar *cigar, const int size):
+	Aloja espacio para size corridas (crece conforme se necesita) en un CIGAR vacío.
+
+:void AddCigarRun(Cigar *cigar, const char op, const int len):
+	Agrega len columnas con la letra op al final del CIGAR, alargando la última corrida si tiene la misma letra.
+
+:void CigarFromExplAlign(const Align *align, Cigar *cigar):
+	Coloca en cigar las corridas del código de edición del alineamiento explícito align.
+
+:int CigarLength(const Cigar *cigar):
+	Número de columnas del alineamiento.
+
+:void CigarSpan(const Cigar *cigar, int *len1, int *len2):
+	Número de caracteres de Str1 y de Str2 que cubre el alineamiento.
+
+:void AlignFromCigar(const Cigar *cigar, const char *str1, const char *str2, Align *align):
+	Arma en align (alojado con AllocExplAlign() con al menos CigarLength(cigar) columnas) las cadenas con huecos y el código de edición.
+
+:void PrintCigar(Writer *out, const Cigar *cigar):
+	Escribe en out el CIGAR en una línea (p. ej. "CIGAR:	5M1I3M2D") y dónde empieza el alineamiento si no es en el principio de las cadenas.
+
+:void PrintCigarNumber(Writer *out, const Cigar *cigar, const int number):
+	Escribe en out un alineamiento compacto con su número y su puntaje, en lugar de PrintAlignNumber().
+
+:void FreeCigar(Cigar *cigar):
+	Libera las corridas del CIGAR (pero no la estructura cigar).
+
+
+Los prototipos de las funciones y las estructuras están declarados en el archivo alignments_headers.h
+
+El formato está basado en:
+	*The Sequence Alignment/Map format and SAMtools*
+	Heng Li et al., Bioinformatics 25(16) (2009)
+
+:Autor:
+	Andrés García García @ 28/Feb/'16 (Inicio 19 Oct 2015)
+*/
+
+//Librerías
+# include <stdio.h>
+# include <assert.h>//Para verificar errores con la función assert()
+# include <stdlib.h>//Para usar malloc(), realloc(), free()
+# include <string.h>//Para usar strlen()
+# include "alignments_headers.h"
+
+
+/*
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Funciones para alineamientos compactos (CIGAR).
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+
+void AllocCigar(Cigar *cigar, const int size)
+/*
+ * Aloja espacio para size corridas (al menos una) en un CIGAR vacío, con puntaje 0 y que empieza en el principio de las cadenas.
+ * AddCigarRun() duplica el espacio cuando se llena, así que size sólo es una estimación.
+ */
+{
+	(cigar->Size)=(size > 0 ? size : 1);
+	(cigar->Lengths)=(int *) malloc((cigar->Size) * sizeof(int));
+	(cigar->Ops)=(char *) malloc((cigar->Size) * sizeof(char));
+	assert((cigar->Lengths) != NULL && (cigar->Ops) != NULL);
+	(cigar->nRuns)=0, (cigar->Score)=0, (cigar->Start1)=0, (cigar->Start2)=0;
+}//___________________________________________________________
+
+
+
+void AddCigarRun(Cigar *cigar, const char op, const int len)
+/*
+ * Agrega len columnas con la letra op (M, R, I o D) al final del CIGAR: alarga la última corrida si tiene la misma letra
+ * o agrega una nueva, duplicando el espacio si hace falta.
+ */
+{
+#define N_RUNS (cigar->nRuns)
+	if(N_RUNS > 0 && (cigar->Ops)[N_RUNS-1] == op)
+	{
+		(cigar->Lengths)[N_RUNS-1]+=len;
+		return;
+	}
+	if(N_RUNS == (cigar->Size))
+	{
+		(cigar->Size)*=2;
+		(cigar->Lengths)=(int *) realloc((cigar->Lengths), (cigar->Size) * sizeof(int));
+		(cigar->Ops)=(char *) realloc((cigar->Ops), (cigar->Size) * sizeof(char));
+		assert((cigar->Lengths) != NULL && (cigar->Ops) != NULL);
+	}
+	(cigar->Lengths)[N_RUNS]=len, (cigar->Ops)[N_RUNS]=op;
+	N_RUNS++;
+#undef N_RUNS
+}//___________________________________________________________
+
+
+
+void CigarFromExplAlign(const Align *align, Cigar *cigar)
+/*
+ * Coloca en cigar (ya alojado) las corridas del código de edición de align y su puntaje; el alineamiento empieza en el principio de las cadenas.
+ */
+{
+	int k, len=strlen(align->Align1);
+	(cigar->nRuns)=0, (cigar->Score)=(align->Score), (cigar->Start1)=0, (cigar->Start2)=0;
+	for(k=0; k<len; k++)
+		AddCigarRun(cigar, ((align->EditTr) != NULL ? (align->EditTr)[k] : EditOp((align->Align1)[k], (align->Align2)[k])), 1);
+}//___________________________________________________________
+
+
+
+int CigarLength(const Cigar *cigar)
+/*
+ * Devuelve el número de columnas del alineamiento: la suma de las longitudes de sus corridas.
+ */
+{
+	int k, len=0;
+	for(k=0; k<(cigar->nRuns); k++)
+		len+=(cigar->Lengths)[k];
+	return len;
+}//___________________________________________________________
+
+
+
+void CigarSpan(const Cigar *cigar, int *len1, int *len2)
+/*
+ * Coloca en len1 y len2 el número de caracteres de Str1 y de Str2 que cubre el alineamiento: Str1[Start1..Start1+len1)
+ * y Str2[Start2..Start2+len2). I no toma caracteres de Str1 y D no los toma de Str2.
+ */
+{
+	int k;
+	(*len1)=0, (*len2)=0;
+	for(k=0; k<(cigar->nRuns); k++)
+	{
+		if((cigar->Ops)[k] != 'I')
+			(*len1)+=(cigar->Lengths)[k];
+		if((cigar->Ops)[k] != 'D')
+			(*len2)+=(cigar->Lengths)[k];
+	}
+}//___________________________________________________________
+
+
+
+void AlignFromCigar(const Cigar *cigar, const char *str1, const char *str2, Align *align)
+/*
+ * Arma en align las cadenas con huecos y el código de edición del alineamiento compacto cigar de str1 y str2,
+ * empezando en str1[Start1] y str2[Start2]. align debe tener espacio para CigarLength(cigar) columnas (ver AllocExplAlign()).
+ * Las letras M y R toman un caracter de cada cadena, I sólo de str2 y D sólo de str1; el código de edición se calcula
+ * de las columnas con EditOp(), igual que en los demás alineamientos.
+ */
+{
+	int r, n, k=0, i=(cigar->Start2), j=(cigar->Start1);
+	for(r=0; r<(cigar->nRuns); r++)
+		for(n=0; n<(cigar->Lengths)[r]; n++, k++)
+			switch((cigar->Ops)[r])
+			{
+				case 'I'://Inserción de una letra en Str1
+					SetAlignColumn(align, k, '_', str2[i++]);
+					break;
+				case 'D'://Eliminación de una letra de Str1
+					SetAlignColumn(align, k, str1[j++], '_');
+					break;
+				default ://Coincidencia o reemplazo
+					SetAlignColumn(align, k, str1[j++], str2[i++]);
+			}
+	EndExplAlign(align, k);
+	(align->Score)=(cigar->Score);
+}//___________________________________________________________
+
+
+
+void PrintCigar(Writer *out, const Cigar *cigar)
+/*
+ * Escribe en out el CIGAR en una línea, en el mismo formato que PrintEditTr(): "CIGAR:	5M1I3M2D".
+ * Si el alineamiento no empieza en el principio de las cadenas (alineamientos locales o X-drop) escribe en otra línea dónde empieza.
+ */
+{
+	int k;
+	WriteStr(out, "CIGAR:\t");
+	for(k=0; k<(cigar->nRuns); k++)
+		WriteInt(out, (cigar->Lengths)[k]), WriteChar(out, (cigar->Ops)[k]);
+	WriteChar(out, '\n');
+	if((cigar->Start1) != 0 || (cigar->Start2) != 0)
+		WriteFormat(out, "Inicio:\tStr1[%d], Str2[%d]\n", (cigar->Start1), (cigar->Start2));
+}//___________________________________________________________
+
+
+
+void PrintCigarNumber(Writer *out, const Cigar *cigar, const int number)
+/*
+ * Escribe en out el alineamiento compacto cigar con su número y su puntaje, como PrintAlignNumber() pero sin las cadenas con huecos.
+ */
+{
+	WriteFormat(out, "\nAlineamiento número %d:\n", number);
+	WriteFormat(out, "Score:\t%f\n", (cigar->Score));
+	PrintCigar(out, cigar);
+}//___________________________________________________________
+
+
+
+void FreeCigar(Cigar *cigar)
+/*
+ * Libera las corridas del CIGAR (pero no la estructura cigar).
+ */
+{
+	free(cigar->Lengths);
+	free(cigar->Ops);
+	(cigar->Lengths)=NULL, (cigar->Ops)=NULL, (cigar->nRuns)=0, (cigar->Size)=0;
+}//___________________________________________________________
+# endif
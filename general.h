@@ -19,8 +19,9 @@ Las siguientes son las funciones declaradas aquí:
 :void swap(char *s, const int a, const int b):
 	Intercambia los valores s[a] y s[b] en la cadena de texto str.
 
-:void insert(const char c, const int pos, char *s):
+:char *insert(const char c, const int pos, char *s):
 	Inserta el caracter c en la cadena de texto str, de tal manera que str[pos]=c, los otros valores se recorren al final de la cadena.
+	Devuelve la cadena, que puede haber cambiado de lugar al hacer espacio.
 
 :float *getNum(const char *str, const int pos):
 	Obtiene el valor numérico en la cadena str desde la posición pos, además de la posición del siguiente caracter no numérico.
@@ -34,6 +35,9 @@ Las siguientes son las funciones declaradas aquí:
 :char *getVal(const char *str):
 	str es una declaración de variable de la forma "--variable=valor". Obtiene "valor".
 
+:int hasArg(char *arg_name, char ***args):
+	Verdadero (1) si la variable arg_name fué declarada en args, aunque no tenga valor (p. ej. "--score-only").
+
 :int equStr(const char *str1, const char *str2):
 	Verdadero (1) si str1 es igual a str2.
 
@@ -43,6 +47,21 @@ char *dupStr(const char *ref_str):
 void copyStr(char *copy, const char *ref_str):
 	Copia la cadena de referencia ref_str a copy, caracter por caracter, asume que hay espacio suficiente en copy.
 
+:unsigned long long randNext(unsigned long long *state):
+	Devuelve el siguiente número pseudoaleatorio de 64 bits del generador SplitMix64 con estado (semilla) state, que avanza.
+
+:double randUnit(unsigned long long *state):
+	Devuelve un número pseudoaleatorio uniforme en [0,1) con 53 bits, a partir de randNext().
+
+:Arena *allocArena(const size_t block_size):
+	Genera una arena vacía: un alojador que entrega espacio recorriendo un apuntador dentro de bloques de block_size bytes.
+
+:void *arenaAlloc(Arena *arena, const size_t bytes):
+	Entrega bytes bytes de la arena, alineados a 16, en tiempo O(1). El espacio no se libera por separado.
+
+:void freeArena(Arena *arena):
+	Libera la arena junto con todo el espacio que entregó, de una sola vez.
+
 Los prototipos de las funciones y las estructuras están declarados en el archivo alignments_headers.h
 
 :Autor:
@@ -101,25 +120,26 @@ void swap(char *s, const int a, const int b)
 
 
 
-void insert(const char c, const int pos, char *s)
+char *insert(const char c, const int pos, char *s)
 /*
  * Inserta el caracter c en la posición pos de s (resulta en s[pos]=s y recorre los demás caracteres a la derecha)
  * Sólo funciona con strings alojadas con malloc(), calloc() o strcpy().
+ * Devuelve la cadena resultante, que debe usarse en lugar de s porque realloc() puede cambiarla de lugar.
  */
 {
 	int i=strlen(s)+1; // El tamaño de s
-	s = (char *) realloc(s, (i+1)*sizeof(char)); // Pon espacio en s para un caracter más
-	s[i+1] = '\0'; // Pon el caractér final
+	s = (char *) realloc(s, (i+1)*sizeof(char)); // Pon espacio en s para un caracter más, el caracter final se recorre con los demás
 	for(; i > pos; i--)
 		swap(s, i, i-1);//Recorre uno a uno los caracteres hacia la izquierda para insertar el nuevo
 	s[i]=c;//Inserta el nuevo caracter
+	return s;
 }//___________________________________________________________
 
 
 
 float *getNum(const char *str, const int pos)
 /*
- * Obtiene el número entero decimal especificado en la cadena str comenzando desde la posición i.
+ * Obtiene el número decimal (con o sin parte fraccionaria) especificado en la cadena str comenzando desde la posición i.
  * Devuelve un arreglo donde la primera entrada es dicho número y la segunda es la posición siguiente de donde termina el número.
  * Ejemplo: getNum("abc123def", 3)={123,6}
  */
@@ -141,15 +161,12 @@ float *getNum(const char *str, const int pos)
 
 	if(str[i]=='.')//Checa si hay una parte fraccionaria
 	{
-		int j;
-		for(j=1; '0'<=str[i+j] && str[i+j]<='9';j++)//Obtén el valor absoluto de la parte decimal
+		double place=1;
+		for(i++; '0'<=str[i] && str[i]<='9';i++)//Obtén el valor absoluto de la parte decimal
 		{
-			dec*=10;
-			dec+=str[i+j]-'0';
+			place/=10;
+			dec+=(str[i]-'0')*place;
 		}
-		for(; j>=0; j--)//Recorre el punto decimal
-			dec/=10;
-		i += j; // La posición siguiente
 	}
 
 	num[0]=(sum+dec)*sign;//Coloca el valor numérico con signo
@@ -230,6 +247,20 @@ char *searchArg(char *arg_name, char ***args)
 }//____________________________________________
 
 
+int hasArg(char *arg_name, char ***args)
+// Verdadero (1) si la variable arg_name fué declarada entre las variables contenidas en args.
+// Sirve para opciones sin valor, como "--score-only", para las que searchArg() devuelve NULL.
+{
+   int i;
+   for(i=0; args[i] != NULL; i++)
+   {
+	   if(equStr(args[i][0], arg_name))
+		   return 1;
+   }
+   return 0;
+}//____________________________________________
+
+
  char ***getArgs(char **argv, const int argc)
 /*
  * De la lista de strings argv con argc cadenas, obtiene las variables declaradas como "--var=val".
@@ -289,6 +320,7 @@ int equStr(const char *str1, const char *str2)
 	}
 	if(str2[i]=='\0')
 		return 1;
+	return 0;//str1 es sólo un prefijo de str2
 }//___________________________________________________________
 
 
@@ -317,4 +349,87 @@ void copyStr(char *copy, const char *ref_str)
 	copy[i] = '\0';
 }//___________________________________________________________
 
+
+
+
+unsigned long long randNext(unsigned long long *state)
+/*
+ * Generador SplitMix64: avanza el estado una constante fija y mezcla el resultado. Cualquier semilla (incluso 0) sirve.
+ * Es reproducible en cualquier plataforma, a diferencia de rand().
+ */
+{
+	unsigned long long z=((*state)+=0x9E3779B97F4A7C15ULL);
+	z=(z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z=(z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}//___________________________________________________________
+
+
+
+double randUnit(unsigned long long *state)
+/*
+ * Número pseudoaleatorio uniforme en [0,1): los 53 bits altos de randNext() (la precisión de un double).
+ */
+{
+	return (double)(randNext(state) >> 11) * (1.0 / 9007199254740992.0);
+}//___________________________________________________________
+
+
+#define ARENA_ALIGN 16 //Alineación del espacio entregado por arenaAlloc()
+#define ARENA_HEADER ((sizeof(ArenaBlock) + ARENA_ALIGN-1) & ~(size_t)(ARENA_ALIGN-1)) //Bytes del encabezado de cada bloque
+Arena *allocArena(const size_t block_size)
+/*
+ * Genera una arena vacía, sin bloques. Cada bloque que aloje tendrá block_size bytes de datos, o más si una petición no cabe.
+ */
+{
+	Arena *arena=(Arena *) malloc(sizeof(*arena));
+	assert(arena != NULL);
+	(arena->Blocks)=NULL;
+	(arena->BlockSize)=block_size;
+	return arena;
+}//___________________________________________________________
+
+
+
+void *arenaAlloc(Arena *arena, const size_t bytes)
+/*
+ * Entrega bytes bytes de la arena, alineados a ARENA_ALIGN, recorriendo el apuntador del bloque actual.
+ * Si no caben en el bloque actual aloja un bloque nuevo (de arena->BlockSize bytes, o de bytes si es mayor) y lo pone al frente de la lista;
+ * lo que sobró del bloque anterior ya no se usa. El espacio entregado no está inicializado y sólo se libera con freeArena().
+ */
+{
+	size_t size=(bytes + ARENA_ALIGN-1) & ~(size_t)(ARENA_ALIGN-1);
+	ArenaBlock *block=(arena->Blocks);
+	if(block == NULL || (block->Used) + size > (block->Size))
+	{
+		size_t block_size=((arena->BlockSize) > size ? (arena->BlockSize) : size);
+		block=(ArenaBlock *) malloc(ARENA_HEADER + block_size);
+		assert(block != NULL);
+		(block->Next)=(arena->Blocks), (block->Size)=block_size, (block->Used)=0;
+		(arena->Blocks)=block;
+	}
+	void *data=(char *)block + ARENA_HEADER + (block->Used);
+	(block->Used)+=size;
+	return data;
+}//___________________________________________________________
+
+
+
+void freeArena(Arena *arena)
+/*
+ * Libera todos los bloques de la arena y la arena misma.
+ */
+{
+	ArenaBlock *block=(arena->Blocks), *next;
+	while(block != NULL)
+	{
+		next=(block->Next);
+		free(block);
+		block=next;
+	}
+	free(arena);
+}//___________________________________________________________
+#undef ARENA_ALIGN
+#undef ARENA_HEADER
+
 # endif
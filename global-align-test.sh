@@ -1,7 +1,8 @@
 # /usr/bin/env bash
 
-# Compile the program
-gcc global-align.c -o global-align
+# Compile the program and the reader of its binary records
+gcc global-align.c -o global-align -pthread
+gcc read-aligns.c -o read-aligns
 
 # Hand it a simple input
 echo "Handling a simple input..."
@@ -11,5 +12,95 @@ echo "Handling a simple input..."
 echo "Same input, different parameters..."
 ./global-align vintners writers --scores=M-10I10D10R5 --type=min
 
+# Only the optimal score, in linear memory
+echo "Score only..."
+./global-align vintners writers --scores=M20I-1D-1R-1 --type=max --score-only
+./global-align vintners writers --scores=M20I-1D-1R-1 --type=max --score-only --format=tsv
+
+# One optimal alignment in linear memory
+echo "Hirschberg..."
+./global-align vintners writers --scores=M20I-1D-1R-1 --type=max --method=hirschberg --threads=2
+
+# Scalar fill engine with timing statistics
+echo "Scalar engine..."
+./global-align vintners writers --scores=M20I-1D-1R-1 --type=max --engine=scalar --stats
+
+# Multi-threaded tiled fill (same alignments as the single-threaded fill)
+echo "Tiled engine..."
+./global-align vintners writers --scores=M20I-1D-1R-1 --type=max --engine=tiled --threads=2
+
+# Banded alignment, the band is doubled until it holds the optimum
+echo "Banded..."
+./global-align vintners writers --scores=M20I-1D-1R-1 --type=max --band=0 --stats
+
+# Unit costs: Levenshtein distance by bit vectors, then only the band that holds every optimal alignment
+echo "Unit costs..."
+./global-align vintners writers --scores=M0I1D1R1 --type=min --stats
+
+# One unit-cost alignment in O((m+n)D) time
+echo "O(ND)..."
+./global-align vintners writers --scores=M0I1D1R1 --type=min --method=ond
+
+# Local alignment: every optimal alignment of the best-scoring substrings
+echo "Local..."
+./global-align vintners writers --scores=M2I-1D-1R-1 --type=max --align=local --stats
+
+# Substitution matrix: protein local alignment scored with the built-in BLOSUM62
+echo "BLOSUM62..."
+./global-align HEAGAWGHEE PAWHEAE --scores=I-8D-8 --type=max --align=local --matrix=BLOSUM62 --stats
+
+# X-drop: extend from the start and stop once every cell falls X below the best
+echo "X-drop..."
+./global-align vintners writers --scores=M2I-1D-1R-1 --type=max --xdrop=3 --stats
+
+# Count the co-optimal alignments without building them
+echo "Count only..."
+./global-align AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA AAAAAAAAAAAAAAAAAAAA --scores=M0I1D1R1 --type=min --count-only
+
+# Print only the first few of them
+echo "Max alignments..."
+./global-align AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA AAAAAAAAAAAAAAAAAAAA --scores=M0I1D1R1 --type=min --max-alignments=3
+
+# Draw a few of them uniformly at random
+echo "Sample..."
+./global-align AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA AAAAAAAAAAAAAAAAAAAA --scores=M0I1D1R1 --type=min --sample=3 --seed=7
+
+# Large input: the C(2000,1000) co-optimal paths overflow a double, so the path counts are rescaled row by row
+echo "Sample, large input..."
+long1=$(printf 'A%.0s' $(seq 2000)); long2=$(printf 'A%.0s' $(seq 1000))
+echo "Samples that do not end in a deletion (about half of 20): $(./global-align $long1 $long2 --scores=M0I1D1R1 --type=min --sample=20 --cigar | grep '^CIGAR' | grep -vc 'D$')"
+
+# Print them as CIGAR runs instead of gapped strings
+echo "CIGAR..."
+./global-align AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA AAAAAAAAAAAAAAAAAAAA --scores=M0I1D1R1 --type=min --max-alignments=3 --cigar
+
+# Collect every path first, as a tree of shared nodes taken from an arena
+echo "Tree traceback..."
+./global-align vintners writers --scores=M20I-1D-1R-1 --type=max --traceback=tree --stats
+# The tree must give the same alignments, in the same order, as the iterator
+for args in "--type=max" "--type=max --align=local --scores=M2I-1D-1R-1 --cigar" "--type=min --scores=M0I1D1R1 --format=tsv"
+do
+	if [ "$(./global-align vintners writers $args 2>&1)" = "$(./global-align vintners writers $args --traceback=tree 2>&1)" ]
+	then echo "Tree traceback matches the iterator ($args)"
+	else echo "MISMATCH: tree traceback differs from the iterator ($args)"
+	fi
+done
+
+# Write them as one-line records for other tools
+echo "Formats..."
+./global-align vintners writers --scores=M20I-1D-1R-1 --type=max --format=tsv
+./global-align vintners writers --scores=M20I-1D-1R-1 --type=max --align=local --format=sam
+./global-align vintners writers --scores=M20I-1D-1R-1 --type=max --format=bin > aligns.bin && ./read-aligns aligns.bin && ./read-aligns aligns.bin --summary
+rm -f aligns.bin
+
+# Read the strings from FASTA/FASTQ files, every record against every record
+echo "Files..."
+printf ">v\nvintners\n>w\nwri\nters\n" > strings.fa
+./global-align strings.fa strings.fa --files --scores=M20I-1D-1R-1 --type=max --format=tsv
+# An empty record ("e", with its sequence 0..0) and Windows line endings
+printf ">e x\r\n\r\n>w\r\nwri\r\nters\r\n" > crlf.fa
+./global-align crlf.fa strings.fa --files --scores=M20I-1D-1R-1 --type=max --format=tsv --max-alignments=1
+rm -f strings.fa crlf.fa
+
 # Give it a more complex input
 #global-align TTTTGAGGTGCAGATAGCTTGCTTTATTTTGTTGTTACTATCTCAAGGA GAGACAGAGTCTCACTCTGTTGCACAGGCTGGAGTGCAGTGGCACAATC --scores=M-10I10D10R5 --type=min
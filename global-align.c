@@ -4,7 +4,7 @@ Proyecto: Alineamiento de cadenas (string-align)
 ================================================
 
 Implementación de alineamiento local y global en C.
-Hasta ahora sólo se han implementado los alineamientos locales.
+Se han implementado los alineamientos globales y, con `--align=local`, los locales.
 
  - Compilar:
  	```
@@ -12,7 +12,7 @@ Hasta ahora sólo se han implementado los alineamientos locales.
  	```
     o bien, con:
  	```
-	gcc global-align.c -o global-align
+	gcc global-align.c -o global-align -pthread
  	```
 
  - Ejecutar:
@@ -45,8 +45,6 @@ Hasta ahora sólo se han implementado los alineamientos locales.
 
  - Próximos cambios:
   * Mejorar documentación.
-  * Posibilidad de añadir las cadenas desde archivos externos.
-  * Implementar alineamientos locales.
 
 
 Funcionalidad
@@ -60,12 +58,85 @@ Funcionalidad
 
 - ¡¡¡Imprime **todos** los alineamientos óptimos junto con las cadenas de edición asociadas!!!
 
+- Con la opción `--score-only` sólo calcula el puntaje óptimo, conservando una sola fila de la matriz (memoria lineal).
+
+- Con la opción `--method=hirschberg` obtiene un solo alineamiento óptimo con memoria lineal (algoritmo de Hirschberg),
+  repartiendo los subproblemas entre `--threads=N` hilos (por defecto, todos los procesadores).
+
+- La matriz se llena por antidiagonales con instrucciones vectoriales (AVX2 o SSE4.1) si el procesador las soporta,
+  `--engine=scalar` fuerza el llenado escalar y `--stats` imprime el motor usado y su rendimiento en GCUPS.
+
+- Los puntajes de la matriz se guardan como enteros de 16 o 32 bits (el tipo más angosto que no se desborda)
+  si todos los costos son enteros, o como float si no, lo que reduce la memoria y duplica el ancho de los vectores.
+
+- Las matrices grandes se llenan por bloques entre `--threads=N` hilos (por antidiagonales de bloques),
+  con los mismos puntajes y punteros que el llenado de un solo hilo.
+
+- Con la opción `--band=K` sólo se calculan las entradas a distancia a lo más K de la diagonal principal,
+  duplicando K mientras el óptimo pueda estar fuera de la banda; se imprimen todos los alineamientos óptimos dentro de ella.
+
+- Con costos unitarios (`--type=min` y `M0R1I1D1`) la distancia de Levenshtein se calcula por vectores de bits (algoritmo de Myers)
+  y sólo se llena la banda que contiene a todos los alineamientos óptimos (también acelera `--score-only`).
+
+- Con la opción `--method=ond` y costos unitarios obtiene un solo alineamiento óptimo en tiempo O((m+n)*D) y memoria lineal
+  (puntos más lejanos por diagonal), ideal cuando la distancia D es muy pequeña comparada con la longitud de las cadenas.
+
+- Con la opción `--align=local` obtiene todos los alineamientos locales óptimos (Smith-Waterman) que terminan en la mejor entrada de la matriz,
+  llenada columna por columna con el método vectorial rayado de Farrar (perfil de la segunda cadena, SSE4.1 o AVX2).
+
+- Con la opción `--xdrop=X` y `--type=max` la matriz se llena con la terminación X-drop (extensión de semillas): se descartan
+  las entradas cuyo puntaje cae X por debajo del mejor y el llenado termina cuando ya no hay entradas vivas. Se imprimen las mejores
+  extensiones (alineamientos de prefijos que terminan en la mejor entrada) y cuántas entradas se omitieron, para ajustar X.
+
+- Con la opción `--matrix=ARCHIVO` los apareamientos y reemplazos se califican con una matriz de sustitución en lugar de M y R:
+  `--matrix=BLOSUM62` (incluida) o cualquier matriz en el formato de NCBI, como PAM250. Los núcleos leen los puntajes de un perfil
+  de la primera cadena calculado una sola vez. Sólo se usa con el método `matrix` (alineamientos globales, locales, por bandas o X-drop).
+
+- Los alineamientos óptimos se imprimen conforme se obtienen, con memoria O(m+n) además de la matriz. Con la opción `--count-only`
+  sólo se imprime cuántos son (en tiempo O(mn), con enteros de 128 bits), para saber si conviene imprimirlos antes de hacerlo.
+  Con la opción `--max-alignments=N` se imprimen a lo más N y, si hay más, se indica que la lista se truncó y cuántos son en total.
+  Con la opción `--sample=K` (y `--seed=S`) se imprimen K alineamientos óptimos elegidos al azar con probabilidad uniforme:
+  se cuentan los caminos desde cada entrada y cada alineamiento se elige en tiempo O(m+n).
+
+- Con la opción `--cigar` cada alineamiento se imprime como las corridas de su código de edición (CIGAR, p. ej. `1R1I1M1D1M1D3M`),
+  armadas directamente desde los punteros, sin las cadenas con huecos; en los locales se indica dónde empieza en cada cadena.
+
+- Con la opción `--traceback=tree` se obtienen primero todos los caminos óptimos, como un árbol de nodos compartidos que salen
+  de una arena y se liberan de una sola vez, y después se imprimen en el mismo orden que con el iterador (`--traceback=iterator`,
+  por defecto); con `--stats` se indica cuántos nodos ocupó el árbol.
+
+- Con la opción `--format=tsv`, `jsonl` o `sam` cada alineamiento se escribe como un registro de una línea (número, nombres,
+  coordenadas, puntaje y CIGAR) en la salida estándar; los encabezados y mensajes se imprimen en la salida de errores.
+  Toda la salida de los alineamientos se junta en un búfer y se escribe por bloques de 1 MiB.
+  Con `--format=bin` los registros son binarios, de tamaño fijo y con las corridas empacadas (ver binary.h), para proyectarse
+  en memoria sin analizar texto; el programa read-aligns los lee.
+
+- Con la opción `--files` los dos primeros argumentos son archivos FASTA o FASTQ y se alinea cada registro del primero contra
+  cada registro del segundo, con sus nombres en los registros de salida (y sus números en los binarios). Los archivos se proyectan
+  en memoria y los registros se separan en su lugar, sin copiar las secuencias (ver seq_file.h); las matrices y los traceback
+  tampoco las copian.
+
 
 El programa utiliza las funciones de las siguientes librerias:
 - **general.h**
 - **alignment_matrix.h**
 - **traceback.h**
-- **alignment.h**, todas las anteriores se incluyen mediante el archivo de declaraciones **alignments_headers.h**
+- **alignment.h**
+- **cigar.h**
+- **writer.h**
+- **binary.h**
+- **seq_file.h**
+- **thread_pool.h**
+- **hirschberg.h**
+- **scalar_fill.h**
+- **simd_fill.h**
+- **tiled_fill.h**
+- **banded.h**
+- **myers.h**
+- **ond.h**
+- **striped_fill.h**
+- **xdrop.h**
+- **subst_matrix.h**, todas las anteriores se incluyen mediante el archivo de declaraciones **alignments_headers.h**
 
 Autor
 -----
@@ -75,16 +146,34 @@ Autor
 
 # include <stdio.h>
 # include <assert.h>//Para verificar errores con la función assert()
+# include <unistd.h>//Para usar dup() y dup2()
 //Incluye las librerías de alineamiento de secuencias
 # include "alignments_headers.h"
 # include "general.h"
 # include "alignment_matrix.h"
 # include "traceback.h"
 # include "alignment.h"
+# include "cigar.h"
+# include "writer.h"
+# include "binary.h"
+# include "seq_file.h"
+# include "thread_pool.h"
+# include "hirschberg.h"
+# include "scalar_fill.h"
+# include "simd_fill.h"
+# include "tiled_fill.h"
+# include "banded.h"
+# include "myers.h"
+# include "ond.h"
+# include "striped_fill.h"
+# include "xdrop.h"
+# include "subst_matrix.h"
 
 
 #define DEFAULT_TYPE "max"
 #define DEFAULT_SCORES "M20I-1D-1R-1"
+#define DEFAULT_METHOD "matrix"
+#define DEFAULT_ALIGN "global"
 
 //===============>> INICIO DE FUNCIÓN MAIN <<=====================
 
@@ -95,16 +184,32 @@ void main(int argc, char *argv[])
 	if( argc < 3 )//Debe llamarse con 2 argumentos mínimo!!!
 	{
 		printf("\nPara llamar el programa escriba en la terminal:\n");
-		printf("%s <texto1> <texto2> [--scores='M<#M>R<#R>I<#I>D<#D>'] [--type=(min | max)]\n", argv[0]);
+		printf("%s <texto1> <texto2> [--scores='M<#M>R<#R>I<#I>D<#D>'] [--type=(min | max)] [--score-only] [--method=(matrix | hirschberg | ond)] [--threads=N] [--engine=(auto | scalar | simd | sse4.1 | tiled)] [--stats] [--band=K] [--align=(global | local)] [--xdrop=X] [--matrix=(BLOSUM62 | ARCHIVO)] [--count-only] [--max-alignments=N] [--sample=K [--seed=S]] [--cigar] [--traceback=(iterator | tree)] [--format=(text | tsv | jsonl | sam | bin)] [--files]\n", argv[0]);
 		printf("Ejemplo: %s vintners writers --scores=M20I-1D-1R-1 --type=max\n\n", argv[0]);
 		return;
 	}
 
-	// Obten las secuencias de texto, estas siempre son los dos primeros argumentos.
-	char *string1=argv[1], *string2=argv[2];
+	// Obten las secuencias de texto, estas siempre son los dos primeros argumentos (o los archivos de donde se leen, con --files).
+	const char *string1=argv[1], *string2=argv[2];
 	 // Obten las variables de la línea de comandos
 	char ***args = getArgs(argv, argc);
 
+	// Obtén el formato de salida antes de imprimir cualquier cosa: en los formatos de registros sólo éstos van a la salida estándar
+	char *format_str = searchArg("format", args);
+	int format = (format_str == NULL ? FORMAT_TEXT : ParseFormat(format_str)), out_fd = STDOUT_FILENO;
+	if(format < 0)
+	{
+		printf("\nADVERTENCIA: Formato de salida desconocido \"%s\", se ha usado el formato \"text\"\n", format_str);
+		format = FORMAT_TEXT;
+	}
+	if(format != FORMAT_TEXT)
+	{
+		fflush(stdout);
+		out_fd = dup(STDOUT_FILENO);//Los registros van a la salida estándar original
+		dup2(STDERR_FILENO, STDOUT_FILENO);//Y todo lo que se imprime con printf() a la salida de errores
+	}
+	Writer *out = AllocWriter(out_fd, format);
+
 	// Obtén el tipo de matriz
 	char *type = searchArg("type", args);
     if (type == NULL) 
@@ -126,12 +231,131 @@ void main(int argc, char *argv[])
         scores_str = DEFAULT_SCORES;
     }
     scores = getScores(scores_str);
+
+	// Verifica si sólo se requiere el puntaje óptimo
+	int score_only = hasArg("score-only", args);
+
+	// Obtén el método de alineamiento: matriz completa (todos los alineamientos óptimos) o Hirschberg (uno, con memoria lineal)
+	char *method = searchArg("method", args);
+	method = dupStr(method == NULL ? DEFAULT_METHOD : method);
+
+	// Obtén el tipo de alineamiento: global (las cadenas completas) o local (las subcadenas con el mejor puntaje)
+	char *align = searchArg("align", args);
+	align = dupStr(align == NULL ? DEFAULT_ALIGN : align);
+	if(!equStr(align, "global") && !equStr(align, "local"))
+		printf("\nADVERTENCIA: Tipo de alineamiento desconocido \"%s\", se ha usado el tipo por defecto \"%s\"\n", align, DEFAULT_ALIGN);
+
+	// Obtén el número de hilos, 0 para usar todos los procesadores
+	char *threads_str = searchArg("threads", args);
+	int threads = (threads_str == NULL ? 0 : atoi(threads_str));
+
+	// Obtén las opciones del llenado de la matriz
+	AlignOptions options;
+	char *engine = searchArg("engine", args);
+	options.Engine = (engine == NULL || equStr(engine, "auto") ? NULL : dupStr(engine));//Por defecto, se elige automáticamente
+	options.Threads = threads;//Hilos para el llenado por bloques de matrices grandes
+	options.Stats = hasArg("stats", args);//Imprime el motor de llenado y su rendimiento
+	char *band_str = searchArg("band", args);
+	options.Band = (band_str == NULL ? -1 : atoi(band_str));//Por defecto, la matriz completa
+	if(options.Band >= 0 && equStr(align, "local"))
+	{
+		printf("\nADVERTENCIA: La banda sólo se usa con el alineamiento global, se ha llenado la matriz completa\n");
+		options.Band = -1;
+	}
+	char *xdrop_str = searchArg("xdrop", args);
+	options.XDrop = (xdrop_str == NULL ? -1 : atof(xdrop_str));//Por defecto, sin terminación X-drop
+	if(options.XDrop >= 0 && (equStr(align, "local") || !equStr(type, "max")))
+	{
+		printf("\nADVERTENCIA: La terminación X-drop sólo se usa con el alineamiento global de similaridad (--type=max), se ha llenado la matriz completa\n");
+		options.XDrop = -1;
+	}
+	char *matrix_str = searchArg("matrix", args);
+	S_Matrix *subst = (matrix_str == NULL ? NULL : LoadSubstMatrix(matrix_str));//Por defecto, M y R
+	options.Subst = subst;
+	if(subst != NULL && (score_only || !equStr(method, "matrix")))
+	{
+		printf("\nADVERTENCIA: La matriz de sustitución sólo se usa con el método \"matrix\", se ha usado ese método\n");
+		score_only = 0;
+		method = "matrix";
+	}
+	options.CountOnly = hasArg("count-only", args);//Sólo el número de alineamientos óptimos
+	char *max_str = searchArg("max-alignments", args);
+	options.MaxAligns = (max_str == NULL ? 0 : atoi(max_str));//Por defecto, todos los alineamientos óptimos
+	char *sample_str = searchArg("sample", args), *seed_str = searchArg("seed", args);
+	options.Sample = (sample_str == NULL ? 0 : atoi(sample_str));//Por defecto, sin muestreo
+	options.Seed = (seed_str == NULL ? 1 : strtoull(seed_str, NULL, 10));//Por defecto, una semilla fija (reproducible)
+	options.CigarOnly = hasArg("cigar", args);//Imprime los alineamientos como sus corridas (CIGAR), sin las cadenas con huecos
+	char *traceback_str = searchArg("traceback", args);
+	options.TreeTraceback = (traceback_str != NULL && equStr(traceback_str, "tree"));//Por defecto, el iterador
+	if(traceback_str != NULL && !options.TreeTraceback && !equStr(traceback_str, "iterator"))
+		printf("\nADVERTENCIA: Traceback desconocido \"%s\", se ha usado el iterador\n", traceback_str);
+	if(options.TreeTraceback && (options.CountOnly || options.MaxAligns > 0 || options.Sample > 0))
+	{
+		printf("\nADVERTENCIA: El traceback en árbol obtiene todos los caminos, con --count-only, --max-alignments o --sample se ha usado el iterador\n");
+		options.TreeTraceback = 0;
+	}
+	options.Out = out;//Salida con búfer de los alineamientos, en el formato elegido
+	if(options.CountOnly && (score_only || !equStr(method, "matrix")))
+	{
+		printf("\nADVERTENCIA: Los alineamientos óptimos sólo se cuentan con el método \"matrix\", se ha usado ese método\n");
+		score_only = 0;
+		method = "matrix";
+	}
     
 
+	int from_files = hasArg("files", args);//Los dos primeros argumentos son archivos FASTA o FASTQ
 	freeArgs(args); // Libera el espacio que no necesitas
 
+	if(!equStr(align, "local") && !score_only && !equStr(method, "hirschberg") && !equStr(method, "ond") && !equStr(method, "matrix"))
+	{
+		printf("\nADVERTENCIA: Método de alineamiento desconocido \"%s\", se ha usado el método por defecto \"%s\"\n", method, DEFAULT_METHOD);
+		method = DEFAULT_METHOD;
+	}
+
+	// Con --files las cadenas son los registros de dos archivos FASTA o FASTQ, proyectados en memoria sin copiarlos
+	SeqFile *file1 = NULL, *file2 = NULL;
+	int n1 = 1, n2 = 1, s1, s2;
+	if(from_files)
+	{
+		file1 = LoadSeqFile(argv[1]);
+		file2 = LoadSeqFile(argv[2]);
+		if(file1 == NULL || file2 == NULL)
+			n1 = 0, n2 = 0;//No hay nada que alinear
+		else
+			n1 = (file1->nSeqs), n2 = (file2->nSeqs);
+		if(format == FORMAT_SAM && n1 > 0)
+			WriteSamHeader(out, (file1->Seqs), n1);//Todos los registros del primer archivo son referencias
+	}
+
 	//____________________Operaciones___________________________
-	GlobalAlignment(string1, string2, type, scores);
+	for(s1=0; s1<n1; s1++)
+		for(s2=0; s2<n2; s2++)//Cada registro del primer archivo contra cada registro del segundo
+		{
+			if(from_files)
+			{
+				string1 = (file1->Seqs)[s1].Seq, string2 = (file2->Seqs)[s2].Seq;
+				(out->Name1) = (file1->Seqs)[s1].Name, (out->Name2) = (file2->Seqs)[s2].Name;
+				(out->Id1) = s1+1, (out->Id2) = s2+1;
+				printf("\nRegistros:\t%s (%d de %s) contra %s (%d de %s)\n", (out->Name1), s1+1, argv[1], (out->Name2), s2+1, argv[2]);
+			}
+			if(equStr(align, "local"))
+				LocalAlignment(string1, string2, type, scores, &options);//Todos los alineamientos locales óptimos desde la mejor entrada
+			else if(score_only)
+				GlobalAlignmentScore(string1, string2, type, scores, &options);//Sólo el puntaje, con memoria lineal
+			else if(equStr(method, "hirschberg"))
+				HirschbergAlignment(string1, string2, type, scores, &options);//Un alineamiento óptimo, con memoria lineal
+			else if(equStr(method, "ond"))
+				DiagonalAlignment(string1, string2, type, scores, &options);//Un alineamiento óptimo de costo unitario, en tiempo O((m+n)*D)
+			else
+				GlobalAlignment(string1, string2, type, scores, &options);
+		}
+
+	FreeSeqFile(file1);
+	FreeSeqFile(file2);
+	FreeSubstMatrix(subst);
+	FreeWriter(out);
+	if(out_fd != STDOUT_FILENO)
+		close(out_fd);
 
 	//_____________________Resultados____________________________
 	return;
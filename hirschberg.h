@@ -0,0 +1,269 @@
+# ifndef STRING_ALIGN_HIRSCHBERG
+# define STRING_ALIGN_HIRSCHBERG
+/*
+==========================================
+Librería: Alineamiento de Hirschberg.
+==========================================
+
+Obtiene un alineamiento global óptimo con memoria lineal O(m+n) por medio del algoritmo de divide y vencerás de Hirschberg.
+En lugar de guardar la matriz de alineamiento completa, se calcula la fila media de la matriz hacia adelante y hacia atrás,
+se elige la columna por donde pasa un camino óptimo y se resuelven los dos subproblemas (independientes) resultantes.
+Los subproblemas se reparten entre los hilos de un ThreadPool, cada uno escribe su parte del camino en regiones disjuntas de un mismo arreglo.
+
+Esta librería utiliza las siguientes estructuras como base::
+
+		typedef struct Hirschberg_struct
+		// Datos compartidos por todos los subproblemas de un alineamiento de Hirschberg
+		{
+			const char *Str1;
+			const char *Str2;
+			const char *Type;
+			const float *Scores;
+			int Maximize;//Verdadero si es alineamiento por similaridad (max)
+			char *Ops;//Ops[i+j] es el puntero que llega a la entrada (i,j) del camino óptimo, o 0 si el camino no pasa por la antidiagonal i+j
+			ThreadPool *Pool;//Hilos entre los que se reparten los subproblemas (NULL para resolverlos en el hilo actual)
+
+		} Hirschberg;
+		//___________________________________________________________
+
+
+		typedef struct HirschbergTask_struct
+		// Subproblema: alinear Str2[I0..I1) con Str1[J0..J1)
+		{
+			Hirschberg *H;
+			int I0, J0;
+			int I1, J1;
+
+		} HirschbergTask;
+		//___________________________________________________________
+
+
+Las siguientes son las funciones declaradas aquí:
+
+:void HirschbergAlignment(const char *str1, const char *str2, const char *type, const float *scores, const AlignOptions *options):
+	Obtiene e imprime un alineamiento global óptimo de str1 y str2 con memoria lineal, usando threads hilos (0 para todos los procesadores).
+
+:Align *HirschbergAlign(const char *str1, const char *str2, const char *type, const float *scores, const int threads):
+	Obtiene un alineamiento global óptimo de str1 y str2 con memoria lineal.
+	Devuelve un arreglo de alineamientos con un solo elemento, terminado por un alineamiento nulo (como ExplAlignsFromTraceback()).
+
+:void HirschbergRow(const char *str1, const int len1, const char *str2, const int len2, const int reverse, const int maximize, const float *scores, float *row):
+	Calcula la última fila de la matriz de alineamiento de str2 (filas) contra str1 (columnas), ambas leídas al revés si reverse.
+
+:void HirschbergSolve(void *task):
+	Resuelve el subproblema task (un HirschbergTask), dividiéndolo en dos subproblemas o resolviéndolo directamente si es pequeño.
+
+:void HirschbergBase(Hirschberg *h, const int i0, const int j0, const int i1, const int j1):
+	Resuelve un subproblema pequeño con una matriz de alineamiento completa y copia el primer camino óptimo en h->Ops.
+
+
+Los prototipos de las funciones y las estructuras están declarados en el archivo alignments_headers.h
+
+Los algoritmos están basados en los encontrados en el libro:
+	*Algoritms on Strings, Trees and Sequences-Computer Science and Computational Biology*
+	Dan Gusfield
+	Cambridge University Press (1997)
+
+:Autor:
+	Andrés García García @ 28/Feb/'16 (Inicio 19 Oct 2015)
+*/
+
+//Librerías
+# include <stdio.h>
+# include <assert.h>//Para verificar errores con la función assert()
+# include <stdlib.h>//Para usar malloc(), calloc(), realloc(), free()
+# include <string.h>//Para usar strlen() y strndup()
+# include "alignments_headers.h"
+//Definiciones globales
+#define HIRSCHBERG_BASE_CELLS 4096 //Los subproblemas con a lo más estas entradas se resuelven con una matriz completa
+#define HIRSCHBERG_TASK_CELLS 65536 //Los subproblemas con al menos estas entradas se envían a otro hilo
+
+
+/*
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Funciones para el alineamiento de Hirschberg.
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+
+void HirschbergAlignment(const char *str1, const char *str2, const char *type, const float *scores, const AlignOptions *options)
+/*
+ * A partir de las cadenas, costos y el tipo de alineamiento, obtiene e imprime un alineamiento global óptimo con memoria lineal.
+ * De options sólo se usan Threads (los hilos de HirschbergAlign()), CigarOnly y Out (ver PrintAlignments()); puede ser NULL para usar todos los procesadores.
+ */
+{
+	PrintAlignHeader("Alineamiento Global (Hirschberg).", str1, str2, type, scores);
+
+	Align *aligns=HirschbergAlign(str1, str2, type, scores, (options != NULL ? (options->Threads) : 0));
+	PrintAlignments(aligns, str1, str2, options);
+	FreeAligns(aligns);
+}//___________________________________________________________
+
+
+
+Align *HirschbergAlign(const char *str1, const char *str2, const char *type, const float *scores, const int threads)
+/*
+ * Obtiene un alineamiento global óptimo de str1 y str2 con memoria O(m+n).
+ * Si threads!=1, los subproblemas grandes se reparten entre threads hilos (0 para usar todos los procesadores).
+ * Devuelve un arreglo con un solo alineamiento, terminado por un alineamiento nulo.
+ */
+{
+	int len1=strlen(str1), len2=strlen(str2);
+	Hirschberg h;
+	h.Str1=str1, h.Str2=str2, h.Type=type, h.Scores=scores;
+	h.Maximize=equStr(type, "max");
+	h.Ops=(char *) calloc(len1+len2+1, sizeof(char));//Un puntero por cada antidiagonal
+	assert(h.Ops != NULL);
+	h.Pool=(threads == 1 ? NULL : AllocThreadPool(threads));
+
+	//Resuelve el problema completo, los subproblemas grandes se encolan en h.Pool
+	HirschbergTask *task=(HirschbergTask *) malloc(sizeof(*task));
+	assert(task != NULL);
+	task->H=&h, task->I0=0, task->J0=0, task->I1=len2, task->J1=len1;
+	HirschbergSolve(task);
+	PoolWait(h.Pool);
+	FreeThreadPool(h.Pool);
+
+	Align *aligns=ExplAlignFromOps(str1, str2, scores, h.Ops);//Compacta los punteros del camino y calcula su puntaje
+	free(h.Ops);
+	return aligns;
+}//___________________________________________________________
+
+
+
+void HirschbergRow(const char *str1, const int len1, const char *str2, const int len2, const int reverse, const int maximize, const float *scores, float *row)
+/*
+ * Calcula la última fila de la matriz de alineamiento global de str2 (filas, longitud len2) contra str1 (columnas, longitud len1).
+ * Si reverse es verdadero ambas cadenas se leen de derecha a izquierda, de modo que row[j] es el puntaje
+ * de alinear str2 con los últimos j caracteres de str1.
+ * row debe tener espacio para len1+1 entradas. Sólo se conserva esa fila, la memoria usada es O(len1).
+ */
+{
+#define S1(j) (reverse ? str1[len1-(j)] : str1[(j)-1])
+#define S2(i) (reverse ? str2[len2-(i)] : str2[(i)-1])
+#define MM scores[0]
+#define R scores[1]
+#define I scores[2]
+#define D scores[3]
+	float diag, up, best;
+	char c2;
+	int i, j;
+	for(j=0; j<=len1; j++)//Condición base de la primera fila
+		row[j]=j*D;
+#define FILL_ROWS(BEST)\
+	for(i=1; i<=len2; i++)\
+	{\
+		diag=row[0];\
+		row[0]=i*I;/*Condición base de la primera columna*/\
+		c2=S2(i);\
+		for(j=1; j<=len1; j++)\
+		{\
+			up=row[j];\
+			best=diag + (S1(j)!=c2 ? R : MM);\
+			best=BEST(best, up + I);\
+			best=BEST(best, row[j-1] + D);\
+			diag=up;\
+			row[j]=best;\
+		}\
+	}
+	if(maximize)
+		FILL_ROWS(MAX)
+	else
+		FILL_ROWS(MIN)
+#undef FILL_ROWS
+#undef S1
+#undef S2
+#undef MM
+#undef R
+#undef I
+#undef D
+}//___________________________________________________________
+
+
+
+void HirschbergSolve(void *arg)
+/*
+ * Resuelve el subproblema arg (un HirschbergTask alojado con malloc(), que se libera aquí).
+ * Calcula la fila media hacia adelante y hacia atrás, elige la columna donde se cruzan con el mejor puntaje
+ * y resuelve los dos subproblemas a cada lado de esa entrada, en otro hilo si son suficientemente grandes.
+ */
+{
+	HirschbergTask *task=(HirschbergTask *) arg;
+	Hirschberg *h=task->H;
+	int i0=task->I0, j0=task->J0, i1=task->I1, j1=task->J1;
+	int rows=i1-i0, cols=j1-j0;
+	free(task);
+
+	//Los subproblemas pequeños o de una sola fila/columna se resuelven directamente
+	if(rows <= 1 || cols <= 1 || (long)(rows+1)*(cols+1) <= HIRSCHBERG_BASE_CELLS)
+	{
+		HirschbergBase(h, i0, j0, i1, j1);
+		return;
+	}
+
+	//Calcula la fila media desde ambos extremos
+	int imid=i0+rows/2, j, jmid;
+	float *fwd=(float *) malloc((cols+1) * sizeof(float));
+	float *rev=(float *) malloc((cols+1) * sizeof(float));
+	assert(fwd != NULL && rev != NULL);
+	HirschbergRow((h->Str1)+j0, cols, (h->Str2)+i0, imid-i0, 0, h->Maximize, h->Scores, fwd);
+	HirschbergRow((h->Str1)+j0, cols, (h->Str2)+imid, i1-imid, 1, h->Maximize, h->Scores, rev);
+
+	//Elige la columna por donde pasa un camino óptimo (la primera en caso de empate)
+	float best=fwd[0]+rev[cols], value;
+	for(j=1, jmid=0; j<=cols; j++)
+	{
+		value=fwd[j]+rev[cols-j];
+		if(h->Maximize ? value > best : value < best)
+			best=value, jmid=j;
+	}
+	jmid+=j0;
+	free(fwd);
+	free(rev);
+
+	//Resuelve los dos subproblemas, escriben en regiones disjuntas de h->Ops
+	HirschbergTask *left=(HirschbergTask *) malloc(sizeof(*left));
+	HirschbergTask *right=(HirschbergTask *) malloc(sizeof(*right));
+	assert(left != NULL && right != NULL);
+	left->H=h, left->I0=i0, left->J0=j0, left->I1=imid, left->J1=jmid;
+	right->H=h, right->I0=imid, right->J0=jmid, right->I1=i1, right->J1=j1;
+	if((long)rows*cols >= HIRSCHBERG_TASK_CELLS)
+		PoolSubmit(h->Pool, HirschbergSolve, left);//Si h->Pool es NULL se resuelve aquí mismo
+	else
+		HirschbergSolve(left);
+	HirschbergSolve(right);
+}//___________________________________________________________
+
+
+
+void HirschbergBase(Hirschberg *h, const int i0, const int j0, const int i1, const int j1)
+/*
+ * Resuelve el subproblema Str2[i0..i1) contra Str1[j0..j1) con una matriz de alineamiento completa
+ * y copia en h->Ops los punteros del primer camino óptimo (prefiriendo diagonal, vertical y horizontal, en ese orden).
+ */
+{
+	char *sub1=strndup((h->Str1)+j0, j1-j0), *sub2=strndup((h->Str2)+i0, i1-i0);
+	assert(sub1 != NULL && sub2 != NULL);
+	A_Matrix *AlignMatrix=AllocAlignMatrix(sub1, sub2, h->Type, "global", h->Scores);
+	FillAlignMatrix(AlignMatrix);
+	PackTraceback(AlignMatrix, i1-i0, j1-j0);//Sólo se necesitan los punteros
+
+	int i=i1-i0, j=j1-j0;
+	char pointer;
+	while((pointer=NthPointer(GetPointers(AlignMatrix, i, j), 0)) != '\0')
+	{
+		(h->Ops)[(i0+i)+(j0+j)]=pointer;//El puntero que llega a la entrada (i,j)
+		if(pointer == '\\')
+			i--, j--;
+		else if(pointer == '|')
+			i--;
+		else
+			j--;
+	}
+	FreeAlignMatrix(AlignMatrix);
+	free(sub1);
+	free(sub2);
+}//___________________________________________________________
+#undef HIRSCHBERG_BASE_CELLS
+#undef HIRSCHBERG_TASK_CELLS
+
+# endif
@@ -0,0 +1,147 @@
+# ifndef STRING_ALIGN_MYERS
+# define STRING_ALIGN_MYERS
+/*
+==================================================
+Librería: Distancia de edición por bits (Myers).
+==================================================
+
+Con costos unitarios (M=0 y R=I=D, los costos por default de getScores()) y matriz de distancia (min), el alineamiento global
+es la distancia de Levenshtein, que se calcula con el algoritmo de vectores de bits de Myers (1999): cada columna de la matriz se
+representa con las diferencias verticales entre entradas consecutivas (+1, 0 o -1), guardadas como dos máscaras de bits Pv y Mv,
+y se calcula a partir de la anterior con unas cuantas operaciones de bits, 64 filas por palabra de máquina.
+Si la cadena de las filas es más larga que 64 se divide en bloques de 64 filas (variante por bloques de Hyyrö), cada bloque
+le pasa al de abajo la diferencia horizontal de su última fila. El tiempo es O(n*ceil(m/64)) y la memoria O(m/64).
+
+La distancia sirve para acotar la banda de la matriz (ver banded.h): ningún alineamiento que sale de la banda de semiancho
+MyersBand() puede ser óptimo, por lo que GlobalAlignment() llena sólo esa banda y obtiene los mismos alineamientos que con la matriz completa.
+
+Las siguientes son las funciones declaradas aquí:
+
+:int UnitCostScores(const char *type, const float *scores):
+	Verdadero si type es "min" y los costos scores son unitarios (M=0 y R=I=D>0), es decir, si el alineamiento es la distancia de Levenshtein.
+
+:int MyersDistance(const char *str1, const char *str2):
+	La distancia de Levenshtein entre str1 y str2, por el algoritmo de vectores de bits de Myers (por bloques de 64 filas).
+
+:int MyersBand(const char *str1, const char *str2):
+	El semiancho de la banda (ver AllocBandedAlignMatrix()) que contiene a todos los alineamientos óptimos de costo unitario de str1 y str2.
+
+
+Los prototipos de las funciones y las estructuras están declarados en el archivo alignments_headers.h
+
+Los algoritmos están basados en:
+	*A fast bit-vector algorithm for approximate string matching based on dynamic programming*
+	Gene Myers, Journal of the ACM 46(3) (1999)
+	*Explaining and extending the bit-parallel approximate string matching algorithm of Myers*
+	Heikki Hyyrö, Technical report A2001-10, University of Tampere (2001)
+
+:Autor:
+	Andrés García García @ 28/Feb/'16 (Inicio 19 Oct 2015)
+*/
+
+//Librerías
+# include <stdio.h>
+# include <assert.h>//Para verificar errores con la función assert()
+# include <stdlib.h>//Para usar malloc(), calloc(), free()
+# include <string.h>//Para usar strlen()
+# include <stdint.h>//Para usar uint64_t
+# include "alignments_headers.h"
+//Definiciones globales
+#define MYERS_WORD 64 //Filas por palabra de máquina
+
+
+/*
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Funciones para la distancia de edición por bits.
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+
+int UnitCostScores(const char *type, const float *scores)
+/*
+ * Verdadero si la matriz es de distancia (type es "min") y los costos scores=[M, R, I, D] son M=0 y R=I=D>0.
+ * Entonces el puntaje de un alineamiento es R veces su número de reemplazos, inserciones y deleciones.
+ */
+{
+	return type != NULL && scores != NULL && equStr(type, "min")
+		&& scores[0] == 0 && scores[1] > 0 && scores[1] == scores[2] && scores[1] == scores[3];
+}//___________________________________________________________
+
+
+
+int MyersDistance(const char *str1, const char *str2)
+/*
+ * Calcula la distancia de Levenshtein entre str1 y str2 columna por columna. La cadena más corta va en las filas (es simétrica),
+ * dividida en bloques de MYERS_WORD filas. Para cada bloque b y caracter c, peq[c*blocks + b] tiene encendidos los bits de las filas
+ * con el caracter c. Pv y Mv tienen encendidos los bits de las filas cuya diferencia vertical es +1 y -1.
+ * Como D(0,j)=j, la diferencia horizontal que entra al primer bloque es siempre +1; la de la última fila
+ * (el bit de la última fila del último bloque) se suma a la distancia D(m,j).
+ */
+{
+	const char *pattern=str1, *text=str2;
+	if(strlen(str1) > strlen(str2))
+		pattern=str2, text=str1;//La cadena más corta en las filas
+	int m=strlen(pattern), n=strlen(text);
+	if(m == 0)
+		return n;
+	int blocks=(m + MYERS_WORD-1)/MYERS_WORD, last_bit=(m-1) % MYERS_WORD;
+	uint64_t *peq=(uint64_t *) calloc((size_t)256 * blocks, sizeof(uint64_t));
+	uint64_t *pv=(uint64_t *) malloc(blocks * sizeof(uint64_t));
+	uint64_t *mv=(uint64_t *) malloc(blocks * sizeof(uint64_t));
+	assert(peq != NULL && pv != NULL && mv != NULL);
+	int i, j, b, hin, hout, top, distance=m;//D(m,0)=m
+	for(i=0; i<m; i++)
+		peq[(unsigned char)pattern[i]*blocks + i/MYERS_WORD] |= (uint64_t)1 << (i % MYERS_WORD);
+	for(b=0; b<blocks; b++)
+		pv[b]=~(uint64_t)0, mv[b]=0;//D(i,0)=i, todas las diferencias verticales son +1
+
+	uint64_t eq, xv, xh, ph, mh;
+	const uint64_t *column;
+	for(j=0; j<n; j++)
+	{
+		column=peq + (unsigned char)text[j]*blocks;
+		hin=1;//D(0,j)-D(0,j-1)
+		for(b=0; b<blocks; b++)
+		{
+			eq=column[b];
+			xv=eq | mv[b];
+			if(hin < 0)
+				eq|=1;
+			xh=(((eq & pv[b]) + pv[b]) ^ pv[b]) | eq;
+			ph=mv[b] | ~(xh | pv[b]);//Diferencias horizontales +1
+			mh=pv[b] & xh;//Diferencias horizontales -1
+			top=(b == blocks-1 ? last_bit : MYERS_WORD-1);//Última fila del bloque
+			hout=(int)((ph >> top) & 1) - (int)((mh >> top) & 1);
+			ph<<=1, mh<<=1;
+			if(hin < 0)
+				mh|=1;
+			else if(hin > 0)
+				ph|=1;
+			pv[b]=mh | ~(xv | ph);
+			mv[b]=ph & xv;
+			hin=hout;
+		}
+		distance+=hin;//D(m,j)-D(m,j-1)
+	}
+
+	free(peq);
+	free(pv);
+	free(mv);
+	return distance;
+}//___________________________________________________________
+
+
+
+int MyersBand(const char *str1, const char *str2)
+/*
+ * Con costos unitarios, un camino que toca la diagonal max(0,n-m)+K+1 o min(0,n-m)-K-1 tiene al menos |n-m|+2K+2 inserciones
+ * y deleciones. Con K=(D-|n-m|)/2 eso es más que la distancia D, así que todos los alineamientos óptimos quedan dentro de la banda.
+ */
+{
+	int diff=(int)strlen(str1) - (int)strlen(str2);
+	if(diff < 0)
+		diff=-diff;
+	int band=(MyersDistance(str1, str2) - diff)/2;
+	return (band > 0 ? band : 0);
+}//___________________________________________________________
+#undef MYERS_WORD
+# endif
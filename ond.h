@@ -0,0 +1,241 @@
+# ifndef STRING_ALIGN_OND
+# define STRING_ALIGN_OND
+/*
+=============================================
+Librería: Alineamiento O(ND) por diagonales.
+=============================================
+
+Alineamiento global con costos unitarios (distancia de Levenshtein) en tiempo O((m+n)*D) y memoria lineal, donde D es la distancia:
+cuando las cadenas son muy parecidas (D mucho menor que m+n), casi toda la matriz de alineamiento es trabajo desperdiciado.
+
+Se usa el algoritmo de puntos más lejanos por diagonal (Ukkonen, Myers): para cada número de ediciones d y cada diagonal k=j-i,
+F(d,k) es la fila más lejana de la diagonal k a la que se llega con d ediciones. F(d,k) se obtiene de F(d-1,k-1), F(d-1,k) y F(d-1,k+1)
+con una edición más y luego se extiende por la diagonal mientras los caracteres coincidan (las coincidencias no cuestan).
+La distancia es el primer d con el que se llega a la entrada (m,n). Sólo se conservan los puntos de d-1 y d, memoria O(D).
+
+Para recuperar un alineamiento óptimo con memoria lineal se divide el problema (como en el algoritmo de Hirschberg):
+se calculan los puntos más lejanos hacia adelante con ceil(D/2) ediciones y hacia atrás (con las cadenas al revés) con floor(D/2).
+En alguna diagonal ambos se traslapan; el punto donde empieza el de atrás está en un camino óptimo, y se resuelven los dos
+subproblemas a cada lado de él, con distancias ceil(D/2) y floor(D/2).
+
+Las siguientes son las funciones declaradas aquí:
+
+:void DiagonalAlignment(const char *str1, const char *str2, const char *type, const float *scores, const AlignOptions *options):
+	Obtiene e imprime un alineamiento global óptimo de costo unitario de str1 y str2 en tiempo O((m+n)*D) y memoria lineal.
+	Si los costos no son unitarios usa el alineamiento de Hirschberg (también con memoria lineal).
+
+:Align *DiagonalAlign(const char *str1, const char *str2, const float *scores):
+	Obtiene un alineamiento global óptimo de costo unitario de str1 y str2 con memoria lineal.
+	Devuelve un arreglo de alineamientos con un solo elemento, terminado por un alineamiento nulo (como ExplAlignsFromTraceback()).
+
+:int FurthestReaching(const char *str1, const int len1, const char *str2, const int len2, const int reverse, const int max_d, int *reach):
+	Calcula los puntos más lejanos por diagonal con hasta max_d ediciones (con las cadenas al revés si reverse).
+	Devuelve la distancia si es a lo más max_d, o max_d+1 si no; en reach[k+max_d] deja la fila más lejana de la diagonal k con max_d ediciones.
+
+:void DiagonalSolve(const char *str1, const int j0, const int j1, const char *str2, const int i0, const int i1, const int d, char *ops):
+	Coloca en ops un camino óptimo de la entrada (i0,j0) a la (i1,j1), cuya distancia es d, dividiéndolo en dos por la mitad de las ediciones.
+
+
+Los prototipos de las funciones y las estructuras están declarados en el archivo alignments_headers.h
+
+Los algoritmos están basados en:
+	*Algorithms for approximate string matching*
+	Esko Ukkonen, Information and Control 64 (1985)
+	*An O(ND) difference algorithm and its variations*
+	Eugene W. Myers, Algorithmica 1 (1986)
+
+:Autor:
+	Andrés García García @ 28/Feb/'16 (Inicio 19 Oct 2015)
+*/
+
+//Librerías
+# include <stdio.h>
+# include <assert.h>//Para verificar errores con la función assert()
+# include <stdlib.h>//Para usar malloc(), free()
+# include <string.h>//Para usar strlen() y memset()
+# include "alignments_headers.h"
+//Definiciones globales
+#define NO_REACH (-1) //Diagonal a la que no se llega
+
+
+/*
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Funciones para el alineamiento por diagonales.
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+
+void DiagonalAlignment(const char *str1, const char *str2, const char *type, const float *scores, const AlignOptions *options)
+/*
+ * A partir de las cadenas, costos y el tipo de alineamiento, obtiene e imprime un alineamiento global óptimo con memoria lineal.
+ * El algoritmo por diagonales sólo sirve para costos unitarios (ver UnitCostScores()), si no, se usa el de Hirschberg (con un solo hilo).
+ * De options sólo se usan CigarOnly y Out (ver PrintAlignments()); puede ser NULL.
+ */
+{
+	if(!UnitCostScores(type, scores))
+	{
+		printf("\nADVERTENCIA: El método por diagonales requiere --type=min y costos unitarios (M0 y R=I=D), se ha usado el método \"hirschberg\"\n");
+		AlignOptions single;
+		memset(&single, 0, sizeof(single));
+		if(options != NULL)
+			single.CigarOnly=(options->CigarOnly), single.Out=(options->Out);
+		single.Threads=1;
+		HirschbergAlignment(str1, str2, type, scores, &single);
+		return;
+	}
+	PrintAlignHeader("Alineamiento Global (O(ND) por diagonales).", str1, str2, type, scores);
+
+	Align *aligns=DiagonalAlign(str1, str2, scores);
+	PrintAlignments(aligns, str1, str2, options);
+	FreeAligns(aligns);
+}//___________________________________________________________
+
+
+
+Align *DiagonalAlign(const char *str1, const char *str2, const float *scores)
+/*
+ * Obtiene un alineamiento global óptimo de costo unitario de str1 y str2 en tiempo O((m+n)*D) y memoria O(m+n).
+ * Devuelve un arreglo con un solo alineamiento, terminado por un alineamiento nulo.
+ */
+{
+	int len1=strlen(str1), len2=strlen(str2);
+	char *ops=(char *) calloc(len1+len2+1, sizeof(char));//Un puntero por cada antidiagonal
+	assert(ops != NULL);
+	int d=FurthestReaching(str1, len1, str2, len2, 0, len1+len2, NULL);//La distancia
+	DiagonalSolve(str1, 0, len1, str2, 0, len2, d, ops);
+
+	Align *aligns=ExplAlignFromOps(str1, str2, scores, ops);//Compacta los punteros del camino y calcula su puntaje
+	free(ops);
+	return aligns;
+}//___________________________________________________________
+
+
+
+int FurthestReaching(const char *str1, const int len1, const char *str2, const int len2, const int reverse, const int max_d, int *reach)
+/*
+ * Puntos más lejanos por diagonal de la matriz de str2 (filas, longitud len2) contra str1 (columnas, longitud len1),
+ * ambas leídas de derecha a izquierda si reverse. La diagonal k=j-i va de -len2 a len1.
+ * F(d,k) = la fila más lejana entre F(d-1,k)+1 (reemplazo), F(d-1,k-1) (deleción) y F(d-1,k+1)+1 (inserción),
+ * acotada por la matriz y extendida por la diagonal mientras coincidan los caracteres.
+ * Devuelve el primer d<=max_d con el que se llega a la entrada (len2,len1), o max_d+1 si no se llega.
+ * Si reach no es NULL (de 2*max_d+1 entradas) y no se llegó antes, reach[k+max_d] es F(max_d,k) (NO_REACH si no se llega a la diagonal).
+ */
+{
+#define S1(j) (reverse ? str1[len1-1-(j)] : str1[j])
+#define S2(i) (reverse ? str2[len2-1-(i)] : str2[i])
+	int *prev=(int *) malloc((2*max_d+3) * sizeof(int));//prev[k]=F(d-1,k), con una diagonal de más a cada lado
+	int *cur=(int *) malloc((2*max_d+3) * sizeof(int));//cur[k]=F(d,k)
+	assert(prev != NULL && cur != NULL);
+	prev+=max_d+1, cur+=max_d+1;//Las diagonales van de -max_d-1 a max_d+1
+	int d, k, i, end=len1-len2, *temp;
+	for(d=0; d<=max_d; d++)
+	{
+		cur[-d-1]=NO_REACH, cur[d+1]=NO_REACH;//Todavía no se llega a las diagonales vecinas
+		for(k=-d; k<=d; k++)
+		{
+			if(k < -len2 || k > len1)
+			{
+				cur[k]=NO_REACH;//La diagonal está fuera de la matriz
+				continue;
+			}
+			if(d == 0)
+				i=0;
+			else
+			{
+				i=NO_REACH;
+				if(k > -d && prev[k] != NO_REACH)
+					i=prev[k]+1;//Reemplazo
+				if(k-1 >= -(d-1) && prev[k-1] != NO_REACH)
+					i=MAX(i, prev[k-1]);//Deleción (puntero horizontal)
+				if(k+1 <= d-1 && prev[k+1] != NO_REACH)
+					i=MAX(i, prev[k+1]+1);//Inserción (puntero vertical)
+				if(i == NO_REACH)
+				{
+					cur[k]=NO_REACH;
+					continue;
+				}
+				i=MIN(i, len2), i=MIN(i, len1-k);//Dentro de la matriz
+			}
+			while(i < len2 && i+k < len1 && S2(i) == S1(i+k))//Extiende por la diagonal
+				i++;
+			cur[k]=i;
+			if(k == end && i == len2)//Se llegó a la última entrada
+			{
+				free(prev-(max_d+1));
+				free(cur-(max_d+1));
+				return d;
+			}
+		}
+		temp=prev, prev=cur, cur=temp;
+	}
+	if(reach != NULL)
+		for(k=-max_d; k<=max_d; k++)
+			reach[k+max_d]=prev[k];//Después del intercambio, prev tiene F(max_d,k)
+	free(prev-(max_d+1));
+	free(cur-(max_d+1));
+	return max_d+1;
+#undef S1
+#undef S2
+}//___________________________________________________________
+
+
+
+void DiagonalSolve(const char *str1, const int j0, const int j1, const char *str2, const int i0, const int i1, const int d, char *ops)
+/*
+ * Coloca en ops[i+j] los punteros de un camino óptimo de la entrada (i0,j0) a la (i1,j1), cuya distancia de edición es d.
+ * Con d<=1 (o una de las subcadenas vacía) el camino se construye directamente; si no, se calculan los puntos más lejanos
+ * hacia adelante con d1=ceil(d/2) ediciones y hacia atrás con d2=floor(d/2). Si en la diagonal k el de adelante llega a la fila
+ * del de atrás, esa entrada tiene distancia a lo más d1 desde (i0,j0) y a lo más d2 hasta (i1,j1): está en un camino óptimo.
+ */
+{
+#define STEP(pointer, di, dj)	do{i+=(di), j+=(dj); ops[i+j]=(pointer);}while(0)
+	int len1=j1-j0, len2=i1-i0;
+	int i=i0, j=j0, k, l;
+	if(len1 == 0 || len2 == 0 || d == 0)
+	{
+		while(i < i1 && j < j1)
+			STEP('\\', 1, 1);//Sólo coincidencias
+		while(i < i1)
+			STEP('|', 1, 0);
+		while(j < j1)
+			STEP('-', 0, 1);
+		return;
+	}
+	if(d == 1)
+	{
+		for(l=0; l<len1 && l<len2 && str1[j0+l] == str2[i0+l]; l++)
+			STEP('\\', 1, 1);//Prefijo común, la única edición está en la primera diferencia
+		if(len1 == len2)
+			STEP('\\', 1, 1);//Reemplazo
+		else if(len2 > len1)
+			STEP('|', 1, 0);//Inserción
+		else
+			STEP('-', 0, 1);//Deleción
+		while(i < i1)
+			STEP('\\', 1, 1);//El resto coincide
+		return;
+	}
+
+	int d1=(d+1)/2, d2=d-d1, end=len1-len2;
+	int *fwd=(int *) malloc((2*d1+1) * sizeof(int)), *bwd=(int *) malloc((2*d2+1) * sizeof(int));
+	assert(fwd != NULL && bwd != NULL);
+	FurthestReaching(str1+j0, len1, str2+i0, len2, 0, d1, fwd);
+	FurthestReaching(str1+j0, len1, str2+i0, len2, 1, d2, bwd);
+	int row=-1;//Fila (relativa a i0) del punto de cruce
+	for(k=-d1; k<=d1 && row<0; k++)
+	{
+		l=end-k;//La misma diagonal, vista desde la última entrada
+		if(l < -d2 || l > d2 || fwd[k+d1] == NO_REACH || bwd[l+d2] == NO_REACH)
+			continue;
+		if(fwd[k+d1] >= len2-bwd[l+d2])
+			row=len2-bwd[l+d2];
+	}
+	k--;
+	assert(row >= 0);
+	free(fwd);
+	free(bwd);
+	DiagonalSolve(str1, j0, j0+row+k, str2, i0, i0+row, d1, ops);
+	DiagonalSolve(str1, j0+row+k, j1, str2, i0+row, i1, d2, ops);
+#undef STEP
+}//___________________________________________________________
+#undef NO_REACH
+# endif
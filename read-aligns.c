@@ -0,0 +1,109 @@
+/*
+=====================================================
+Programa: Lector de registros binarios (read-aligns)
+=====================================================
+
+Lee un archivo de registros binarios escrito con `global-align ... --format=bin` (ver binary.h) proyectándolo en memoria,
+sin analizar texto, y escribe sus registros como texto o sólo un resumen de ellos.
+
+ - Compilar:
+ 	```
+	gcc read-aligns.c -o read-aligns
+ 	```
+
+ - Ejecutar:
+	```
+    global-align vintners writers --scores=M20I-1D-1R-1 --type=max --format=bin > aligns.bin
+    read-aligns aligns.bin
+    read-aligns aligns.bin --summary
+	```
+
+   + Sin opciones escribe un registro por línea separado por tabuladores, con los mismos campos que `--format=tsv`
+     pero con los índices de las cadenas (id1, id2) en lugar de sus nombres, y el número de ediciones.
+   + Con `--summary` sólo escribe cuántos registros hay, cuántas corridas y columnas suman y el menor, el mayor
+     y el promedio de los puntajes.
+
+El programa utiliza las funciones de las librerías **general.h** y **binary.h**, que se incluyen mediante el archivo de declaraciones **alignments_headers.h**
+
+Autor
+-----
+
+**Andrés García García** @ Sab 26/Mar/'16 (Inicio del proyecto: 19/Oct/'15)
+*/
+
+# include <stdio.h>
+# include <assert.h>//Para verificar errores con la función assert()
+//Incluye las librerías de registros binarios
+# include "alignments_headers.h"
+# include "general.h"
+# include "binary.h"
+
+
+//===============>> INICIO DE FUNCIÓN MAIN <<=====================
+
+int main(int argc, char *argv[])
+{
+
+	//____________________Inicialización___________________________
+	if( argc < 2 )//Debe llamarse con el archivo de registros
+	{
+		printf("\nPara llamar el programa escriba en la terminal:\n");
+		printf("%s <archivo.bin> [--summary]\n", argv[0]);
+		printf("Ejemplo: %s aligns.bin --summary\n\n", argv[0]);
+		return 1;
+	}
+	char ***args = getArgs(argv, argc);
+	int summary = hasArg("summary", args);
+	freeArgs(args);
+
+	BinFile *file = OpenBinFile(argv[1]);
+	if(file == NULL)
+		return 1;
+
+	//____________________Operaciones___________________________
+	BinRecord record;
+	long long records = 0, runs = 0, columns = 0;
+	double total = 0;
+	float min = 0, max = 0;
+	char op;
+	int k, len;
+	if(!summary)
+		printf("number\tid1\tstart1\tend1\tid2\tstart2\tend2\tscore\tedits\tcigar\n");
+	while(NextBinRecord(file, &record))
+	{
+		if(records == 0 || record.Score < min)
+			min = record.Score;
+		if(records == 0 || record.Score > max)
+			max = record.Score;
+		records++, runs += record.nRuns, total += record.Score;
+		if(summary)
+		{
+			for(k=0; k<(int)record.nRuns; k++)
+				GetBinRun(&record, k, &op, &len), columns += len;
+			continue;
+		}
+		printf("%u\t%u\t%d\t%d\t%u\t%d\t%d\t%.9g\t%u\t", record.Number, record.Id1, record.Start1, record.End1,
+				record.Id2, record.Start2, record.End2, record.Score, record.Edits);
+		for(k=0; k<(int)record.nRuns; k++)
+		{
+			GetBinRun(&record, k, &op, &len);
+			printf("%d%c", len, op);
+		}
+		printf("\n");
+	}
+	if((file->Pos) != (file->Size))
+		fprintf(stderr, "\nADVERTENCIA: El archivo termina con un registro incompleto (%zu bytes sin leer)\n", (file->Size) - (file->Pos));
+
+	//_____________________Resultados____________________________
+	if(summary)
+	{
+		printf("Versión:\t%d\n", (file->Version));
+		printf("Registros:\t%lld\n", records);
+		printf("Corridas:\t%lld\n", runs);
+		printf("Columnas:\t%lld\n", columns);
+		if(records > 0)
+			printf("Puntaje:\tmín %.9g, máx %.9g, promedio %.9g\n", min, max, total/records);//Todos los dígitos del float (ver WriteScore())
+	}
+	CloseBinFile(file);
+	return 0;
+}
@@ -0,0 +1,149 @@
+# ifndef STRING_ALIGN_SCALAR_FILL
+# define STRING_ALIGN_SCALAR_FILL
+/*
+===========================================
+Librería: Llenado escalar especializado.
+===========================================
+
+Núcleos escalares para llenar bloques de matrices de alineamiento (A_Matrix), especializados al compilar para cada
+combinación de objetivo (mínimo para distancia, máximo para similaridad) y tipo de puntaje (int16, int32 o float).
+El núcleo se elige una sola vez por matriz con ChooseFillBlock(), por lo que el llenado no llama a ninguna función
+por entrada (a diferencia de Score(), que recibe la función Compare). Producen exactamente los mismos puntajes y punteros que Score().
+
+Además de las del alineamiento global, hay variantes para el alineamiento local (Smith-Waterman, sólo de similaridad),
+en las que ningún puntaje baja de 0 y las entradas con puntaje 0 no tienen punteros.
+
+Los núcleos se generan a partir de la plantilla scalar_fill_kernel.h, incluida una vez por cada variante.
+
+Las siguientes son las funciones declaradas aquí:
+
+:FillBlockKernel ChooseFillBlock(const int score_type, const int maximize):
+	El núcleo especializado para puntajes del tipo score_type y el objetivo dado (máximo si maximize, mínimo si no).
+
+:void FillBlockMinInt16(A_Matrix *AlignMatrix, const int row0, const int row1, const int col0, const int col1):
+:void FillBlockMinInt32(A_Matrix *AlignMatrix, const int row0, const int row1, const int col0, const int col1):
+:void FillBlockMinFloat(A_Matrix *AlignMatrix, const int row0, const int row1, const int col0, const int col1):
+	Llenan las entradas (i,j) con row0<=i<row1 y col0<=j<col1 de una matriz de distancia (mínimo) con puntajes int16, int32 o float.
+
+:void FillBlockMaxInt16(A_Matrix *AlignMatrix, const int row0, const int row1, const int col0, const int col1):
+:void FillBlockMaxInt32(A_Matrix *AlignMatrix, const int row0, const int row1, const int col0, const int col1):
+:void FillBlockMaxFloat(A_Matrix *AlignMatrix, const int row0, const int row1, const int col0, const int col1):
+	Llenan las entradas (i,j) con row0<=i<row1 y col0<=j<col1 de una matriz de similaridad (máximo) con puntajes int16, int32 o float.
+
+:FillBlockKernel ChooseLocalFillBlock(const int score_type):
+	El núcleo especializado del alineamiento local para puntajes del tipo score_type.
+
+:void FillBlockLocalInt16(A_Matrix *AlignMatrix, const int row0, const int row1, const int col0, const int col1):
+:void FillBlockLocalInt32(A_Matrix *AlignMatrix, const int row0, const int row1, const int col0, const int col1):
+:void FillBlockLocalFloat(A_Matrix *AlignMatrix, const int row0, const int row1, const int col0, const int col1):
+	Llenan las entradas (i,j) con row0<=i<row1 y col0<=j<col1 de una matriz de alineamiento local con puntajes int16, int32 o float.
+
+
+Los prototipos de las funciones y las estructuras están declarados en el archivo alignments_headers.h
+
+:Autor:
+	Andrés García García @ 28/Feb/'16 (Inicio 19 Oct 2015)
+*/
+
+//Librerías
+# include <stdio.h>
+# include <stdlib.h>
+# include "alignments_headers.h"
+
+
+/*
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Núcleos escalares (generados con scalar_fill_kernel.h).
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+
+//____________________Distancia (mínimo)___________________________
+#define KERNEL_NAME FillBlockMinInt16
+#define SCORE_T short
+#define BEST(a, b) MIN(a, b)
+# include "scalar_fill_kernel.h"
+
+#define KERNEL_NAME FillBlockMinInt32
+#define SCORE_T int
+#define BEST(a, b) MIN(a, b)
+# include "scalar_fill_kernel.h"
+
+#define KERNEL_NAME FillBlockMinFloat
+#define SCORE_T float
+#define BEST(a, b) MIN(a, b)
+# include "scalar_fill_kernel.h"
+
+//____________________Similaridad (máximo)___________________________
+#define KERNEL_NAME FillBlockMaxInt16
+#define SCORE_T short
+#define BEST(a, b) MAX(a, b)
+# include "scalar_fill_kernel.h"
+
+#define KERNEL_NAME FillBlockMaxInt32
+#define SCORE_T int
+#define BEST(a, b) MAX(a, b)
+# include "scalar_fill_kernel.h"
+
+#define KERNEL_NAME FillBlockMaxFloat
+#define SCORE_T float
+#define BEST(a, b) MAX(a, b)
+# include "scalar_fill_kernel.h"
+
+//____________________Alineamiento local (máximo, sin bajar de 0)___________________________
+#define KERNEL_NAME FillBlockLocalInt16
+#define SCORE_T short
+#define BEST(a, b) MAX(a, b)
+#define LOCAL
+# include "scalar_fill_kernel.h"
+
+#define KERNEL_NAME FillBlockLocalInt32
+#define SCORE_T int
+#define BEST(a, b) MAX(a, b)
+#define LOCAL
+# include "scalar_fill_kernel.h"
+
+#define KERNEL_NAME FillBlockLocalFloat
+#define SCORE_T float
+#define BEST(a, b) MAX(a, b)
+#define LOCAL
+# include "scalar_fill_kernel.h"
+
+
+
+/*
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Selección del núcleo escalar.
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+
+FillBlockKernel ChooseFillBlock(const int score_type, const int maximize)
+// Devuelve el núcleo especializado para puntajes del tipo score_type y el objetivo dado (máximo si maximize, mínimo si no).
+{
+	switch(score_type)
+	{
+		case SCORE_INT16:
+			return (maximize ? FillBlockMaxInt16 : FillBlockMinInt16);
+		case SCORE_INT32:
+			return (maximize ? FillBlockMaxInt32 : FillBlockMinInt32);
+		default:
+			return (maximize ? FillBlockMaxFloat : FillBlockMinFloat);
+	}
+}//___________________________________________________________
+
+
+
+FillBlockKernel ChooseLocalFillBlock(const int score_type)
+// Devuelve el núcleo especializado del alineamiento local para puntajes del tipo score_type.
+{
+	switch(score_type)
+	{
+		case SCORE_INT16:
+			return FillBlockLocalInt16;
+		case SCORE_INT32:
+			return FillBlockLocalInt32;
+		default:
+			return FillBlockLocalFloat;
+	}
+}//___________________________________________________________
+
+# endif
@@ -0,0 +1,67 @@
+/*
+========================================================================
+Plantilla: Núcleo escalar especializado por bloques (scalar_fill_kernel.h).
+========================================================================
+
+Este archivo NO tiene guardas de inclusión: se incluye una vez por cada combinación de objetivo (mínimo o máximo)
+y tipo de puntaje desde scalar_fill.h, definiendo antes las siguientes macros, y genera la función
+KERNEL_NAME(A_Matrix *AlignMatrix, const int row0, const int row1, const int col0, const int col1).
+Al final elimina (#undef) todas las macros, para poder incluirse de nuevo con otras definiciones.
+
+	KERNEL_NAME		Nombre de la función generada.
+	SCORE_T			Tipo de los puntajes (short, int o float), debe coincidir con AlignMatrix->ScoreType.
+	BEST(a, b)		El mejor de dos puntajes: MIN(a, b) para distancia o MAX(a, b) para similaridad.
+	LOCAL			(Opcional) Si está definida, alineamiento local: un puntaje que no es positivo se reemplaza por 0 sin punteros.
+
+La función llena, fila por fila, las entradas (i,j) con row0<=i<row1 y col0<=j<col1 (con i>0 y j>0);
+las entradas de arriba y de la izquierda del bloque deben estar llenas. Las filas se ubican con Stride y Shift,
+por lo que también sirve en matrices por bandas si el bloque y sus vecinos de arriba y de la izquierda están en la banda.
+Como el objetivo y el tipo se conocen al compilar, no hay llamadas a función ni ciclos sobre los candidatos por entrada.
+El puntaje de apareamiento o reemplazo se lee de la fila del perfil de Str1 (ver BuildProfile()) del caracter de la fila, sin comparar caracteres,
+por lo que el mismo núcleo sirve con M y R o con una matriz de sustitución.
+Las operaciones (y su orden) son las mismas que en Score(), por lo que los puntajes y punteros son idénticos.
+*/
+
+void KERNEL_NAME(A_Matrix *AlignMatrix, const int row0, const int row1, const int col0, const int col1)
+{
+#define STR2 (AlignMatrix->Str2)
+	size_t stride=(AlignMatrix->Stride), shift=(AlignMatrix->Shift), cols=(AlignMatrix->Cols);
+	const SCORE_T ins=(SCORE_T)(AlignMatrix->Scores)[2], del=(SCORE_T)(AlignMatrix->Scores)[3];
+	SCORE_T vd, vv, vh, best;
+	SCORE_T *up, *row;//Fila anterior y fila actual
+	const SCORE_T *prof;//Fila del perfil: el puntaje de cada Str1[j-1] contra el caracter de la fila
+	unsigned char *pointers;//Punteros de la fila actual
+	int i, j;
+	for(i=row0; i<row1; i++)
+	{
+		up=(SCORE_T *)(AlignMatrix->Values) + (i-1)*stride + shift;
+		row=(SCORE_T *)(AlignMatrix->Values) + i*stride + shift;
+		pointers=(AlignMatrix->Pointers) + i*stride + shift;
+		prof=(const SCORE_T *)(AlignMatrix->Profile) + (AlignMatrix->ProfileRow)[(unsigned char)STR2[i-1]]*cols;
+		for(j=col0; j<col1; j++)
+		{
+			vd=up[j-1] + prof[j];//Apareamiento o reemplazo
+			vv=up[j] + ins;//Inserción
+			vh=row[j-1] + del;//Deleción
+			best=vd;
+			best=BEST(best, vv);
+			best=BEST(best, vh);
+#ifdef LOCAL
+			if(best <= 0)//Aquí empieza el alineamiento local
+			{
+				row[j]=0;
+				pointers[j]=0;
+				continue;
+			}
+#endif
+			row[j]=best;
+			pointers[j]=(vd==best ? DIAG_BIT : 0) | (vv==best ? VERT_BIT : 0) | (vh==best ? HORI_BIT : 0);
+		}
+	}
+#undef STR2
+}//___________________________________________________________
+
+#undef KERNEL_NAME
+#undef SCORE_T
+#undef BEST
+#undef LOCAL
@@ -0,0 +1,246 @@
+# ifndef STRING_ALIGN_SEQ_FILE
+# define STRING_ALIGN_SEQ_FILE
+/*
+============================================
+Librería: Lectura de archivos FASTA y FASTQ.
+============================================
+
+Con la opción --files las dos cadenas se leen de archivos FASTA o FASTQ (se reconoce el formato por el primer caracter, '>' o '@')
+y se alinea cada registro del primero contra cada registro del segundo.
+
+Los archivos no se copian: se proyectan en memoria con mmap() privado (MAP_PRIVATE) y los registros se separan en su lugar,
+así que cada Sequence apunta dentro de la proyección y las matrices también (ver AllocAlignMatrix(), que ya no copia las cadenas).
+Para que el nombre y la secuencia de cada registro sean cadenas de C se escribe un '\0' en el lugar del espacio o del salto
+de línea que las termina; con la proyección privada sólo las páginas escritas pasan a ser del proceso (copia al escribir)
+y el resto sigue siendo la caché de páginas del archivo, que el sistema puede soltar cuando quiera. Una secuencia en una sola línea
+(lo normal en FASTQ y en muchos FASTA) cuesta así una página de memoria propia, sin importar su tamaño.
+Las secuencias partidas en varias líneas se juntan recorriendo cada línea hacia atrás dentro del mismo registro, por lo que
+sus páginas sí se vuelven propias (pero nunca se aloja una segunda copia). Los '\r' de los archivos de Windows se quitan igual.
+Si el último registro no termina en un salto de línea y el archivo ocupa exactamente sus páginas, no hay dónde escribir su '\0'
+y sólo esa secuencia se copia (SeqFile->Tail).
+
+Esta librería utiliza las siguientes estructuras como base::
+
+		typedef struct Sequence_struct
+		//Registro de un archivo FASTA o FASTQ, separado en su lugar dentro de la proyección del archivo
+		{
+			const char *Name;//Nombre: la primera palabra del encabezado, sin '>' ni '@'
+			const char *Seq;//Secuencia, terminada en '\0'
+			size_t Length;//Longitud de la secuencia
+
+		} Sequence;
+		//___________________________________________________________
+
+
+		typedef struct SeqFile_struct
+		//Archivo FASTA o FASTQ proyectado en memoria y sus registros
+		{
+			char *Data;//Contenido del archivo (proyección privada, NULL si está vacío)
+			size_t Size;//Bytes del archivo
+			int nSeqs;//Número de registros
+			int Alloc;//Registros alojados en Seqs
+			Sequence *Seqs;//Los registros, en el orden del archivo
+			char *Tail;//Copia de la última secuencia si no cupo su '\0' en la proyección (NULL casi siempre)
+
+		} SeqFile;
+		//___________________________________________________________
+
+
+
+Las siguientes son las funciones declaradas aquí:
+
+:SeqFile *LoadSeqFile(const char *name):
+	Proyecta en memoria el archivo FASTA o FASTQ name y separa sus registros en su lugar. Devuelve NULL si no se pudo.
+
+:size_t SeqLine(const char *data, size_t pos, const size_t size):
+	La posición del fin de la línea que empieza en pos (el '\n' o size).
+
+:void AddSequence(SeqFile *file, const char *name, const char *seq, const size_t length):
+	Agrega un registro al final del arreglo de registros de file.
+
+:void FreeSeqFile(SeqFile *file):
+	Libera la proyección del archivo y sus registros.
+
+
+Los prototipos de las funciones y las estructuras están declarados en el archivo alignments_headers.h
+
+Los formatos están basados en:
+	*The Sanger FASTQ file format for sequences with quality scores*
+	Peter J. A. Cock et al., Nucleic Acids Research 38(6) (2010)
+
+:Autor:
+	Andrés García García @ 28/Feb/'16 (Inicio 19 Oct 2015)
+*/
+
+//Librerías
+# include <stdio.h>
+# include <assert.h>//Para verificar errores con la función assert()
+# include <stdlib.h>//Para usar malloc(), realloc(), free()
+# include <string.h>//Para usar memchr(), memmove() y strndup()
+# include <fcntl.h>//Para usar open()
+# include <unistd.h>//Para usar close() y sysconf()
+# include <sys/mman.h>//Para usar mmap(), madvise() y munmap()
+# include <sys/stat.h>//Para usar fstat()
+# include "alignments_headers.h"
+
+
+/*
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Funciones para leer archivos FASTA y FASTQ.
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+
+SeqFile *LoadSeqFile(const char *name)
+/*
+ * Proyecta en memoria el archivo FASTA o FASTQ name y separa sus registros en su lugar (ver el principio del archivo).
+ * En FASTA la secuencia son todas las líneas hasta el siguiente '>'; en FASTQ, las líneas hasta el '+', y después se saltan
+ * tantos caracteres de calidad como tenga la secuencia (pueden empezar con '@'). Se ignoran las líneas vacías entre registros.
+ * Si el archivo no se puede abrir, no empieza con '>' ni '@' o un registro está incompleto, imprime una advertencia y devuelve NULL.
+ */
+{
+#define DATA (file->Data)
+	int fd=open(name, O_RDONLY);
+	struct stat st;
+	if(fd < 0 || fstat(fd, &st) != 0)
+	{
+		printf("\nADVERTENCIA: No se pudo abrir el archivo de secuencias \"%s\"\n", name);
+		if(fd >= 0)
+			close(fd);
+		return NULL;
+	}
+	SeqFile *file=(SeqFile *) malloc(sizeof(SeqFile));
+	assert(file != NULL);
+	(file->Size)=(size_t)st.st_size, DATA=NULL, (file->nSeqs)=0, (file->Alloc)=0, (file->Seqs)=NULL, (file->Tail)=NULL;
+	if((file->Size) > 0)
+	{
+		//Privada y con escritura: los '\0' sólo copian las páginas donde se escriben, el archivo nunca cambia
+		void *data=mmap(NULL, (file->Size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+		DATA=(data == MAP_FAILED ? NULL : (char *)data);
+	}
+	close(fd);//La proyección sigue siendo válida
+	const size_t size=(file->Size);
+	size_t pos=0, end, dst, start, len, name_len, qual;
+	while(DATA != NULL && pos < size && (DATA[pos] == '\n' || DATA[pos] == '\r'))
+		pos++;
+	const char marker=(DATA != NULL && pos < size ? DATA[pos] : '\0');
+	if(marker != '>' && marker != '@')
+	{
+		printf("\nADVERTENCIA: \"%s\" no es un archivo FASTA ni FASTQ\n", name);
+		FreeSeqFile(file);
+		return NULL;
+	}
+	madvise(DATA, size, MADV_SEQUENTIAL);
+	//Si el archivo no llena su última página, lo que sigue a su final ya vale '\0' y se puede leer
+	const int room=(size % (size_t)sysconf(_SC_PAGESIZE) != 0);
+	while(pos < size)
+	{
+		if(DATA[pos] == '\n' || DATA[pos] == '\r')//Línea vacía entre registros
+		{
+			pos++;
+			continue;
+		}
+		end=SeqLine(DATA, pos, size);
+		if(DATA[pos] != marker || end == size)
+		{
+			printf("\nADVERTENCIA: Registro incompleto o mal formado en \"%s\" (byte %zu)\n", name, pos);
+			FreeSeqFile(file);
+			return NULL;
+		}
+		//Encabezado: el nombre es la primera palabra después del marcador, termina sobre el espacio o el salto de línea
+		char *seq_name=DATA+pos+1;
+		for(name_len=0; pos+1+name_len < end && seq_name[name_len] != ' ' && seq_name[name_len] != '\t' && seq_name[name_len] != '\r'; name_len++);
+		seq_name[name_len]='\0';
+		//Secuencia: las líneas hasta el siguiente registro (o hasta el '+' en FASTQ), juntadas en su lugar
+		start=end+1, pos=start, dst=start;
+		while(pos < size && DATA[pos] != marker && !(marker == '@' && DATA[pos] == '+'))
+		{
+			end=SeqLine(DATA, pos, size);
+			len=end-pos;
+			if(len > 0 && DATA[end-1] == '\r')
+				len--;
+			if(dst != pos)
+				memmove(DATA+dst, DATA+pos, len);
+			dst+=len, pos=end+1;
+		}
+		//Calidades (FASTQ): la línea '+' y tantos caracteres como la secuencia, en una o más líneas
+		if(marker == '@')
+		{
+			if(pos >= size)
+			{
+				printf("\nADVERTENCIA: El registro \"%s\" de \"%s\" no tiene calidades\n", seq_name, name);
+				FreeSeqFile(file);
+				return NULL;
+			}
+			for(pos=SeqLine(DATA, pos, size)+1, qual=0; pos < size && qual < dst-start; pos=end+1)
+			{
+				end=SeqLine(DATA, pos, size);
+				qual+=end-pos - (end > pos && DATA[end-1] == '\r');
+			}
+			if(qual != dst-start)
+			{
+				printf("\nADVERTENCIA: El registro \"%s\" de \"%s\" no tiene tantas calidades como caracteres\n", seq_name, name);
+				FreeSeqFile(file);
+				return NULL;
+			}
+		}
+		//Termina la secuencia: dst nunca pasa del último salto de línea del registro, salvo al final del archivo
+		if(dst == start)//Secuencia vacía: DATA[dst] ya es el siguiente registro, se usa el '\0' del nombre (len es el de la última línea)
+			start=dst=(size_t)(seq_name+name_len-DATA);
+		else if(dst < size)
+			DATA[dst]='\0';
+		else if(!room)
+		{
+			(file->Tail)=strndup(DATA+start, dst-start);
+			assert((file->Tail) != NULL);
+		}
+		AddSequence(file, seq_name, ((file->Tail) != NULL ? (file->Tail) : DATA+start), dst-start);
+	}
+	madvise(DATA, size, MADV_NORMAL);
+	return file;
+#undef DATA
+}//___________________________________________________________
+
+
+
+size_t SeqLine(const char *data, size_t pos, const size_t size)
+/*
+ * Devuelve la posición del '\n' que termina la línea que empieza en data[pos], o size si es la última y no tiene salto de línea.
+ */
+{
+	const char *newline=(const char *) memchr(data+pos, '\n', size-pos);
+	return (newline != NULL ? (size_t)(newline-data) : size);
+}//___________________________________________________________
+
+
+
+void AddSequence(SeqFile *file, const char *name, const char *seq, const size_t length)
+/*
+ * Agrega al final de file->Seqs el registro con ese nombre y esa secuencia (que no se copian), duplicando el arreglo si está lleno.
+ */
+{
+	if((file->nSeqs) == (file->Alloc))
+	{
+		(file->Alloc)=((file->Alloc) > 0 ? 2*(file->Alloc) : 16);
+		(file->Seqs)=(Sequence *) realloc((file->Seqs), (file->Alloc) * sizeof(Sequence));
+		assert((file->Seqs) != NULL);
+	}
+	Sequence *record=&(file->Seqs)[(file->nSeqs)++];
+	(record->Name)=name, (record->Seq)=seq, (record->Length)=length;
+}//___________________________________________________________
+
+
+
+void FreeSeqFile(SeqFile *file)
+/*
+ * Libera la proyección del archivo, el arreglo de registros y la copia de la última secuencia (si la hay). file puede ser NULL.
+ */
+{
+	if(file == NULL)
+		return;
+	if((file->Data) != NULL)
+		munmap((file->Data), (file->Size));
+	free(file->Seqs);
+	free(file->Tail);
+	free(file);
+}//___________________________________________________________
+# endif
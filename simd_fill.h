@@ -0,0 +1,307 @@
+# ifndef STRING_ALIGN_SIMD_FILL
+# define STRING_ALIGN_SIMD_FILL
+/*
+=====================================
+Librería: Llenado vectorial (SIMD).
+=====================================
+
+Motores vectoriales para llenar matrices de alineamiento (A_Matrix) por antidiagonales con instrucciones SSE4.1 o AVX2.
+Producen exactamente los mismos puntajes y punteros que el llenado escalar con Score(), pero calculan
+varias entradas por instrucción en lugar de una llamada a función por entrada: con AVX2, 16 (int16) u 8 (int32 y float),
+con SSE4.1, 8 (int16) o 4 (int32 y float).
+El conjunto de instrucciones se elige al momento de ejecución, según lo que soporte el procesador, y el núcleo según el tipo de los puntajes (AlignMatrix->ScoreType).
+
+Los núcleos se generan a partir de la plantilla simd_fill_kernel.h, incluida una vez por cada conjunto de instrucciones y tipo de puntaje.
+
+Las siguientes son las funciones declaradas aquí:
+
+:int FillAlignMatrixSIMD(A_Matrix *AlignMatrix, const int maximize):
+	Llena las entradas interiores (i>0 y j>0) de AlignMatrix con el mejor motor vectorial disponible.
+	Las orillas (condiciones base) deben estar llenas de antemano. Devuelve 0 si el procesador no soporta ningún motor
+	o si AlignMatrix usa una matriz de sustitución.
+
+:const char *BestSIMDEngine(void):
+	Nombre del mejor motor vectorial que soporta el procesador ("avx2" o "sse4.1"), o NULL si no hay ninguno.
+
+:void FillAntiDiagAVX2Int16(A_Matrix *AlignMatrix, const int maximize):
+	Núcleo por antidiagonales con AVX2 y puntajes int16, 16 entradas por instrucción.
+
+:void FillAntiDiagAVX2Int32(A_Matrix *AlignMatrix, const int maximize):
+	Núcleo por antidiagonales con AVX2 y puntajes int32, 8 entradas por instrucción.
+
+:void FillAntiDiagAVX2Float(A_Matrix *AlignMatrix, const int maximize):
+	Núcleo por antidiagonales con AVX2 y puntajes float, 8 entradas por instrucción.
+
+:void FillAntiDiagSSE41Int16(A_Matrix *AlignMatrix, const int maximize):
+	Núcleo por antidiagonales con SSE4.1 y puntajes int16, 8 entradas por instrucción.
+
+:void FillAntiDiagSSE41Int32(A_Matrix *AlignMatrix, const int maximize):
+	Núcleo por antidiagonales con SSE4.1 y puntajes int32, 4 entradas por instrucción.
+
+:void FillAntiDiagSSE41Float(A_Matrix *AlignMatrix, const int maximize):
+	Núcleo por antidiagonales con SSE4.1 y puntajes float, 4 entradas por instrucción.
+
+
+Los prototipos de las funciones y las estructuras están declarados en el archivo alignments_headers.h
+
+:Autor:
+	Andrés García García @ 28/Feb/'16 (Inicio 19 Oct 2015)
+*/
+
+//Librerías
+# include <stdio.h>
+# include <assert.h>//Para verificar errores con la función assert()
+# include <stdlib.h>//Para usar malloc(), calloc(), realloc(), free()
+# include <string.h>//Para usar memcpy()
+# include <immintrin.h>//Para las instrucciones SSE4.1 y AVX2
+# include "alignments_headers.h"
+//Definiciones globales
+#define SIMD_BAND_DIAGS 256 //Pasos (antidiagonales) de una franja que se acumulan en el área de paso antes de copiarlos a la matriz
+
+
+/*
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Núcleos vectoriales (generados con simd_fill_kernel.h).
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+
+//____________________AVX2___________________________
+__attribute__((target("avx2")))
+static inline void Transpose8x8Epi32AVX2(__m256i *v)
+// Transpone en su lugar la matriz de 8x8 enteros de 32 bits cuyas filas son v[0..7]: la entrada k de v[i] pasa a ser la entrada i de v[k].
+{
+	__m256i a[8], b[8];
+	int k;
+	for(k=0; k<8; k+=2)//Intercala las filas por pares, dentro de cada mitad de 128 bits
+		a[k]=_mm256_unpacklo_epi32(v[k], v[k+1]), a[k+1]=_mm256_unpackhi_epi32(v[k], v[k+1]);
+	for(k=0; k<8; k+=4)
+	{
+		b[k]=_mm256_unpacklo_epi64(a[k], a[k+2]), b[k+1]=_mm256_unpackhi_epi64(a[k], a[k+2]);
+		b[k+2]=_mm256_unpacklo_epi64(a[k+1], a[k+3]), b[k+3]=_mm256_unpackhi_epi64(a[k+1], a[k+3]);
+	}
+	for(k=0; k<4; k++)//Junta las mitades: b[k] tiene las columnas k y k+4 de las filas 0-3, b[k+4] las de las filas 4-7
+		v[k]=_mm256_permute2x128_si256(b[k], b[k+4], 0x20), v[k+4]=_mm256_permute2x128_si256(b[k], b[k+4], 0x31);
+}
+
+__attribute__((target("avx2")))
+static inline void Transpose16x16Epi16AVX2(__m256i *v)
+// Transpone en su lugar la matriz de 16x16 enteros de 16 bits cuyas filas son v[0..15].
+{
+	__m256i a[16], b[16], c[16];
+	int k;
+	for(k=0; k<16; k+=2)//Primero transpone bloques de 8x8 dentro de cada mitad de 128 bits
+		a[k]=_mm256_unpacklo_epi16(v[k], v[k+1]), a[k+1]=_mm256_unpackhi_epi16(v[k], v[k+1]);
+	for(k=0; k<16; k+=4)
+	{
+		b[k]=_mm256_unpacklo_epi32(a[k], a[k+2]), b[k+1]=_mm256_unpackhi_epi32(a[k], a[k+2]);
+		b[k+2]=_mm256_unpacklo_epi32(a[k+1], a[k+3]), b[k+3]=_mm256_unpackhi_epi32(a[k+1], a[k+3]);
+	}
+	for(k=0; k<16; k+=8)//c[k..k+7] tiene en orden las columnas (y las columnas+8) de las filas k..k+7
+	{
+		c[k]=_mm256_unpacklo_epi64(b[k], b[k+4]), c[k+1]=_mm256_unpackhi_epi64(b[k], b[k+4]);
+		c[k+2]=_mm256_unpacklo_epi64(b[k+1], b[k+5]), c[k+3]=_mm256_unpackhi_epi64(b[k+1], b[k+5]);
+		c[k+4]=_mm256_unpacklo_epi64(b[k+2], b[k+6]), c[k+5]=_mm256_unpackhi_epi64(b[k+2], b[k+6]);
+		c[k+6]=_mm256_unpacklo_epi64(b[k+3], b[k+7]), c[k+7]=_mm256_unpackhi_epi64(b[k+3], b[k+7]);
+	}
+	for(k=0; k<8; k++)//Junta las mitades de las filas 0-7 y 8-15
+		v[k]=_mm256_permute2x128_si256(c[k], c[k+8], 0x20), v[k+8]=_mm256_permute2x128_si256(c[k], c[k+8], 0x31);
+}
+
+//____________________AVX2, int16: 16 entradas por vector___________________________
+#define KERNEL_NAME FillAntiDiagAVX2Int16
+#define KERNEL_TARGET "avx2"
+#define SCORE_T short
+#define LANES 16
+#define VEC __m256i
+#define V_SET1(x) _mm256_set1_epi16(x)
+#define V_LOADU(p) _mm256_loadu_si256((const __m256i *)(p))
+#define V_STOREU(p, v) _mm256_storeu_si256((__m256i *)(p), v)
+#define V_ADD(a, b) _mm256_add_epi16(a, b)
+#define V_MIN(a, b) _mm256_min_epi16(a, b)
+#define V_MAX(a, b) _mm256_max_epi16(a, b)
+#define V_MATCH(p1, p2) _mm256_cvtepi8_epi16(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(p1)), _mm_loadu_si128((const __m128i *)(p2))))
+#define V_BLEND(a, b, m) _mm256_blendv_epi8(a, b, m)
+#define V_SHIFT_IN(v, x) _mm256_alignr_epi8(v, _mm256_permute2x128_si256(v, _mm256_set1_epi16(x), 0x02), 14)
+#define V_TRANSPOSE(v) Transpose16x16Epi16AVX2(v)
+# include "simd_fill_kernel.h"
+
+//____________________AVX2, int32: 8 entradas por vector___________________________
+#define KERNEL_NAME FillAntiDiagAVX2Int32
+#define KERNEL_TARGET "avx2"
+#define SCORE_T int
+#define LANES 8
+#define VEC __m256i
+#define V_SET1(x) _mm256_set1_epi32(x)
+#define V_LOADU(p) _mm256_loadu_si256((const __m256i *)(p))
+#define V_STOREU(p, v) _mm256_storeu_si256((__m256i *)(p), v)
+#define V_ADD(a, b) _mm256_add_epi32(a, b)
+#define V_MIN(a, b) _mm256_min_epi32(a, b)
+#define V_MAX(a, b) _mm256_max_epi32(a, b)
+#define V_MATCH(p1, p2) _mm256_cvtepi8_epi32(_mm_cmpeq_epi8(_mm_loadl_epi64((const __m128i *)(p1)), _mm_loadl_epi64((const __m128i *)(p2))))
+#define V_BLEND(a, b, m) _mm256_blendv_epi8(a, b, m)
+#define V_SHIFT_IN(v, x) _mm256_alignr_epi8(v, _mm256_permute2x128_si256(v, _mm256_set1_epi32(x), 0x02), 12)
+#define V_TRANSPOSE(v) Transpose8x8Epi32AVX2(v)
+# include "simd_fill_kernel.h"
+
+//____________________AVX2, float: 8 entradas por vector___________________________
+#define KERNEL_NAME FillAntiDiagAVX2Float
+#define KERNEL_TARGET "avx2"
+#define SCORE_T float
+#define LANES 8
+#define VEC __m256
+#define V_SET1(x) _mm256_set1_ps(x)
+#define V_LOADU(p) _mm256_loadu_ps(p)
+#define V_STOREU(p, v) _mm256_storeu_ps(p, v)
+#define V_ADD(a, b) _mm256_add_ps(a, b)
+#define V_MIN(a, b) _mm256_min_ps(a, b)
+#define V_MAX(a, b) _mm256_max_ps(a, b)
+#define V_MATCH(p1, p2) _mm256_castsi256_ps(_mm256_cvtepi8_epi32(_mm_cmpeq_epi8(_mm_loadl_epi64((const __m128i *)(p1)), _mm_loadl_epi64((const __m128i *)(p2)))))
+#define V_BLEND(a, b, m) _mm256_blendv_ps(a, b, m)
+#define V_SHIFT_IN(v, x) _mm256_castsi256_ps(_mm256_alignr_epi8(_mm256_castps_si256(v), _mm256_permute2x128_si256(_mm256_castps_si256(v), _mm256_castps_si256(_mm256_set1_ps(x)), 0x02), 12))
+#define V_TRANSPOSE(v) Transpose8x8Epi32AVX2((__m256i *)(v))
+# include "simd_fill_kernel.h"
+
+
+
+//____________________SSE4.1___________________________
+__attribute__((target("sse4.1")))
+static inline __m128i Load4Chars(const char *p)
+// Carga 4 caracteres en las primeras entradas de un vector (sin leer más allá de p[3]).
+{
+	int chars;
+	memcpy(&chars, p, sizeof(chars));
+	return _mm_cvtsi32_si128(chars);
+}
+
+__attribute__((target("sse4.1")))
+static inline void Transpose4x4Epi32SSE41(__m128i *v)
+// Transpone en su lugar la matriz de 4x4 enteros de 32 bits cuyas filas son v[0..3].
+{
+	__m128i a0=_mm_unpacklo_epi32(v[0], v[1]), a1=_mm_unpackhi_epi32(v[0], v[1]);
+	__m128i a2=_mm_unpacklo_epi32(v[2], v[3]), a3=_mm_unpackhi_epi32(v[2], v[3]);
+	v[0]=_mm_unpacklo_epi64(a0, a2), v[1]=_mm_unpackhi_epi64(a0, a2);
+	v[2]=_mm_unpacklo_epi64(a1, a3), v[3]=_mm_unpackhi_epi64(a1, a3);
+}
+
+__attribute__((target("sse4.1")))
+static inline void Transpose8x8Epi16SSE41(__m128i *v)
+// Transpone en su lugar la matriz de 8x8 enteros de 16 bits cuyas filas son v[0..7].
+{
+	__m128i a[8], b[8];
+	int k;
+	for(k=0; k<8; k+=2)
+		a[k]=_mm_unpacklo_epi16(v[k], v[k+1]), a[k+1]=_mm_unpackhi_epi16(v[k], v[k+1]);
+	for(k=0; k<8; k+=4)
+	{
+		b[k]=_mm_unpacklo_epi32(a[k], a[k+2]), b[k+1]=_mm_unpackhi_epi32(a[k], a[k+2]);
+		b[k+2]=_mm_unpacklo_epi32(a[k+1], a[k+3]), b[k+3]=_mm_unpackhi_epi32(a[k+1], a[k+3]);
+	}
+	for(k=0; k<4; k++)
+		v[2*k]=_mm_unpacklo_epi64(b[k], b[k+4]), v[2*k+1]=_mm_unpackhi_epi64(b[k], b[k+4]);
+}
+
+//____________________SSE4.1, int16: 8 entradas por vector___________________________
+#define KERNEL_NAME FillAntiDiagSSE41Int16
+#define KERNEL_TARGET "sse4.1"
+#define SCORE_T short
+#define LANES 8
+#define VEC __m128i
+#define V_SET1(x) _mm_set1_epi16(x)
+#define V_LOADU(p) _mm_loadu_si128((const __m128i *)(p))
+#define V_STOREU(p, v) _mm_storeu_si128((__m128i *)(p), v)
+#define V_ADD(a, b) _mm_add_epi16(a, b)
+#define V_MIN(a, b) _mm_min_epi16(a, b)
+#define V_MAX(a, b) _mm_max_epi16(a, b)
+#define V_MATCH(p1, p2) _mm_cvtepi8_epi16(_mm_cmpeq_epi8(_mm_loadl_epi64((const __m128i *)(p1)), _mm_loadl_epi64((const __m128i *)(p2))))
+#define V_BLEND(a, b, m) _mm_blendv_epi8(a, b, m)
+#define V_SHIFT_IN(v, x) _mm_alignr_epi8(v, _mm_set1_epi16(x), 14)
+#define V_TRANSPOSE(v) Transpose8x8Epi16SSE41(v)
+# include "simd_fill_kernel.h"
+
+//____________________SSE4.1, int32: 4 entradas por vector___________________________
+#define KERNEL_NAME FillAntiDiagSSE41Int32
+#define KERNEL_TARGET "sse4.1"
+#define SCORE_T int
+#define LANES 4
+#define VEC __m128i
+#define V_SET1(x) _mm_set1_epi32(x)
+#define V_LOADU(p) _mm_loadu_si128((const __m128i *)(p))
+#define V_STOREU(p, v) _mm_storeu_si128((__m128i *)(p), v)
+#define V_ADD(a, b) _mm_add_epi32(a, b)
+#define V_MIN(a, b) _mm_min_epi32(a, b)
+#define V_MAX(a, b) _mm_max_epi32(a, b)
+#define V_MATCH(p1, p2) _mm_cvtepi8_epi32(_mm_cmpeq_epi8(Load4Chars(p1), Load4Chars(p2)))
+#define V_BLEND(a, b, m) _mm_blendv_epi8(a, b, m)
+#define V_SHIFT_IN(v, x) _mm_alignr_epi8(v, _mm_set1_epi32(x), 12)
+#define V_TRANSPOSE(v) Transpose4x4Epi32SSE41(v)
+# include "simd_fill_kernel.h"
+
+//____________________SSE4.1, float: 4 entradas por vector___________________________
+#define KERNEL_NAME FillAntiDiagSSE41Float
+#define KERNEL_TARGET "sse4.1"
+#define SCORE_T float
+#define LANES 4
+#define VEC __m128
+#define V_SET1(x) _mm_set1_ps(x)
+#define V_LOADU(p) _mm_loadu_ps(p)
+#define V_STOREU(p, v) _mm_storeu_ps(p, v)
+#define V_ADD(a, b) _mm_add_ps(a, b)
+#define V_MIN(a, b) _mm_min_ps(a, b)
+#define V_MAX(a, b) _mm_max_ps(a, b)
+#define V_MATCH(p1, p2) _mm_castsi128_ps(_mm_cvtepi8_epi32(_mm_cmpeq_epi8(Load4Chars(p1), Load4Chars(p2))))
+#define V_BLEND(a, b, m) _mm_blendv_ps(a, b, m)
+#define V_SHIFT_IN(v, x) _mm_castsi128_ps(_mm_alignr_epi8(_mm_castps_si128(v), _mm_castps_si128(_mm_set1_ps(x)), 12))
+#define V_TRANSPOSE(v) Transpose4x4Epi32SSE41((__m128i *)(v))
+# include "simd_fill_kernel.h"
+
+
+
+/*
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Selección del motor vectorial.
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+
+const char *BestSIMDEngine(void)
+// Devuelve el nombre del mejor motor vectorial soportado por el procesador, o NULL si no soporta ninguno.
+{
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2"))
+		return "avx2";
+	if(__builtin_cpu_supports("sse4.1"))
+		return "sse4.1";
+	return NULL;
+}//___________________________________________________________
+
+
+
+int FillAlignMatrixSIMD(A_Matrix *AlignMatrix, const int maximize)
+/*
+ * Llena las entradas interiores de AlignMatrix (las orillas deben estar llenas) con el mejor motor vectorial disponible.
+ * Si AlignMatrix->Engine es "sse4.1" usa ese motor, si no, el mejor disponible. El núcleo se elige según AlignMatrix->ScoreType.
+ * Coloca en AlignMatrix->Engine el nombre del motor usado. Devuelve 0 (sin llenar nada) si no hay motor vectorial disponible
+ * o si AlignMatrix usa una matriz de sustitución.
+ */
+{
+	const char *engine=BestSIMDEngine();
+	if(engine == NULL || (AlignMatrix->Subst) != NULL)
+		return 0;//Los núcleos por antidiagonales comparan caracteres: sólo sirven con M y R
+	if((AlignMatrix->Engine) != NULL && equStr(AlignMatrix->Engine, "sse4.1"))
+		engine="sse4.1";//Se pidió explícitamente el motor SSE4.1 (todo procesador con AVX2 soporta SSE4.1)
+	int avx2=equStr(engine, "avx2");
+	switch(AlignMatrix->ScoreType)
+	{
+		case SCORE_INT16:
+			(avx2 ? FillAntiDiagAVX2Int16 : FillAntiDiagSSE41Int16)(AlignMatrix, maximize);
+			break;
+		case SCORE_INT32:
+			(avx2 ? FillAntiDiagAVX2Int32 : FillAntiDiagSSE41Int32)(AlignMatrix, maximize);
+			break;
+		default:
+			(avx2 ? FillAntiDiagAVX2Float : FillAntiDiagSSE41Float)(AlignMatrix, maximize);
+	}
+	(AlignMatrix->Engine)=engine;
+	return 1;
+}//___________________________________________________________
+
+# endif
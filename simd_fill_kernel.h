@@ -0,0 +1,198 @@
+/*
+==================================================================
+Plantilla: Núcleo vectorial por antidiagonales (simd_fill_kernel.h).
+==================================================================
+
+Este archivo NO tiene guardas de inclusión: se incluye desde simd_fill.h una vez por cada conjunto de instrucciones
+y tipo de puntaje, definiendo antes las siguientes macros, y genera la función KERNEL_NAME(A_Matrix *AlignMatrix, const int maximize).
+El cuerpo del núcleo (KERNEL_NAME##Body) se expande dos veces, con maximize constante, por lo que el objetivo (mínimo o máximo)
+se resuelve una sola vez por matriz y no dentro del ciclo.
+Al final elimina (#undef) todas las macros, para poder incluirse de nuevo con otras definiciones.
+
+	KERNEL_NAME		Nombre de la función generada.
+	KERNEL_TARGET	Conjunto de instrucciones para __attribute__((target(...))), p. ej. "avx2".
+	SCORE_T			Tipo de los puntajes (short, int o float), debe coincidir con AlignMatrix->ScoreType.
+	LANES			Número de entradas por vector.
+	VEC				Tipo del vector de puntajes.
+	V_SET1(x)		Vector con todas sus entradas iguales a x.
+	V_LOADU(p)		Carga LANES puntajes desde p (sin alinear).
+	V_STOREU(p, v)	Guarda LANES puntajes en p (sin alinear).
+	V_ADD(a, b)		Suma entrada por entrada.
+	V_MIN(a, b)		a<b ? a : b, entrada por entrada (igual que la macro MIN).
+	V_MAX(a, b)		a>b ? a : b, entrada por entrada (igual que la macro MAX).
+	V_MATCH(p1, p2)	Máscara de las entradas donde los LANES caracteres en p1 y p2 son iguales.
+	V_BLEND(a, b, m) Elige b donde m es verdadera y a donde no.
+	V_TRANSPOSE(v)	Transpone en su lugar la matriz de LANES x LANES puntajes cuyas filas son los vectores v[0..LANES-1].
+	V_SHIFT_IN(v, x) Recorre las entradas de v un lugar hacia arriba (la entrada k pasa a k+1, se pierde la última) y coloca x en la entrada 0.
+
+La matriz se llena por franjas de LANES filas, una fila por entrada del vector, y cada franja por antidiagonales:
+en el paso s la entrada k del vector es la entrada (r0+k, s-k) de la matriz, así que su vecino de la izquierda es la
+entrada k del paso anterior y los de arriba y en diagonal son la entrada k-1 del paso anterior y del antepenúltimo.
+Las antidiagonales se quedan en registros y sólo se recorren con V_SHIFT_IN(), metiendo en la entrada 0 la fila de arriba
+de la franja, que ya está en la matriz; ni los puntajes ni los caracteres de Str2 (uno fijo por entrada) se vuelven a leer de memoria.
+Cada paso se guarda completo en un área de paso pequeña (cabe en la caché L1) y cada SIMD_BAND_DIAGS pasos se copian a AlignMatrix->Values:
+cada LANES pasos forman una matriz de LANES x LANES que, transpuesta en registros (V_TRANSPOSE), da LANES pedazos de fila contiguos,
+de modo que las escrituras a la matriz son vectores completos en lugar de una entrada por fila.
+Con los puntajes ya en la matriz, los punteros de cada fila no dependen unos de otros y se calculan con un ciclo que el compilador vectoriza.
+Las entradas del vector que caen fuera de la matriz (antes de la columna 1, después de la última o debajo de la última fila)
+se calculan con valores cualesquiera y no se copian: ninguna entrada válida depende de ellas.
+Las operaciones (y su orden) son las mismas que en Score(), por lo que los puntajes y punteros son idénticos.
+ChooseScoreType() garantiza que los puntajes enteros no se desbordan.
+*/
+
+#define KERNEL_PASTE(name, suffix) name##suffix
+#define KERNEL_EXPAND(name, suffix) KERNEL_PASTE(name, suffix)
+#define KERNEL_BODY KERNEL_EXPAND(KERNEL_NAME, Body)
+
+__attribute__((target(KERNEL_TARGET), always_inline))
+static inline void KERNEL_BODY(A_Matrix *AlignMatrix, const int maximize)
+{
+#define STR1 str1
+#define STR2 str2
+#define VALUE(i,j) values[(size_t)(i)*cols + (j)]
+#define POINTERS(i,j) pointers[(size_t)(i)*cols + (j)]
+#define MM mm
+#define R r
+#define I ins
+#define D del
+	//Copias locales: las escrituras a los punteros (unsigned char) podrían apuntar a AlignMatrix y obligarían a releerlo en cada entrada
+	const char *str1=(AlignMatrix->Str1), *str2=(AlignMatrix->Str2);
+	SCORE_T *values=(SCORE_T *)(AlignMatrix->Values);
+	unsigned char *pointers=(AlignMatrix->Pointers);
+	const SCORE_T mm=(SCORE_T)(AlignMatrix->Scores)[0], r=(SCORE_T)(AlignMatrix->Scores)[1];
+	const SCORE_T ins=(SCORE_T)(AlignMatrix->Scores)[2], del=(SCORE_T)(AlignMatrix->Scores)[3];
+	const int rows=(AlignMatrix->Rows), cols=(AlignMatrix->Cols), len1=cols-1;
+	int r0, s, s0, s1, sb, s_end, i, j, j_lo, j_hi, k;
+	SCORE_T vd, vv, vh, best, lane_values[LANES];
+	SCORE_T *value_row, *up_row, *above;//Filas i e i-1 de la matriz, y la fila de arriba de la franja
+	unsigned char *pointer_row;
+	char c2;
+
+	//Str1 al revés y con LANES caracteres de relleno a cada lado, para que Str1[s-k-1] sea contiguo al recorrer las entradas del vector
+	char *rev1=(char *) malloc((len1+2*LANES) * sizeof(char));
+	assert(rev1 != NULL);
+	memset(rev1, 0, (len1+2*LANES) * sizeof(char));
+	for(k=0; k<len1; k++)
+		rev1[LANES+k]=STR1[len1-1-k];
+	char chars2[LANES];//Str2[r0+k-1], el caracter de la fila de cada entrada del vector (0 debajo de la última fila)
+
+	//Área de paso: SIMD_BAND_DIAGS pasos de la franja, uno tras otro; stage[(s-s0)*LANES + k] es la entrada (r0+k, s-k)
+	SCORE_T *stage=(SCORE_T *) calloc(SIMD_BAND_DIAGS * LANES, sizeof(SCORE_T));//En ceros: el último bloque puede transponer pasos que no calculó
+	assert(stage != NULL);
+
+	VEC vm=V_SET1(MM), vr=V_SET1(R), vi=V_SET1(I), vdel=V_SET1(D);
+	VEC cur, up, diag, pb;//Pasos s-1 (y su vecino de la izquierda), los vecinos de arriba del paso s y del paso s-1
+	VEC tile[LANES];//LANES pasos de la franja, transpuestos a LANES pedazos de fila
+	for(r0=1; r0<rows; r0+=LANES)//Franja de filas r0<=i<r0+LANES
+	{
+		for(k=0; k<LANES; k++)
+			chars2[k]=(r0+k < rows ? STR2[r0+k-1] : 0);
+		above=&VALUE(r0-1, 0);
+		s_end=(cols-1)+(LANES-1);//Último paso: la entrada LANES-1 llega a la última columna
+		//El paso 0 sólo tiene válida su entrada 0: la orilla (r0, 0) y, arriba de ella, (r0-1, 0)
+		cur=V_SHIFT_IN(V_SET1(0), VALUE(r0, 0)), up=V_SHIFT_IN(V_SET1(0), above[0]);
+		for(s0=1; s0<=s_end; s0+=SIMD_BAND_DIAGS)//Bloque de pasos s0<=s<s1 de la franja
+		{
+			s1=(s0+SIMD_BAND_DIAGS <= s_end ? s0+SIMD_BAND_DIAGS : s_end+1);
+			for(s=s0; s<s1; s++)
+			{
+				//Los vecinos de arriba: la entrada k-1 del paso anterior, la fila de arriba de la franja para la entrada 0
+				diag=up;
+				up=V_SHIFT_IN(cur, above[(s < cols ? s : 0)]);
+				pb=V_ADD(diag, V_BLEND(vr, vm, V_MATCH(chars2, rev1+LANES+len1-s)));
+				if(maximize)
+					pb=V_MAX(V_MAX(pb, V_ADD(up, vi)), V_ADD(cur, vdel));
+				else
+					pb=V_MIN(V_MIN(pb, V_ADD(up, vi)), V_ADD(cur, vdel));
+				V_STOREU(stage + (s-s0)*LANES, pb);
+				if(s < LANES && r0+s < rows)//La entrada s está en la columna 0, la orilla ya llena
+				{
+					stage[(s-s0)*LANES + s]=VALUE(r0+s, 0);
+					pb=V_LOADU(stage + (s-s0)*LANES);
+				}
+				cur=pb;
+			}
+			//Copia el bloque a la matriz: cada LANES pasos se transponen, la entrada k del paso sb+t queda en la entrada t de tile[k],
+			//que es la fila r0+k desde la columna sb-k. Las partes fuera de la matriz o del bloque se copian una a una
+			for(sb=s0; sb<s1; sb+=LANES)
+			{
+				for(k=0; k<LANES; k++)
+					tile[k]=V_LOADU(stage + (sb-s0+k)*LANES);
+				V_TRANSPOSE(tile);
+				for(k=0; k<LANES && r0+k<rows; k++)
+				{
+					value_row=&VALUE(r0+k, 0);
+					j_lo=sb-k, j_hi=(s1-1-k < cols-1 ? s1-1-k : cols-1);
+					if(j_lo >= 1 && j_lo+LANES-1 <= j_hi)
+						V_STOREU(value_row+j_lo, tile[k]);
+					else
+					{
+						V_STOREU(lane_values, tile[k]);
+						for(j=(j_lo > 1 ? j_lo : 1); j<=j_hi && j<j_lo+LANES; j++)
+							value_row[j]=lane_values[j-j_lo];
+					}
+				}
+			}
+			//Los punteros, fila por fila
+			for(k=0; k<LANES && r0+k<rows; k++)
+			{
+				i=r0+k;
+				j_lo=(s0-k > 1 ? s0-k : 1);
+				j_hi=(s1-1-k < cols-1 ? s1-1-k : cols-1);
+				value_row=&VALUE(i, 0), up_row=&VALUE(i-1, 0), pointer_row=&POINTERS(i, 0);
+				//Con los puntajes ya en su lugar, los punteros de la fila no dependen unos de otros (el compilador los vectoriza):
+				//se recalculan los candidatos con las mismas operaciones y se comparan con el puntaje elegido, como en Score()
+				c2=STR2[i-1];
+				for(j=j_lo; j<=j_hi; j++)
+				{
+					vd=up_row[j-1] + (STR1[j-1]!=c2 ? R : MM);
+					vv=up_row[j] + I;
+					vh=value_row[j-1] + D;
+					best=value_row[j];
+					pointer_row[j]=(vd==best)*DIAG_BIT | (vv==best)*VERT_BIT | (vh==best)*HORI_BIT;
+				}
+			}
+		}
+	}
+	free(rev1);
+	free(stage);
+#undef STR1
+#undef STR2
+#undef VALUE
+#undef POINTERS
+#undef MM
+#undef R
+#undef I
+#undef D
+}//___________________________________________________________
+
+
+
+__attribute__((target(KERNEL_TARGET)))
+void KERNEL_NAME(A_Matrix *AlignMatrix, const int maximize)
+//Una copia especializada del cuerpo para cada objetivo
+{
+	if(maximize)
+		KERNEL_BODY(AlignMatrix, 1);
+	else
+		KERNEL_BODY(AlignMatrix, 0);
+}//___________________________________________________________
+
+#undef KERNEL_PASTE
+#undef KERNEL_EXPAND
+#undef KERNEL_BODY
+#undef KERNEL_NAME
+#undef KERNEL_TARGET
+#undef SCORE_T
+#undef LANES
+#undef VEC
+#undef V_SET1
+#undef V_LOADU
+#undef V_STOREU
+#undef V_ADD
+#undef V_MIN
+#undef V_MAX
+#undef V_MATCH
+#undef V_BLEND
+#undef V_SHIFT_IN
+#undef V_TRANSPOSE
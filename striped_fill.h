@@ -0,0 +1,156 @@
+# ifndef STRING_ALIGN_STRIPED_FILL
+# define STRING_ALIGN_STRIPED_FILL
+/*
+===================================================
+Librería: Llenado vectorial rayado (alineamiento local).
+===================================================
+
+Motores vectoriales para llenar matrices de alineamiento local (Smith-Waterman, A_Matrix con AlignType "local")
+con el método rayado de Farrar, con instrucciones SSE4.1 o AVX2: cada columna de la matriz se calcula LANES filas a la vez,
+tomadas a distancia ceil(m/LANES) unas de otras, con un perfil de Str2 calculado una sola vez (ver striped_fill_kernel.h).
+Al mismo tiempo se busca la entrada con el mejor puntaje, desde donde empiezan los alineamientos locales óptimos.
+Producen exactamente los mismos puntajes y punteros que el llenado escalar local (ver scalar_fill.h).
+
+Sólo hay núcleos para puntajes enteros (int16 y int32) y sirven cuando las inserciones cuestan (I<0), que es lo que garantiza
+que la corrección de las inserciones entre segmentos termine; en otro caso FillAlignMatrix() usa el llenado escalar.
+
+Las siguientes son las funciones declaradas aquí:
+
+:int FillAlignMatrixStriped(A_Matrix *AlignMatrix):
+	Llena las entradas interiores de la matriz local AlignMatrix con el mejor motor rayado disponible y coloca
+	la mejor entrada en AlignMatrix->BestRow y BestCol. Devuelve 0 (sin llenar nada) si no se puede usar ningún motor.
+
+:void FillStripedAVX2Int16(A_Matrix *AlignMatrix):
+	Núcleo rayado con AVX2 y puntajes int16, 16 filas por instrucción.
+
+:void FillStripedAVX2Int32(A_Matrix *AlignMatrix):
+	Núcleo rayado con AVX2 y puntajes int32, 8 filas por instrucción.
+
+:void FillStripedSSE41Int16(A_Matrix *AlignMatrix):
+	Núcleo rayado con SSE4.1 y puntajes int16, 8 filas por instrucción.
+
+:void FillStripedSSE41Int32(A_Matrix *AlignMatrix):
+	Núcleo rayado con SSE4.1 y puntajes int32, 4 filas por instrucción.
+
+
+Los prototipos de las funciones y las estructuras están declarados en el archivo alignments_headers.h
+
+Los algoritmos están basados en:
+	*Identification of common molecular subsequences*
+	Temple F. Smith y Michael S. Waterman, Journal of Molecular Biology 147 (1981)
+	*Striped Smith-Waterman speeds database searches six times over other SIMD implementations*
+	Michael Farrar, Bioinformatics 23(2) (2007)
+
+:Autor:
+	Andrés García García @ 28/Feb/'16 (Inicio 19 Oct 2015)
+*/
+
+//Librerías
+# include <stdio.h>
+# include <assert.h>//Para verificar errores con la función assert()
+# include <stdlib.h>//Para usar malloc(), calloc(), free()
+# include <string.h>//Para usar memcpy()
+# include <immintrin.h>//Para las instrucciones SSE4.1 y AVX2
+# include "alignments_headers.h"
+//Definiciones globales
+#define STRIPED_COLS 64 //Columnas que se acumulan en el área de paso antes de copiarlas a la matriz
+
+
+/*
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Núcleos rayados (generados con striped_fill_kernel.h).
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+
+//____________________AVX2, int16: 16 filas por vector___________________________
+#define KERNEL_NAME FillStripedAVX2Int16
+#define KERNEL_TARGET "avx2"
+#define SCORE_T short
+#define LANES 16
+#define VEC __m256i
+#define V_SET1(x) _mm256_set1_epi16(x)
+#define V_LOADU(p) _mm256_loadu_si256((const __m256i *)(p))
+#define V_STOREU(p, v) _mm256_storeu_si256((__m256i *)(p), v)
+#define V_ADD(a, b) _mm256_add_epi16(a, b)
+#define V_MAX(a, b) _mm256_max_epi16(a, b)
+#define V_SHIFT(v) _mm256_alignr_epi8(v, _mm256_permute2x128_si256(v, v, 0x08), 16-sizeof(short))
+#define V_ANY_GT(a, b) _mm256_movemask_epi8(_mm256_cmpgt_epi16(a, b))
+# include "striped_fill_kernel.h"
+
+//____________________AVX2, int32: 8 filas por vector___________________________
+#define KERNEL_NAME FillStripedAVX2Int32
+#define KERNEL_TARGET "avx2"
+#define SCORE_T int
+#define LANES 8
+#define VEC __m256i
+#define V_SET1(x) _mm256_set1_epi32(x)
+#define V_LOADU(p) _mm256_loadu_si256((const __m256i *)(p))
+#define V_STOREU(p, v) _mm256_storeu_si256((__m256i *)(p), v)
+#define V_ADD(a, b) _mm256_add_epi32(a, b)
+#define V_MAX(a, b) _mm256_max_epi32(a, b)
+#define V_SHIFT(v) _mm256_alignr_epi8(v, _mm256_permute2x128_si256(v, v, 0x08), 16-sizeof(int))
+#define V_ANY_GT(a, b) _mm256_movemask_epi8(_mm256_cmpgt_epi32(a, b))
+# include "striped_fill_kernel.h"
+
+//____________________SSE4.1, int16: 8 filas por vector___________________________
+#define KERNEL_NAME FillStripedSSE41Int16
+#define KERNEL_TARGET "sse4.1"
+#define SCORE_T short
+#define LANES 8
+#define VEC __m128i
+#define V_SET1(x) _mm_set1_epi16(x)
+#define V_LOADU(p) _mm_loadu_si128((const __m128i *)(p))
+#define V_STOREU(p, v) _mm_storeu_si128((__m128i *)(p), v)
+#define V_ADD(a, b) _mm_add_epi16(a, b)
+#define V_MAX(a, b) _mm_max_epi16(a, b)
+#define V_SHIFT(v) _mm_slli_si128(v, sizeof(short))
+#define V_ANY_GT(a, b) _mm_movemask_epi8(_mm_cmpgt_epi16(a, b))
+# include "striped_fill_kernel.h"
+
+//____________________SSE4.1, int32: 4 filas por vector___________________________
+#define KERNEL_NAME FillStripedSSE41Int32
+#define KERNEL_TARGET "sse4.1"
+#define SCORE_T int
+#define LANES 4
+#define VEC __m128i
+#define V_SET1(x) _mm_set1_epi32(x)
+#define V_LOADU(p) _mm_loadu_si128((const __m128i *)(p))
+#define V_STOREU(p, v) _mm_storeu_si128((__m128i *)(p), v)
+#define V_ADD(a, b) _mm_add_epi32(a, b)
+#define V_MAX(a, b) _mm_max_epi32(a, b)
+#define V_SHIFT(v) _mm_slli_si128(v, sizeof(int))
+#define V_ANY_GT(a, b) _mm_movemask_epi8(_mm_cmpgt_epi32(a, b))
+# include "striped_fill_kernel.h"
+
+
+
+/*
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Selección del motor rayado.
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+
+int FillAlignMatrixStriped(A_Matrix *AlignMatrix)
+/*
+ * Llena las entradas interiores de la matriz local AlignMatrix (las orillas deben estar llenas con 0) con el mejor motor rayado disponible.
+ * Si AlignMatrix->Engine es "sse4.1" usa ese motor, si no, el mejor disponible (ver BestSIMDEngine()). El núcleo se elige según AlignMatrix->ScoreType.
+ * Coloca en AlignMatrix->Engine el nombre del motor usado y en AlignMatrix->BestRow y BestCol la mejor entrada.
+ * Devuelve 0 (sin llenar nada) si no hay motor vectorial, si los puntajes no son enteros, si las inserciones no cuestan (I>=0) o si la matriz no tiene interior.
+ */
+{
+	const char *engine=BestSIMDEngine();
+	if(engine == NULL || (AlignMatrix->ScoreType) == SCORE_FLOAT || (AlignMatrix->Scores)[2] >= 0
+		|| (AlignMatrix->Rows) < 2 || (AlignMatrix->Cols) < 2)
+		return 0;
+	if((AlignMatrix->Engine) != NULL && equStr(AlignMatrix->Engine, "sse4.1"))
+		engine="sse4.1";//Se pidió explícitamente el motor SSE4.1 (todo procesador con AVX2 soporta SSE4.1)
+	int avx2=equStr(engine, "avx2");
+	if((AlignMatrix->ScoreType) == SCORE_INT16)
+		(avx2 ? FillStripedAVX2Int16 : FillStripedSSE41Int16)(AlignMatrix);
+	else
+		(avx2 ? FillStripedAVX2Int32 : FillStripedSSE41Int32)(AlignMatrix);
+	(AlignMatrix->Engine)=(avx2 ? "striped-avx2" : "striped-sse4.1");
+	return 1;
+}//___________________________________________________________
+#undef STRIPED_COLS
+# endif
@@ -0,0 +1,167 @@
+/*
+==================================================================
+Plantilla: Núcleo vectorial rayado para el alineamiento local (striped_fill_kernel.h).
+==================================================================
+
+Este archivo NO tiene guardas de inclusión: se incluye desde striped_fill.h una vez por cada conjunto de instrucciones
+y tipo de puntaje, definiendo antes las siguientes macros, y genera la función KERNEL_NAME(A_Matrix *AlignMatrix).
+Al final elimina (#undef) todas las macros, para poder incluirse de nuevo con otras definiciones.
+
+	KERNEL_NAME		Nombre de la función generada.
+	KERNEL_TARGET	Conjunto de instrucciones para __attribute__((target(...))), p. ej. "avx2".
+	SCORE_T			Tipo de los puntajes (short o int), debe coincidir con AlignMatrix->ScoreType.
+	LANES			Número de entradas por vector.
+	VEC				Tipo del vector de puntajes.
+	V_SET1(x)		Vector con todas sus entradas iguales a x.
+	V_LOADU(p)		Carga LANES puntajes desde p (sin alinear).
+	V_STOREU(p, v)	Guarda LANES puntajes en p (sin alinear).
+	V_ADD(a, b)		Suma entrada por entrada.
+	V_MAX(a, b)		a>b ? a : b, entrada por entrada (igual que la macro MAX).
+	V_SHIFT(v)		Recorre las entradas una posición hacia arriba (la entrada k pasa a la k+1) y coloca 0 en la primera.
+	V_ANY_GT(a, b)	Verdadero si alguna entrada de a es mayor que la de b.
+
+La matriz se llena columna por columna (Farrar). Str2 (las filas) se reparte en LANES segmentos de seg=ceil(m/LANES) filas:
+el vector s de una columna tiene las filas s, seg+s, 2*seg+s, ..., por lo que las entradas de un vector nunca dependen
+unas de otras dentro de la misma columna, salvo por las inserciones (puntero vertical) que pasan de un segmento al siguiente.
+Éstas se calculan primero sólo dentro de cada segmento y luego se corrigen (el ciclo "lazy-F") recorriendo la columna mientras
+alguna inserción mejore alguna entrada; con inserciones de costo negativo casi siempre basta con revisar unos pocos vectores.
+El perfil de Str2 (los puntajes de apareamiento o reemplazo de cada fila contra cada caracter de Str1, ya en el orden rayado)
+se calcula una sola vez, así que cada columna sólo lee un vector del perfil por vector de puntajes.
+Los puntajes del perfil son los de PairScore(), con M y R o con la matriz de sustitución AlignMatrix->Subst.
+Las filas que sobran al final del último segmento se tratan como un caracter que no coincide con nada: nunca afectan a las filas reales.
+
+Las columnas rayadas se acumulan en un área de paso de STRIPED_COLS columnas y se copian a AlignMatrix->Values fila por fila,
+buscando al mismo tiempo la entrada con el mejor puntaje (la primera por columnas, igual que FindBestEntry()), que se guarda
+en AlignMatrix->BestRow y BestCol. Con los puntajes ya en la matriz, los punteros de cada fila se calculan con el perfil de Str1 de FillAlignMatrix() (ver BuildProfile()).
+Las operaciones son las mismas que en Score() para el alineamiento local, por lo que los puntajes y punteros son idénticos.
+*/
+
+__attribute__((target(KERNEL_TARGET)))
+void KERNEL_NAME(A_Matrix *AlignMatrix)
+{
+#define STR1 str1
+#define STR2 str2
+#define VALUE(i,j) values[(size_t)(i)*cols + (j)]
+#define POINTERS(i,j) pointers[(size_t)(i)*cols + (j)]
+#define I ins
+#define D del
+#define COLUMN(c) (stage + (size_t)(c)*seg*LANES) //Columna c del área de paso, en orden rayado
+	//Copias locales: las escrituras a los punteros (unsigned char) podrían apuntar a AlignMatrix y obligarían a releerlo en cada entrada
+	const char *str1=(AlignMatrix->Str1), *str2=(AlignMatrix->Str2);
+	SCORE_T *values=(SCORE_T *)(AlignMatrix->Values);
+	unsigned char *pointers=(AlignMatrix->Pointers);
+	const SCORE_T pad=(SCORE_T)((AlignMatrix->Subst) != NULL ? (AlignMatrix->Subst)->Min : (AlignMatrix->Scores)[1]);//Filas de relleno
+	const SCORE_T ins=(SCORE_T)(AlignMatrix->Scores)[2], del=(SCORE_T)(AlignMatrix->Scores)[3];
+	const int rows=(AlignMatrix->Rows), cols=(AlignMatrix->Cols), len1=cols-1, len2=rows-1;
+	const int seg=(len2 + LANES-1)/LANES;//Vectores por columna
+	int i, j, j0, j1, c, s, l, k, sigma, best_i=0, best_j=0;
+	int alpha[256];//Índice de cada caracter de Str1 en el perfil, -1 si no aparece
+	SCORE_T vd, vv, vh, best, score=0;
+	SCORE_T *value_row, *up_row, *prev, *cur;
+	const SCORE_T *prof, *prof_row;
+	unsigned char *pointer_row;
+
+	//Perfil: una columna rayada de puntajes por cada caracter distinto de Str1
+	for(k=0; k<256; k++)
+		alpha[k]=-1;
+	for(j=0, sigma=0; j<len1; j++)
+		if(alpha[(unsigned char)STR1[j]] < 0)
+			alpha[(unsigned char)STR1[j]]=sigma++;
+	SCORE_T *profile=(SCORE_T *) malloc((size_t)sigma * seg * LANES * sizeof(SCORE_T));
+	assert(profile != NULL);
+	for(k=0; k<256; k++)
+	{
+		if(alpha[k] < 0)
+			continue;
+		for(s=0; s<seg; s++)
+			for(l=0; l<LANES; l++)
+			{
+				i=l*seg + s;//Fila i+1 de la matriz
+				profile[((size_t)alpha[k]*seg + s)*LANES + l]=(i < len2 ? (SCORE_T)PairScore(AlignMatrix, (char)k, STR2[i]) : pad);
+			}
+	}
+
+	//Área de paso: la columna anterior (columna 0) y STRIPED_COLS columnas nuevas
+	SCORE_T *stage=(SCORE_T *) calloc((size_t)(STRIPED_COLS+1) * seg * LANES, sizeof(SCORE_T));//La columna 0 de la matriz vale 0
+	assert(stage != NULL);
+
+	VEC vzero=V_SET1(0), vins=V_SET1(I), vdel=V_SET1(D);
+	VEC vH, vF, vC;
+	for(j0=1; j0<cols; j0+=STRIPED_COLS)//Bloque de columnas j0<=j<j1
+	{
+		j1=(j0+STRIPED_COLS < cols ? j0+STRIPED_COLS : cols);
+		if(j0 > 1)//La última columna del bloque anterior pasa al principio del área de paso
+			memcpy(COLUMN(0), COLUMN(STRIPED_COLS), (size_t)seg*LANES*sizeof(SCORE_T));
+		for(j=j0, c=1; j<j1; j++, c++)
+		{
+			prev=COLUMN(c-1), cur=COLUMN(c);
+			prof=profile + (size_t)alpha[(unsigned char)STR1[j-1]]*seg*LANES;
+			vF=vzero;//Con puntajes no negativos, una inserción desde arriba de la fila 1 nunca mejora nada
+			vH=V_SHIFT(V_LOADU(prev + (size_t)(seg-1)*LANES));//Diagonal del primer vector: la fila anterior de cada segmento
+			for(s=0; s<seg; s++)
+			{
+				vH=V_ADD(vH, V_LOADU(prof + (size_t)s*LANES));//Apareamiento o reemplazo
+				vH=V_MAX(vH, V_ADD(V_LOADU(prev + (size_t)s*LANES), vdel));//Deleción
+				vH=V_MAX(vH, vF);//Inserción, dentro del segmento
+				vH=V_MAX(vH, vzero);//El alineamiento local puede empezar aquí
+				V_STOREU(cur + (size_t)s*LANES, vH);
+				vF=V_ADD(vH, vins);
+				vH=V_LOADU(prev + (size_t)s*LANES);//Diagonal del siguiente vector
+			}
+			//Inserciones que pasan de un segmento al siguiente (lazy-F)
+			vF=V_SHIFT(vF);
+			for(s=0; V_ANY_GT(vF, vC=V_LOADU(cur + (size_t)s*LANES)); )
+			{
+				V_STOREU(cur + (size_t)s*LANES, V_MAX(vC, vF));
+				vF=V_ADD(vF, vins);
+				if(++s == seg)
+					s=0, vF=V_SHIFT(vF);
+			}
+		}
+		//Copia el bloque a la matriz fila por fila: la fila i está en el vector (i-1)%seg, entrada (i-1)/seg, de cada columna
+		for(i=1; i<rows; i++)
+		{
+			s=(i-1) % seg, l=(i-1) / seg;
+			value_row=&VALUE(i, 0), up_row=&VALUE(i-1, 0), pointer_row=&POINTERS(i, 0);
+			for(j=j0, c=1; j<j1; j++, c++)
+			{
+				value_row[j]=COLUMN(c)[(size_t)s*LANES + l];
+				if(value_row[j] > score || (value_row[j] == score && j < best_j))//La primera por columnas (ver FindBestEntry())
+					score=value_row[j], best_i=i, best_j=j;
+			}
+			//Los punteros de la fila no dependen unos de otros (el compilador los vectoriza), como en Score() para el alineamiento local
+			prof_row=(const SCORE_T *)(AlignMatrix->Profile) + (size_t)(AlignMatrix->ProfileRow)[(unsigned char)STR2[i-1]]*cols;
+			for(j=j0; j<j1; j++)
+			{
+				vd=up_row[j-1] + prof_row[j];
+				vv=up_row[j] + I;
+				vh=value_row[j-1] + D;
+				best=value_row[j];
+				pointer_row[j]=(best > 0)*((vd==best)*DIAG_BIT | (vv==best)*VERT_BIT | (vh==best)*HORI_BIT);
+			}
+		}
+	}
+	(AlignMatrix->BestRow)=best_i, (AlignMatrix->BestCol)=best_j;
+	free(profile);
+	free(stage);
+#undef STR1
+#undef STR2
+#undef VALUE
+#undef POINTERS
+#undef I
+#undef D
+#undef COLUMN
+}//___________________________________________________________
+
+#undef KERNEL_NAME
+#undef KERNEL_TARGET
+#undef SCORE_T
+#undef LANES
+#undef VEC
+#undef V_SET1
+#undef V_LOADU
+#undef V_STOREU
+#undef V_ADD
+#undef V_MAX
+#undef V_SHIFT
+#undef V_ANY_GT
@@ -0,0 +1,345 @@
+# ifndef STRING_ALIGN_SUBST_MATRIX
+# define STRING_ALIGN_SUBST_MATRIX
+/*
+=========================================
+Librería: Matrices de sustitución.
+=========================================
+
+Puntajes de apareamiento y reemplazo dados por una matriz de sustitución (BLOSUM, PAM o cualquier otra) en lugar de M y R:
+alinear el caracter a de Str1 con el b de Str2 vale S(a,b). Los costos de inserción y deleción siguen siendo I y D.
+La matriz se lee en el formato de NCBI: líneas de comentario que empiezan con '#', una línea con los símbolos de las columnas
+y una línea por símbolo con su puntaje contra cada columna. Las letras minúsculas que no están en la matriz usan la mayúscula,
+y cualquier otro caracter que no esté en la matriz vale el mínimo de la matriz contra todo (incluso contra sí mismo).
+La matriz BLOSUM62 está incluida, cualquier otra (como PAM250) se lee de un archivo.
+
+Para que el llenado no busque en la matriz (ni compare caracteres) en cada entrada, FillAlignMatrix() calcula una sola vez
+el perfil de Str1 (ver BuildProfile()): una fila de Cols puntajes, ya del tipo AlignMatrix->ScoreType, por cada caracter distinto de Str2.
+Los núcleos de llenado toman la fila del caracter de Str2 y el puntaje diagonal de la entrada (i,j) es sólo una lectura, sin saltos.
+Sin matriz de sustitución el perfil se calcula con M y R, por lo que los núcleos son los mismos en ambos casos.
+
+Esta librería utiliza la siguiente estructura como base::
+
+		typedef struct S_Matrix_struct
+		// Matriz de sustitución: el puntaje de alinear cada par de caracteres
+		{
+			char *Name;//Nombre de la matriz ("BLOSUM62" o el archivo de donde se leyó)
+			int Size;//Número de símbolos más uno, el último índice es el de los caracteres que no están en la matriz
+			int Index[256];//Índice de cada caracter en la tabla
+			float *Table;//Table[Index[a]*Size + Index[b]] es el puntaje de alinear el caracter a de Str1 con el b de Str2
+			float Max, Min;//El mayor y el menor puntaje de la tabla
+			int Integer;//Verdadero si todos los puntajes son enteros
+
+		} S_Matrix;
+		//___________________________________________________________
+
+
+Las siguientes son las funciones declaradas aquí:
+
+:S_Matrix *LoadSubstMatrix(const char *name):
+	La matriz de sustitución incluida con ese nombre ("BLOSUM62") o la leída del archivo name. Devuelve NULL si no se pudo leer.
+
+:S_Matrix *ParseSubstMatrix(const char *text, const char *name):
+	La matriz de sustitución escrita en text con el formato de NCBI. Devuelve NULL si el formato no es correcto.
+
+:void FreeSubstMatrix(S_Matrix *subst):
+	Libera el espacio de una matriz de sustitución alojada con LoadSubstMatrix().
+
+:void SetSubstMatrix(A_Matrix *AlignMatrix, const S_Matrix *subst):
+	Usa la matriz de sustitución subst para los apareamientos y reemplazos de AlignMatrix (sin llenar), ajustando el tipo de sus puntajes.
+
+:float PairScore(const A_Matrix *AlignMatrix, const char c1, const char c2):
+	El puntaje de alinear el caracter c1 de Str1 con el c2 de Str2: el de la matriz de sustitución, o M o R si no hay.
+
+:void BuildProfile(A_Matrix *AlignMatrix):
+	Calcula el perfil de Str1 contra cada caracter distinto de Str2, con el tipo de puntaje de AlignMatrix.
+
+:void FreeProfile(A_Matrix *AlignMatrix):
+	Libera el perfil de AlignMatrix.
+
+
+Los prototipos de las funciones y las estructuras están declarados en el archivo alignments_headers.h
+
+Las matrices están basadas en:
+	*Amino acid substitution matrices from protein blocks*
+	Steven Henikoff y Jorja G. Henikoff, PNAS 89(22) (1992)
+
+:Autor:
+	Andrés García García @ 28/Feb/'16 (Inicio 19 Oct 2015)
+*/
+
+//Librerías
+# include <stdio.h>
+# include <assert.h>//Para verificar errores con la función assert()
+# include <stdlib.h>//Para usar malloc(), free(), strtof()
+# include <ctype.h>//Para usar isspace(), toupper()
+# include <sys/stat.h>//Para usar fstat()
+# include "alignments_headers.h"
+
+//Matriz BLOSUM62 en el formato de NCBI
+static const char BLOSUM62[]=
+	"   A  R  N  D  C  Q  E  G  H  I  L  K  M  F  P  S  T  W  Y  V  B  Z  X  *\n"
+	"A  4 -1 -2 -2  0 -1 -1  0 -2 -1 -1 -1 -1 -2 -1  1  0 -3 -2  0 -2 -1  0 -4\n"
+	"R -1  5  0 -2 -3  1  0 -2  0 -3 -2  2 -1 -3 -2 -1 -1 -3 -2 -3 -1  0 -1 -4\n"
+	"N -2  0  6  1 -3  0  0  0  1 -3 -3  0 -2 -3 -2  1  0 -4 -2 -3  3  0 -1 -4\n"
+	"D -2 -2  1  6 -3  0  2 -1 -1 -3 -4 -1 -3 -3 -1  0 -1 -4 -3 -3  4  1 -1 -4\n"
+	"C  0 -3 -3 -3  9 -3 -4 -3 -3 -1 -1 -3 -1 -2 -3 -1 -1 -2 -2 -1 -3 -3 -2 -4\n"
+	"Q -1  1  0  0 -3  5  2 -2  0 -3 -2  1  0 -3 -1  0 -1 -2 -1 -2  0  3 -1 -4\n"
+	"E -1  0  0  2 -4  2  5 -2  0 -3 -3  1 -2 -3 -1  0 -1 -3 -2 -2  1  4 -1 -4\n"
+	"G  0 -2  0 -1 -3 -2 -2  6 -2 -4 -4 -2 -3 -3 -2  0 -2 -2 -3 -3 -1 -2 -1 -4\n"
+	"H -2  0  1 -1 -3  0  0 -2  8 -3 -3 -1 -2 -1 -2 -1 -2 -2  2 -3  0  0 -1 -4\n"
+	"I -1 -3 -3 -3 -1 -3 -3 -4 -3  4  2 -3  1  0 -3 -2 -1 -3 -1  3 -3 -3 -1 -4\n"
+	"L -1 -2 -3 -4 -1 -2 -3 -4 -3  2  4 -2  2  0 -3 -2 -1 -2 -1  1 -4 -3 -1 -4\n"
+	"K -1  2  0 -1 -3  1  1 -2 -1 -3 -2  5 -1 -3 -1  0 -1 -3 -2 -2  0  1 -1 -4\n"
+	"M -1 -1 -2 -3 -1  0 -2 -3 -2  1  2 -1  5  0 -2 -1 -1 -1 -1  1 -3 -1 -1 -4\n"
+	"F -2 -3 -3 -3 -2 -3 -3 -3 -1  0  0 -3  0  6 -4 -2 -2  1  3 -1 -3 -3 -1 -4\n"
+	"P -1 -2 -2 -1 -3 -1 -1 -2 -2 -3 -3 -1 -2 -4  7 -1 -1 -4 -3 -2 -2 -1 -2 -4\n"
+	"S  1 -1  1  0 -1  0  0  0 -1 -2 -2  0 -1 -2 -1  4  1 -3 -2 -2  0  0  0 -4\n"
+	"T  0 -1  0 -1 -1 -1 -1 -2 -2 -1 -1 -1 -1 -2 -1  1  5 -2 -2  0 -1 -1  0 -4\n"
+	"W -3 -3 -4 -4 -2 -2 -3 -2 -2 -3 -2 -3 -1  1 -4 -3 -2 11  2 -3 -4 -3 -2 -4\n"
+	"Y -2 -2 -2 -3 -2 -1 -2 -3  2 -1 -1 -2 -1  3 -3 -2 -2  2  7 -1 -3 -2 -1 -4\n"
+	"V  0 -3 -3 -3 -1 -2 -2 -3 -3  3  1 -2  1 -1 -2 -2  0 -3 -1  4 -3 -2 -1 -4\n"
+	"B -2 -1  3  4 -3  0  1 -1  0 -3 -4  0 -3 -3 -2  0 -1 -4 -3 -3  4  1 -1 -4\n"
+	"Z -1  0  0  1 -3  3  4 -2  0 -3 -3  1 -1 -3 -1  0 -1 -3 -2 -2  1  4 -1 -4\n"
+	"X  0 -1 -1 -1 -2 -1 -1 -1 -1 -1 -1 -1 -1 -1 -2  0  0 -2 -1 -1 -1 -1 -1 -4\n"
+	"* -4 -4 -4 -4 -4 -4 -4 -4 -4 -4 -4 -4 -4 -4 -4 -4 -4 -4 -4 -4 -4 -4 -4  1\n";
+
+
+/*
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Funciones para las matrices de sustitución.
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+
+S_Matrix *LoadSubstMatrix(const char *name)
+/*
+ * Devuelve la matriz de sustitución incluida con ese nombre ("BLOSUM62", en mayúsculas o minúsculas) o, si no, la lee del archivo name.
+ * Si el archivo no se puede abrir, no es un archivo regular (p. ej. un directorio, donde ftell() no da un tamaño)
+ * o no se puede leer completo, o si su formato no es correcto, imprime una advertencia y devuelve NULL.
+ */
+{
+	if(equStr(name, "BLOSUM62") || equStr(name, "blosum62"))
+		return ParseSubstMatrix(BLOSUM62, "BLOSUM62");
+	FILE *file=fopen(name, "r");
+	struct stat st;
+	if(file == NULL || fstat(fileno(file), &st) != 0 || !S_ISREG(st.st_mode))
+	{
+		printf("\nADVERTENCIA: No se pudo abrir la matriz de sustitución \"%s\"\n", name);
+		if(file != NULL)
+			fclose(file);
+		return NULL;
+	}
+	//Lee todo el archivo
+	long size=(fseek(file, 0, SEEK_END) == 0 ? ftell(file) : -1);
+	char *text=(size >= 0 && fseek(file, 0, SEEK_SET) == 0 ? (char *) malloc((size_t)size+1) : NULL);
+	if(text == NULL || fread(text, 1, (size_t)size, file) != (size_t)size)
+	{
+		printf("\nADVERTENCIA: No se pudo leer la matriz de sustitución \"%s\"\n", name);
+		free(text);
+		fclose(file);
+		return NULL;
+	}
+	text[size]='\0';
+	fclose(file);
+	S_Matrix *subst=ParseSubstMatrix(text, name);
+	free(text);
+	return subst;
+}//___________________________________________________________
+
+
+
+S_Matrix *ParseSubstMatrix(const char *text, const char *name)
+/*
+ * Lee la matriz de sustitución text en el formato de NCBI: se ignoran las líneas vacías y las que empiezan con '#',
+ * la primera de las demás tiene los n símbolos de las columnas y cada una de las siguientes un símbolo seguido de sus n puntajes.
+ * Todos los símbolos del encabezado deben tener su fila. Si el formato no es correcto imprime una advertencia y devuelve NULL.
+ */
+{
+	char symbols[256], symbol;
+	int n=0, filled=0, row, col, c;
+	const char *line, *p;
+	char *end;
+	float *table=NULL;
+	for(line=text; *line != '\0'; line=(*p == '\n' ? p+1 : p))
+	{
+		for(p=line; *p != '\n' && *p != '\0' && isspace((unsigned char)*p); p++);//Salta los espacios iniciales
+		if(*p == '#' || *p == '\n' || *p == '\0')
+		{
+			for(; *p != '\n' && *p != '\0'; p++);
+			continue;//Comentario o línea vacía
+		}
+		if(table == NULL)//El encabezado: un símbolo por columna
+		{
+			for(; *p != '\n' && *p != '\0'; p++)
+				if(!isspace((unsigned char)*p) && n < 256)
+					symbols[n++]=*p;
+			table=(float *) malloc((size_t)n*n * sizeof(float));
+			assert(table != NULL);
+			continue;
+		}
+		//Una fila: su símbolo y sus n puntajes
+		symbol=*p;
+		for(row=0; row<n && symbols[row] != symbol; row++);
+		for(p++, col=0; row<n && col<n; col++, p=end)
+		{
+			for(; *p != '\n' && *p != '\0' && isspace((unsigned char)*p); p++);//Sin pasar a la siguiente línea
+			table[row*n + col]=strtof(p, &end);
+			if(end == p)
+				break;//Faltan puntajes
+		}
+		if(row == n || col < n)
+		{
+			printf("\nADVERTENCIA: La matriz de sustitución \"%s\" no tiene el formato esperado (fila \"%c\")\n", name, symbol);
+			free(table);
+			return NULL;
+		}
+		filled++;
+		for(; *p != '\n' && *p != '\0'; p++);
+	}
+	if(n == 0 || filled < n)
+	{
+		printf("\nADVERTENCIA: La matriz de sustitución \"%s\" no tiene el formato esperado (%d de %d filas)\n", name, filled, n);
+		free(table);
+		return NULL;
+	}
+
+	//La tabla final, con un índice más para los caracteres que no están en la matriz
+	S_Matrix *subst=(S_Matrix *) malloc(sizeof(S_Matrix));
+	assert(subst != NULL);
+	(subst->Name)=dupStr(name);
+	(subst->Size)=n+1;
+	(subst->Table)=(float *) malloc((size_t)(n+1)*(n+1) * sizeof(float));
+	assert((subst->Table) != NULL);
+	(subst->Max)=table[0], (subst->Min)=table[0], (subst->Integer)=1;
+	for(row=0; row<n; row++)
+		for(col=0; col<n; col++)
+		{
+			(subst->Table)[row*(n+1) + col]=table[row*n + col];
+			(subst->Max)=MAX((subst->Max), table[row*n + col]);
+			(subst->Min)=MIN((subst->Min), table[row*n + col]);
+			if(table[row*n + col] != (float)(long)table[row*n + col])
+				(subst->Integer)=0;
+		}
+	for(row=0; row<=n; row++)
+		(subst->Table)[row*(n+1) + n]=(subst->Min), (subst->Table)[n*(n+1) + row]=(subst->Min);
+	free(table);
+	for(c=0; c<256; c++)
+		(subst->Index)[c]=n;
+	for(row=n-1; row>=0; row--)
+		(subst->Index)[(unsigned char)symbols[row]]=row;
+	for(c=0; c<256; c++)//Las minúsculas que no están en la matriz usan la mayúscula
+		if((subst->Index)[c] == n && islower(c))
+			(subst->Index)[c]=(subst->Index)[toupper(c)];
+	return subst;
+}//___________________________________________________________
+
+
+
+void FreeSubstMatrix(S_Matrix *subst)
+// Libera el espacio de la matriz de sustitución subst.
+{
+	if(subst == NULL)
+		return;
+	free(subst->Name);
+	free(subst->Table);
+	free(subst);
+}//___________________________________________________________
+
+
+
+void SetSubstMatrix(A_Matrix *AlignMatrix, const S_Matrix *subst)
+/*
+ * Usa la matriz de sustitución subst (NULL para volver a M y R) en los apareamientos y reemplazos de AlignMatrix, que aún no se ha llenado.
+ * El tipo de los puntajes se vuelve a elegir como en ChooseScoreType(), con el mayor y el menor puntaje de la matriz en lugar de M y R,
+ * y si cambia se vuelven a alojar las entradas.
+ */
+{
+	int score_type;
+	(AlignMatrix->Subst)=subst;
+	if(subst == NULL)
+		score_type=ChooseScoreType(AlignMatrix->Scores, (AlignMatrix->Cols)-1, (AlignMatrix->Rows)-1);
+	else
+	{
+		float costs[4]={(subst->Max), (subst->Min), (AlignMatrix->Scores)[2], (AlignMatrix->Scores)[3]};
+		score_type=((subst->Integer) ? ChooseScoreType(costs, (AlignMatrix->Cols)-1, (AlignMatrix->Rows)-1) : SCORE_FLOAT);
+	}
+	if(score_type != (AlignMatrix->ScoreType))
+	{
+		(AlignMatrix->ScoreType)=score_type;
+		SetMatrixBand(AlignMatrix, AlignMatrix->Band);//Las entradas con el nuevo tamaño
+	}
+}//___________________________________________________________
+
+
+
+float PairScore(const A_Matrix *AlignMatrix, const char c1, const char c2)
+/*
+ * El puntaje de alinear el caracter c1 de Str1 con el c2 de Str2: S(c1,c2) si AlignMatrix tiene matriz de sustitución,
+ * si no, M=(AlignMatrix->Scores)[0] si son iguales y R=(AlignMatrix->Scores)[1] si no.
+ */
+{
+	const S_Matrix *subst=(AlignMatrix->Subst);
+	if(subst == NULL)
+		return (c1 != c2 ? (AlignMatrix->Scores)[1] : (AlignMatrix->Scores)[0]);
+	return (subst->Table)[(subst->Index)[(unsigned char)c1]*(subst->Size) + (subst->Index)[(unsigned char)c2]];
+}//___________________________________________________________
+
+
+
+void BuildProfile(A_Matrix *AlignMatrix)
+/*
+ * Calcula el perfil de Str1: para cada caracter c distinto de Str2, la fila ProfileRow[c] del perfil tiene en su posición j (1<=j<Cols)
+ * el puntaje PairScore(Str1[j-1], c), ya convertido al tipo AlignMatrix->ScoreType. La fila de la entrada (i,j) es la de Str2[i-1],
+ * así que los núcleos leen el puntaje diagonal sin comparar caracteres. Si ya había un perfil, lo reemplaza.
+ */
+{
+#define STR1 (AlignMatrix->Str1)
+#define STR2 (AlignMatrix->Str2)
+	int rows=(AlignMatrix->Rows), cols=(AlignMatrix->Cols);
+	int i, j, c, sigma=0;
+	size_t k;
+	FreeProfile(AlignMatrix);
+	int *profile_row=(int *) malloc(256 * sizeof(int));
+	assert(profile_row != NULL);
+	for(c=0; c<256; c++)
+		profile_row[c]=-1;
+	for(i=1; i<rows; i++)//Una fila por cada caracter distinto de Str2
+		if(profile_row[(unsigned char)STR2[i-1]] < 0)
+			profile_row[(unsigned char)STR2[i-1]]=sigma++;
+	void *profile=malloc(((size_t)sigma*cols + 1) * ScoreTypeSize(AlignMatrix->ScoreType));
+	assert(profile != NULL);
+	for(c=0; c<256; c++)
+	{
+		if(profile_row[c] < 0)
+			continue;
+		for(j=0; j<cols; j++)
+		{
+			k=(size_t)profile_row[c]*cols + j;
+			float score=(j == 0 ? 0 : PairScore(AlignMatrix, STR1[j-1], (char)c));//La columna 0 no se usa
+			switch(AlignMatrix->ScoreType)
+			{
+				case SCORE_INT16:
+					((short *)profile)[k]=(short)score;
+					break;
+				case SCORE_INT32:
+					((int *)profile)[k]=(int)score;
+					break;
+				default:
+					((float *)profile)[k]=score;
+			}
+		}
+	}
+	(AlignMatrix->Profile)=profile, (AlignMatrix->ProfileRow)=profile_row;
+#undef STR1
+#undef STR2
+}//___________________________________________________________
+
+
+
+void FreeProfile(A_Matrix *AlignMatrix)
+// Libera el perfil de AlignMatrix (si lo tiene).
+{
+	free(AlignMatrix->Profile);
+	free(AlignMatrix->ProfileRow);
+	(AlignMatrix->Profile)=NULL, (AlignMatrix->ProfileRow)=NULL;
+}//___________________________________________________________
+# endif
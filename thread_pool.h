@@ -0,0 +1,232 @@
+# ifndef STRING_ALIGN_THREAD_POOL
+# define STRING_ALIGN_THREAD_POOL
+/*
+==============================
+Librería: Conjunto de hilos.
+==============================
+
+Funciones para repartir tareas independientes entre varios hilos de ejecución (pthreads).
+Las tareas se forman en una cola y cada hilo toma la siguiente tarea disponible, una tarea puede a su vez encolar nuevas tareas.
+
+Esta librería utiliza las siguientes estructuras como base::
+
+		typedef struct PoolTask_struct
+		// Tarea pendiente en la cola de un ThreadPool
+		{
+			void (*Function)(void *arg);//Función a ejecutar
+			void *Arg;//Argumento de la función
+			struct PoolTask_struct *Next;//Siguiente tarea en la cola
+
+		} PoolTask;
+		//___________________________________________________________
+
+
+		typedef struct ThreadPool_struct
+		// Conjunto de hilos que ejecutan las tareas de una cola compartida
+		{
+			int nThreads;//Número de hilos
+			pthread_t *Threads;//Los hilos
+			pthread_mutex_t Lock;//Protege la cola y los contadores
+			pthread_cond_t TaskReady;//Señala que hay tareas en la cola (o que se debe terminar)
+			pthread_cond_t AllDone;//Señala que ya no hay tareas pendientes
+			PoolTask *Head;//Primera tarea de la cola
+			PoolTask *Tail;//Última tarea de la cola
+			int Pending;//Tareas encoladas o en ejecución
+			int Shutdown;//Verdadero cuando los hilos deben terminar
+
+		} ThreadPool;
+		//___________________________________________________________
+
+
+Las siguientes son las funciones declaradas aquí:
+
+:ThreadPool *AllocThreadPool(int n_threads):
+	Genera un conjunto de n_threads hilos en espera de tareas. Si n_threads<=0 usa tantos hilos como procesadores.
+	Devuelve NULL (las tareas se ejecutan en el hilo actual) si no se pudo crear ningún hilo.
+
+:void PoolSubmit(ThreadPool *pool, void (*function)(void *arg), void *arg):
+	Encola la tarea function(arg). Si pool es NULL, ejecuta la tarea inmediatamente en el hilo actual.
+
+:void PoolWait(ThreadPool *pool):
+	Espera a que terminen todas las tareas encoladas, incluidas las que éstas encolen a su vez.
+
+:void FreeThreadPool(ThreadPool *pool):
+	Termina los hilos y libera el espacio de un conjunto previamente alojado con AllocThreadPool().
+
+:int DefaultThreads(void):
+	Número de procesadores disponibles.
+
+:void *PoolWorker(void *arg):
+	Ciclo de cada hilo de un ThreadPool, toma y ejecuta tareas de la cola hasta que se indique Shutdown.
+
+
+Los prototipos de las funciones y las estructuras están declarados en el archivo alignments_headers.h
+
+:Autor:
+	Andrés García García @ 28/Feb/'16 (Inicio 19 Oct 2015)
+*/
+
+//Librerías
+# include <stdio.h>
+# include <assert.h>//Para verificar errores con la función assert()
+# include <stdlib.h>//Para usar malloc(), calloc(), realloc(), free()
+# include <pthread.h>//Para usar pthread_create(), pthread_mutex_lock(), etc.
+# include <unistd.h>//Para usar sysconf()
+# include "alignments_headers.h"
+
+
+/*
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Funciones para el conjunto de hilos.
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+
+void *PoolWorker(void *arg)
+/*
+ * Ciclo de cada hilo: toma la siguiente tarea de la cola, la ejecuta y repite hasta que se indique Shutdown.
+ */
+{
+	ThreadPool *pool=(ThreadPool *) arg;
+	PoolTask *task;
+	while(1)
+	{
+		pthread_mutex_lock(&(pool->Lock));
+		while(pool->Head == NULL && !(pool->Shutdown))
+			pthread_cond_wait(&(pool->TaskReady), &(pool->Lock));
+		if(pool->Head == NULL)//Shutdown y cola vacía
+		{
+			pthread_mutex_unlock(&(pool->Lock));
+			return NULL;
+		}
+		task=pool->Head;//Saca la primera tarea de la cola
+		pool->Head=task->Next;
+		if(pool->Head == NULL)
+			pool->Tail=NULL;
+		pthread_mutex_unlock(&(pool->Lock));
+
+		(task->Function)(task->Arg);//Ejecuta la tarea fuera del candado
+		free(task);
+
+		pthread_mutex_lock(&(pool->Lock));
+		pool->Pending--;
+		if(pool->Pending == 0)
+			pthread_cond_broadcast(&(pool->AllDone));
+		pthread_mutex_unlock(&(pool->Lock));
+	}
+}//___________________________________________________________
+
+
+
+ThreadPool *AllocThreadPool(int n_threads)
+/*
+ * Genera un conjunto de n_threads hilos que esperan tareas.
+ * Si n_threads<=0 usa tantos hilos como procesadores disponibles.
+ * Si no se pueden crear todos, imprime una advertencia y usa los que sí se crearon; si no se creó ninguno devuelve NULL,
+ * y PoolSubmit() ejecuta entonces las tareas en el hilo actual.
+ */
+{
+	if(n_threads <= 0)
+		n_threads=DefaultThreads();
+	ThreadPool *pool=(ThreadPool *) malloc(sizeof(*pool));
+	assert(pool != NULL);
+	pool->nThreads=n_threads;
+	pool->Head=NULL, pool->Tail=NULL;
+	pool->Pending=0, pool->Shutdown=0;
+	pthread_mutex_init(&(pool->Lock), NULL);
+	pthread_cond_init(&(pool->TaskReady), NULL);
+	pthread_cond_init(&(pool->AllDone), NULL);
+	pool->Threads=(pthread_t *) malloc(n_threads * sizeof(pthread_t));
+	assert(pool->Threads != NULL);
+	int i, err=0;
+	for(i=0; i<n_threads && err == 0; i++)
+		err=pthread_create(&(pool->Threads)[i], NULL, PoolWorker, pool);
+	if(err != 0)//Se sigue con los hilos que sí se crearon
+	{
+		pool->nThreads=i-1;
+		fprintf(stderr, "\nADVERTENCIA: No se pudo crear el hilo %d de %d (error %d), se usan %d\n", i, n_threads, err, pool->nThreads);
+		if(pool->nThreads == 0)//Sin hilos las tareas se ejecutan en el hilo actual
+		{
+			FreeThreadPool(pool);
+			return NULL;
+		}
+	}
+	return pool;
+}//___________________________________________________________
+
+
+
+void PoolSubmit(ThreadPool *pool, void (*function)(void *arg), void *arg)
+/*
+ * Encola la tarea function(arg) para que la ejecute alguno de los hilos de pool.
+ * Si pool es NULL la tarea se ejecuta inmediatamente en el hilo actual.
+ */
+{
+	if(pool == NULL)
+	{
+		function(arg);
+		return;
+	}
+	PoolTask *task=(PoolTask *) malloc(sizeof(*task));
+	assert(task != NULL);
+	task->Function=function, task->Arg=arg, task->Next=NULL;
+
+	pthread_mutex_lock(&(pool->Lock));
+	if(pool->Tail == NULL)//Coloca la tarea al final de la cola
+		pool->Head=task;
+	else
+		(pool->Tail)->Next=task;
+	pool->Tail=task;
+	pool->Pending++;
+	pthread_cond_signal(&(pool->TaskReady));
+	pthread_mutex_unlock(&(pool->Lock));
+}//___________________________________________________________
+
+
+
+void PoolWait(ThreadPool *pool)
+/*
+ * Espera a que no queden tareas pendientes en pool, incluyendo las tareas encoladas por otras tareas.
+ */
+{
+	if(pool == NULL)
+		return;
+	pthread_mutex_lock(&(pool->Lock));
+	while(pool->Pending > 0)
+		pthread_cond_wait(&(pool->AllDone), &(pool->Lock));
+	pthread_mutex_unlock(&(pool->Lock));
+}//___________________________________________________________
+
+
+
+void FreeThreadPool(ThreadPool *pool)
+/*
+ * Termina los hilos de pool (después de ejecutar las tareas pendientes) y libera su espacio.
+ */
+{
+	if(pool == NULL)
+		return;
+	PoolWait(pool);
+	pthread_mutex_lock(&(pool->Lock));
+	pool->Shutdown=1;
+	pthread_cond_broadcast(&(pool->TaskReady));
+	pthread_mutex_unlock(&(pool->Lock));
+	int i;
+	for(i=0; i<(pool->nThreads); i++)
+		pthread_join((pool->Threads)[i], NULL);
+	pthread_mutex_destroy(&(pool->Lock));
+	pthread_cond_destroy(&(pool->TaskReady));
+	pthread_cond_destroy(&(pool->AllDone));
+	free(pool->Threads);
+	free(pool);
+}//___________________________________________________________
+
+
+
+int DefaultThreads(void)
+// Devuelve el número de procesadores disponibles (al menos 1).
+{
+	long n=sysconf(_SC_NPROCESSORS_ONLN);
+	return (n > 0 ? (int) n : 1);
+}//___________________________________________________________
+
+# endif
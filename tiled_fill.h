@@ -0,0 +1,110 @@
+# ifndef STRING_ALIGN_TILED_FILL
+# define STRING_ALIGN_TILED_FILL
+/*
+=========================================
+Librería: Llenado paralelo por bloques.
+=========================================
+
+Llenado de matrices de alineamiento (A_Matrix) entre varios hilos. El interior de la matriz se divide en bloques
+de TILE_SIZE x TILE_SIZE entradas (caben en la caché del procesador) y los bloques se procesan por antidiagonales de bloques:
+el bloque (r,c) sólo depende de los bloques (r-1,c), (r,c-1) y (r-1,c-1), por lo que todos los bloques de una misma
+antidiagonal r+c son independientes y se reparten entre los hilos de un ThreadPool.
+Cada bloque se llena con el mismo núcleo escalar especializado (scalar_fill.h) que el llenado de un solo hilo, por lo que los puntajes y punteros (incluidos los empates) son idénticos.
+
+Esta librería utiliza las siguientes estructuras como base::
+
+		typedef struct FillTile_struct
+		// Bloque de una matriz de alineamiento: las entradas (i,j) con Row0<=i<Row1 y Col0<=j<Col1
+		{
+			A_Matrix *A;//Matriz a la que pertenece el bloque
+			FillBlockKernel Fill;//Núcleo especializado según el tipo de matriz y de puntaje
+			int Row0, Col0;
+			int Row1, Col1;
+
+		} FillTile;
+		//___________________________________________________________
+
+
+Las siguientes son las funciones declaradas aquí:
+
+:int FillAlignMatrixTiled(A_Matrix *AlignMatrix, FillBlockKernel fill):
+	Llena las entradas interiores (i>0 y j>0) de AlignMatrix por bloques con el núcleo fill, repartidos entre AlignMatrix->Threads hilos.
+	Las orillas (condiciones base) deben estar llenas de antemano. Devuelve 0 (sin llenar nada) si no vale la pena dividir la matriz.
+
+:void FillTileTask(void *tile):
+	Llena las entradas de un bloque FillTile con su núcleo.
+
+
+Los prototipos de las funciones y las estructuras están declarados en el archivo alignments_headers.h
+
+:Autor:
+	Andrés García García @ 28/Feb/'16 (Inicio 19 Oct 2015)
+*/
+
+//Librerías
+# include <stdio.h>
+# include <assert.h>//Para verificar errores con la función assert()
+# include <stdlib.h>//Para usar malloc(), calloc(), realloc(), free()
+# include "alignments_headers.h"
+//Definiciones globales
+#define TILE_SIZE 256 //Filas y columnas de cada bloque (256x256 entradas ocupan 320KB entre puntajes y punteros)
+
+
+/*
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Funciones para el llenado paralelo por bloques.
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+
+int FillAlignMatrixTiled(A_Matrix *AlignMatrix, FillBlockKernel fill)
+/*
+ * Llena el interior de AlignMatrix por antidiagonales de bloques, cada antidiagonal se reparte entre AlignMatrix->Threads hilos
+ * (0 para usar todos los procesadores) y se espera a que termine antes de pasar a la siguiente.
+ * Si AlignMatrix->Engine es "tiled" siempre divide la matriz, si no, sólo cuando hay más de un hilo y al menos dos bloques por lado.
+ * Coloca en AlignMatrix->Engine el nombre del motor usado. Devuelve 0 (sin llenar nada) si no dividió la matriz.
+ */
+{
+	int rows=(AlignMatrix->Rows), cols=(AlignMatrix->Cols);
+	int threads=((AlignMatrix->Threads) <= 0 ? DefaultThreads() : (AlignMatrix->Threads));
+	int forced=((AlignMatrix->Engine) != NULL && equStr(AlignMatrix->Engine, "tiled"));
+	if(!forced && (threads == 1 || rows-1 < 2*TILE_SIZE || cols-1 < 2*TILE_SIZE))
+		return 0;
+
+	//Número de bloques por columna y por fila del interior de la matriz
+	int tile_rows=(rows-1 + TILE_SIZE-1)/TILE_SIZE, tile_cols=(cols-1 + TILE_SIZE-1)/TILE_SIZE;
+	int wave, r, c, n;
+	FillTile *tiles=(FillTile *) malloc((tile_rows < tile_cols ? tile_rows : tile_cols) * sizeof(FillTile));//A lo más un bloque por fila de bloques en cada antidiagonal
+	assert(tiles != NULL);
+	ThreadPool *pool=(threads == 1 ? NULL : AllocThreadPool(threads));
+
+	for(wave=0; wave <= (tile_rows-1)+(tile_cols-1); wave++)//Antidiagonal de bloques r+c=wave
+	{
+		for(r=(wave-(tile_cols-1) > 0 ? wave-(tile_cols-1) : 0), n=0; r<tile_rows && r<=wave; r++, n++)
+		{
+			c=wave-r;
+			tiles[n].A=AlignMatrix, tiles[n].Fill=fill;
+			tiles[n].Row0=1 + r*TILE_SIZE, tiles[n].Col0=1 + c*TILE_SIZE;
+			tiles[n].Row1=(tiles[n].Row0+TILE_SIZE < rows ? tiles[n].Row0+TILE_SIZE : rows);
+			tiles[n].Col1=(tiles[n].Col0+TILE_SIZE < cols ? tiles[n].Col0+TILE_SIZE : cols);
+			PoolSubmit(pool, FillTileTask, &tiles[n]);//Si pool es NULL se llena aquí mismo
+		}
+		PoolWait(pool);//La siguiente antidiagonal depende de ésta
+	}
+
+	FreeThreadPool(pool);
+	free(tiles);
+	(AlignMatrix->Engine)="tiled";
+	return 1;
+}//___________________________________________________________
+
+
+
+void FillTileTask(void *tile)
+/*
+ * Llena el bloque tile (un FillTile) fila por fila con su núcleo. Los bloques de arriba y de la izquierda deben estar llenos.
+ */
+{
+	FillTile *t=(FillTile *) tile;
+	(t->Fill)(t->A, t->Row0, t->Row1, t->Col0, t->Col1);
+}//___________________________________________________________
+# endif
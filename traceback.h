@@ -7,54 +7,76 @@ Librería: Recuperación de caminos (Traceback).
 
 Funciones especializadas para la estructura Traceback y su subsidiaria Path.
 Contiene funciones para crear y llenar tracebacks a partir de la matriz de alineamiento, así como para destruirlos cuando ya no se usen.
-Contiene funciones para crear, copiar y extender estructuras Path.
+Los caminos comparten sus nodos (PathNode) en un árbol, en lugar de copiarse en cada bifurcación.
+Contiene un iterador (AlignIterator) que obtiene los alineamientos óptimos uno por uno, sin guardar los caminos, y una función que sólo los cuenta.
 
 Esta librería utiliza las siguientes estructuras como base::
 
-		typedef struct Entry_struct
-		 // Estructura correspondiente a cada entrada de la matriz
-		{
-			float Value;
-			int N_Pointers;
-			char Pointers[3];
-			
-		} Entry;
-		//___________________________________________________________
-		
-		
 		typedef struct A_Matrix_struct
 		// Estructura de la matriz de alineamiento, se compone de ambas secuencias de texto y las entradas de la matriz.
+		// Las entradas se guardan en dos bloques contiguos (fila por fila): los puntajes y las máscaras de punteros.
 		{
-			char *Str1;
-			char *Str2;
+			const char *Str1;//Las cadenas del llamador, no se copian (pueden estar en un archivo proyectado, ver LoadSeqFile())
+			const char *Str2;
 			char *Type;
 			char *AlignType;
 			float *Scores;
-			Entry **M;
+			int Rows;//Número de filas (longitud de Str2 + 1)
+			int Cols;//Número de columnas (longitud de Str1 + 1)
+			int ScoreType;//Tipo de los puntajes: SCORE_INT16 (short), SCORE_INT32 (int) o SCORE_FLOAT (float)
+			void *Values;//Puntajes del tipo ScoreType, la entrada (i,j) es Values[i*Stride + j + Shift] (leer con GetValue())
+			unsigned char *Pointers;//Punteros de traceback, la entrada (i,j) es Pointers[i*Stride + j + Shift], combinación de DIAG_BIT, VERT_BIT y HORI_BIT (o DEAD_BIT), leer con GetPointers()
+			const char *Engine;//Motor de llenado: NULL (automático), "scalar", "simd", "sse4.1" o "tiled"; después de FillAlignMatrix() es el nombre del motor usado ("banded" para las bandas, "striped-avx2" o "striped-sse4.1" para el local vectorial, "xdrop" para el X-drop)
+			int Threads;//Hilos para el llenado por bloques (0 para usar todos los procesadores)
+			double FillTime;//Segundos que tomó FillAlignMatrix()
+			int Band;//Semiancho K de la banda (sólo las entradas con BandLo<=j-i<=BandHi), -1 si se guarda la matriz completa
+			int BandLo, BandHi;//Primera y última diagonal j-i guardadas
+			int Stride, Shift;//Acomodo de las entradas: (i,j) está en la posición i*Stride + j + Shift (Cols y 0 para la matriz completa)
+			int BestRow, BestCol;//Entrada con el mejor puntaje de un alineamiento local o X-drop (la primera por columnas), desde donde empieza el traceback
+			float XDrop;//Umbral X: con similaridad, deja de calcular las entradas X por debajo del mejor puntaje (negativo para llenar toda la matriz)
+			double Skipped;//Entradas que el X-drop no calculó
+			const S_Matrix *Subst;//Matriz de sustitución para los apareamientos y reemplazos (NULL para usar M y R), no pertenece a la matriz
+			void *Profile;//Perfil de Str1 durante el llenado, del tipo ScoreType: la fila ProfileRow[c] tiene el puntaje de cada Str1[j-1] contra c (ver BuildProfile())
+			int *ProfileRow;//Fila del perfil de cada caracter de Str2 (256 entradas, -1 si no aparece)
+			int Packed;//Verdadero después de PackTraceback(): Pointers guarda dos entradas por byte (4 bits cada una) y Values ya se liberó
+			float EndScore;//Con los punteros empacados, el puntaje de la entrada desde donde empieza el traceback (el único que se conserva)
 			
 		} A_Matrix;
 		//___________________________________________________________
 		
 		
+		typedef struct PathNode_struct
+		// Entrada de un camino del traceback, los caminos que empiezan igual (desde la entrada inicial) comparten sus nodos
+		{
+			int I, J;//Posición de la entrada en la matriz
+			int Pointer;//Puntero que sigue el camino desde esta entrada, -1 en la entrada donde termina
+			int Depth;//Número de entradas desde la inicial (0 en la inicial)
+			const struct PathNode_struct *Parent;//Entrada anterior del camino (más cercana a la inicial), NULL en la inicial
+			
+		} PathNode;
+		//___________________________________________________________
+		
+		
 		typedef struct Path_struct
 		// Elemento fundamental de la estructura Traceback
 		{
-			int iSize;//Número de entradas inicializadas
-			int uSize;//Número de entradas no inicializadas
+			int iSize;//Número de entradas del camino
 			float pScore;//Score del camino
-			int **Path;//Arreglo de entradas, cada entrada consiste de tres enteros, que comprenden una posición en la matriz y un puntero
+			const PathNode *Last;//Entrada donde termina el camino (sin punteros); el camino completo se recorre hacia atrás por los Parent
 		} Path;
 		//___________________________________________________________
 		
 		
 		typedef struct Traceback_struct
-		//Contiene implícitamente cada alineamiento desde una celda de una matriz de alineamiento A_Matrix
+		//Contiene implícitamente cada alineamiento desde una celda de una matriz de alineamiento A_Matrix, como un árbol de entradas compartidas
 		{
-			char *Str1;
-			char *Str2;
+			const char *Str1;//Las de la matriz, no se copian
+			const char *Str2;
 			int iPaths;//Número de caminos inicializados
 			int uPaths;//Número de caminos no inicializados
 			Path *Paths;//Arreglo de caminos
+			Arena *Pool;//Arena de la que salen los nodos de todos los caminos, se libera de una sola vez
+			size_t nNodes;//Número de nodos: la memoria es proporcional a las entradas distintas del árbol, no a caminos por longitud
 			
 		} Traceback;
 		//___________________________________________________________
@@ -66,41 +88,123 @@ Esta librería utiliza las siguientes estructuras como base::
 			float Score;
 			char *Align1;
 			char *Align2;
+			char *EditTr;//Código de edición; las tres cadenas están en un solo bloque que empieza en Align1 (ver AllocExplAlign())
 			
 		} Align;
 		//___________________________________________________________
+		
+		
+		typedef struct Cigar_struct
+		//Alineamiento compacto: las corridas de su código de edición (como el CIGAR de SAM, p. ej. 5M1I3M2D)
+		{
+			float Score;
+			int Start1, Start2;//Posición de Str1 y de Str2 donde empieza el alineamiento (0 en los globales)
+			int nRuns;//Número de corridas
+			int Size;//Corridas alojadas
+			int *Lengths;//Longitud de cada corrida
+			char *Ops;//Letra de cada corrida: M, R, I o D (ver EditOp())
+			
+		} Cigar;
+		//___________________________________________________________
+		
+		
+		typedef struct TracebackFrame_struct
+		// Entrada del camino en construcción de un AlignIterator
+		{
+			int I, J;//Posición de la entrada en la matriz
+			unsigned char Pointers;//Máscara de punteros de la entrada (ver GetPointers())
+			unsigned char Next;//Índice (como en NthPointer()) del puntero que sigue el camino
+			
+		} TracebackFrame;
+		//___________________________________________________________
+		
+		
+		typedef struct AlignIterator_struct
+		// Recorre uno por uno los alineamientos óptimos desde una entrada de una matriz de alineamiento, con una búsqueda en profundidad
+		{
+			const A_Matrix *AlignMatrix;//Matriz con los punteros, no pertenece al iterador y debe existir mientras se use
+			TracebackFrame *Stack;//Camino actual desde la entrada inicial, a lo más Rows+Cols-1 entradas
+			int Depth;//Entradas del camino actual
+			int Started;//Verdadero después de la primera llamada a NextPath()
+			int Count;//Alineamientos devueltos hasta ahora
+			Align Current;//Último alineamiento devuelto, sus cadenas pertenecen al iterador
+			int StartI, StartJ;//Entrada inicial de los caminos
+			double *Weights;//Caminos óptimos desde cada entrada, en el orden de Pointers (ver SamplePath()), NULL hasta el primer muestreo
+			int *Scales;//Exponente de la escala de cada fila de Weights: la fila r guarda los caminos por 2^-Scales[r]
+			Cigar Runs;//Corridas del último camino (ver CigarFromStack()), pertenecen al iterador
+			
+		} AlignIterator;
+		//___________________________________________________________
 
 
 
 Las siguientes son las funciones declaradas aquí:
 
 :Traceback *AllocTracebackForMatrix(const A_Matrix *AlignMatrix):
-	Genera espacio para una estructura Traceback con caminos no inicializados con entradas no inicializadas.
-	El número de caminos generados es: DEFAULT_SIZE.
-	El número de entradas generadas por camino es DEFAULT_SIZE.
+	Genera espacio para una estructura Traceback vacía: un arreglo de DEFAULT_SIZE caminos y una arena para sus nodos.
 
 :Traceback *TracebackFromMatrixEntry(const A_Matrix *AlignMatrix, const int i, const int j):
 	Genera una estructura tracebacks que contiene un listado de los alineamientos óptimos de los textos asociados a la matriz AlignMatrix.
-	La estructura en la variable Paths[i] contiene el iésimo camino. 
-	La variable nPaths contiene el número de alineamientos completos o a medio completar.
-	Cada camino es un listado de la forma Paths[path]->Path={{n,m,POINTER}, {n1,m1,POINTER}, {...}, ... {0,0,-1}}, cuya longitud es Paths[path]->pSize.
-	Para obtenerlos se recorre la matriz siguiendo los punteros en un algoritmo basado en Depth First Search. 
-	Cada vez que se encuentra una bifurcación se copia el alineamiento en construcción tantas veces como caminos nuevos se hayan encontrado.
-	No se usa una cola, en cambio, debido a que cada camino debe terminar en la entrada (0,0) de la matriz,
-	si el último paso en el camino no es {0, 0, NO_POINTERS}, entonces el camino está inconcluso.
+	La estructura en la variable Paths[i] contiene el iésimo camino, iPaths es el número de caminos.
+	Los caminos forman un árbol de nodos PathNode con raíz en la entrada inicial: los caminos que empiezan igual comparten esos nodos
+	y cada camino sólo guarda su último nodo (la entrada sin punteros donde termina), desde donde se recorre hacia atrás por los Parent.
+	Para obtenerlos se recorre la matriz siguiendo los punteros en un algoritmo basado en Depth First Search: en cada bifurcación
+	sólo se crea un nodo por puntero, sin copiar el camino, así que la memoria es proporcional a los nodos distintos y no a caminos por longitud.
+	En una matriz por bandas los punteros sólo llevan a entradas de la banda: se obtienen todos los alineamientos óptimos dentro de ella.
+	Para obtenerlos uno por uno sin guardarlos, con memoria O(m+n), ver AllocAlignIterator().
 
 :void FreeTraceback(Traceback *traceback):
-	Libera el espacio ocupado por la estructura traceback previamente alojada por AllocTracebackForMatrix()
+	Libera el espacio ocupado por la estructura traceback previamente alojada por AllocTracebackForMatrix(), con todos los nodos de sus caminos de una vez.
+
+:void AllocMorePaths(Traceback *traceback, const int extra_paths):
+	Haz espacio para extra_paths nuevos caminos en la estructura traceback.
 
-:void AllocMorePaths(Traceback *traceback, const int extra_entries, const int path_size):
-	Haz espacio para extra_entries nuevos caminos en la estructura alignments.
-	Cada camino tiene path_size entradas.
+:const PathNode *NewPathNode(Traceback *traceback, const int i, const int j, const int pointer, const PathNode *parent):
+	Aloja en la arena del traceback un nodo con la entrada (i,j) y su puntero, que sigue al nodo parent (NULL en la entrada inicial).
 
-:void PathCopy(const Path *p1, Path *p2, const int skip):
-	Copia el camino en p1 a p2, excepto las últimas skip entradas.
+:AlignIterator *AllocAlignIterator(const A_Matrix *AlignMatrix, const int i, const int j):
+	Genera un iterador sobre los alineamientos óptimos que empiezan en la entrada (i,j) de AlignMatrix ((-1,-1) para la última entrada).
+	No calcula nada todavía: cada alineamiento se obtiene hasta que se pide con NextAlign().
 
-:void ExtendPath(Path *path, const int extra_entries):
-	Añade extra_entries entradas al camino Path, inicializa el espacio correspondiente a cada entrada.
+:const Align *NextAlign(AlignIterator *iterator):
+	Devuelve el siguiente alineamiento óptimo del iterador, o NULL cuando ya no hay más.
+	El alineamiento pertenece al iterador y sólo es válido hasta la siguiente llamada.
+
+:const Cigar *NextCigar(AlignIterator *iterator):
+	Devuelve las corridas (CIGAR) del siguiente alineamiento óptimo del iterador, sin armar las cadenas con huecos, o NULL cuando ya no hay más.
+
+:int NextPath(AlignIterator *iterator):
+	Deja en la pila del iterador el siguiente camino óptimo, en profundidad; devuelve 0 cuando ya no hay más.
+
+:void AlignFromStack(AlignIterator *iterator):
+	Arma en iterator->Current el alineamiento del camino que está en la pila del iterador, a partir de sus corridas.
+
+:void CigarFromStack(AlignIterator *iterator):
+	Coloca en iterator->Runs las corridas del camino que está en la pila del iterador, directamente desde sus punteros.
+
+:double *PathWeights(const A_Matrix *AlignMatrix, const int i, const int j, int *scales):
+	Número de caminos hasta una entrada sin punteros desde cada entrada (r,c) con r<=i y c<=j, en el orden de los punteros,
+	multiplicado por 2^-scales[r] en cada fila r para que no se desborde.
+
+:const Align *SampleAlign(AlignIterator *iterator, unsigned long long *seed):
+	Devuelve un alineamiento óptimo del iterador elegido al azar con probabilidad uniforme (o NULL si no hay), en tiempo O(m+n)
+	después de contar una sola vez los caminos desde cada entrada.
+
+:const Cigar *SampleCigar(AlignIterator *iterator, unsigned long long *seed):
+	Como SampleAlign(), pero devuelve sólo las corridas del alineamiento elegido.
+
+:int SamplePath(AlignIterator *iterator, unsigned long long *seed):
+	Deja en la pila del iterador un camino óptimo elegido al azar con probabilidad uniforme; devuelve 0 si no hay ninguno.
+
+:void FreeAlignIterator(AlignIterator *iterator):
+	Libera el espacio ocupado por un iterador previamente alojado con AllocAlignIterator().
+
+:PathCount CountAlignments(const A_Matrix *AlignMatrix, const int i, const int j):
+	Cuenta los alineamientos óptimos desde la entrada (i,j) ((-1,-1) para la última), los mismos que devolvería NextAlign(), sin obtenerlos.
+	Usa tiempo O(mn) y memoria O(n); el resultado se satura en PATH_COUNT_MAX.
+
+:char *PathCountStr(const PathCount count, char *str):
+	Escribe count en decimal en str, que debe tener espacio para PATH_COUNT_DIGITS caracteres, y devuelve str.
 
 
 
@@ -132,50 +236,32 @@ int debug; // Variable global para debugear :P
 
 
 
-#define DEFAULT_SIZE	(len1+len2)
+#define DEFAULT_SIZE	(len1+len2+1)
+#define ARENA_BLOCK	(1<<20) //Bytes de cada bloque de la arena de nodos
 Traceback *AllocTracebackForMatrix(const A_Matrix *AlignMatrix)
 /*
- * Genera espacio para una estructura Traceback con caminos no inicializados con entradas no inicializadas.
- * El número de caminos generados es: DEFAULT_SIZE
- * El número de entradas generadas por camino es DEFAULT_SIZE
+ * Genera espacio para una estructura Traceback sin caminos, con espacio para DEFAULT_SIZE caminos y una arena vacía para sus nodos.
+ * Los nodos salen de la arena conforme se crean (ver NewPathNode()) y todos se liberan de una sola vez con FreeTraceback().
  */
 #define	STR1	(traceback->Str1)
 #define	STR2	(traceback->Str2)
 #define	I_PATHS	(traceback->iPaths)
 #define	U_PATHS	(traceback->uPaths)
 #define PATHARR	(traceback->Paths)
-//DEFAULT_SIZE tiene que ser la misma que en TracebacksFromMatrix!!!!
 {
 	int len1=strlen(AlignMatrix->Str1), len2=strlen(AlignMatrix->Str2);//Recupera el tamaño de las cadenas y así, el de la matriz
 	
-	//Crea espacio para la estructura y el arreglo de caminos
+	//Crea espacio para la estructura, la arena y el arreglo de caminos
 	Traceback *traceback=(Traceback *) malloc(sizeof(*traceback));//Genera espacio para la estructura
 	assert(traceback != NULL);
-	STR1 = dupStr(AlignMatrix->Str1);//Copia la cadena de texto inicial
-	assert(STR1 != NULL);//Verifica que se haya copiado
-	STR2 = dupStr(AlignMatrix->Str2);//Copia la cadena de texto objetivo
-	assert(STR2 != NULL);//Verifica que se haya copiado
-	PATHARR = (Path *) malloc(DEFAULT_SIZE * sizeof(Path));//Inicializa el arreglo de caminos. Tiene DEFAULT_SIZE caminos iniciales.
-	assert(PATHARR != NULL);
-	U_PATHS = DEFAULT_SIZE;
+	STR1 = (AlignMatrix->Str1);//Las cadenas de la matriz, sin copiarlas: la matriz vive más que el traceback
+	STR2 = (AlignMatrix->Str2);
+	(traceback->Pool) = allocArena(ARENA_BLOCK);//Los nodos de los caminos
+	(traceback->nNodes) = 0;
+	PATHARR = NULL;
+	U_PATHS = 0;
 	I_PATHS = 0;//No hay caminos inicializados
-	
-	
-	//Crea espacio para los caminos
-	int i, ii;
-	for(i=0; i<DEFAULT_SIZE; i++)
-	{
-		//Espacio para cada camino
-		PATHARR[i].Path = (int **) malloc(DEFAULT_SIZE * sizeof(int *));
-		assert(PATHARR[i].Path != NULL);
-		for(ii=0; ii < DEFAULT_SIZE; ii++)
-		{
-			PATHARR[i].Path[ii] = (int *) calloc(3, sizeof(int));
-			assert(PATHARR[i].Path[ii] != NULL);
-		}
-		PATHARR[i].uSize=DEFAULT_SIZE;//Tiene DEFAULT_SIZE entradas sin inicializar
-		PATHARR[i].iSize=0;//No tiene entradas inicializadas
-	}
+	AllocMorePaths(traceback, DEFAULT_SIZE);//Tiene DEFAULT_SIZE caminos iniciales
 	
 	return traceback;
 }
@@ -184,6 +270,7 @@ Traceback *AllocTracebackForMatrix(const A_Matrix *AlignMatrix)
 #undef	I_PATHS
 #undef	U_PATHS
 #undef	PATHARR
+#undef	ARENA_BLOCK
 //___________________________________________________________
 
 
@@ -191,33 +278,26 @@ Traceback *AllocTracebackForMatrix(const A_Matrix *AlignMatrix)
 Traceback *TracebackFromMatrixEntry(const A_Matrix *AlignMatrix, const int ii, const int jj)
 /*
  * Genera una estructura tracebacks que contiene un listado de los alineamientos óptimos de los textos asociados a la matriz AlignMatrix.
- * La estructura en la variable Paths[i] contiene el iésimo camino. 
- * La variable nPaths contiene el número de alineamientos completos o a medio completar.
- * Cada camino es un listado de la forma Paths[path]->Path={{n,m,POINTER}, {n1,m1,POINTER}, {...}, ... {0,0,-1}}, cuya longitud es Paths[path]->pSize.
- * Para obtenerlos se recorre la matriz siguiendo los punteros en un algoritmo basado en Depth First Search. 
- * Cada vez que se encuentra una bifurcación se copia el alineamiento en construcción tantas veces como caminos nuevos se hayan encontrado.
- * No se usa una cola, en cambio, debido a que cada camino debe terminar en la entrada (0,0) de la matriz,
- * si el último paso en el camino no es {0, 0, NO_POINTERS}, entonces el camino está inconcluso.
+ * La estructura en la variable Paths[i] contiene el iésimo camino.
+ * Los caminos son un árbol de nodos con raíz en la entrada inicial (un nodo por cada puntero de ésta): cada nodo abierto (cuyo puntero
+ * todavía no se sigue) se saca de una pila, se sigue su puntero y se crea un hijo por cada puntero de la entrada a la que llega,
+ * o, si ésta ya no tiene punteros, un nodo final con NO_POINTERS que termina un camino nuevo. Un camino es su nodo final y se recorre
+ * hacia atrás por los Parent; las bifurcaciones no copian nada, así que los caminos comparten todo lo que tienen en común desde la entrada inicial.
+ * Los caminos quedan en el mismo orden en que los devuelve NextAlign().
+ * En una matriz por bandas los punteros sólo llevan a entradas de la banda: se obtienen todos los alineamientos óptimos dentro de ella.
+ * Los punteros se leen con GetPointers(), por lo que la matriz puede estar empacada (ver PackTraceback()) si (ii,jj) es la entrada que se conservó.
  */
 
-#define	STR1	(traceback->Str1)
-#define	STR2	(traceback->Str2)
 #define	I_PATHS	(traceback->iPaths)
 #define	U_PATHS	(traceback->uPaths)
 #define PATHARR	(traceback->Paths)
-#define	PATH_I_SIZE(path)	(PATHARR[path].iSize)
-#define	PATH_U_SIZE(path)	(PATHARR[path].uSize)
-#define PATHSCORE(path)	(PATHARR[path].pScore)
-#define LAST_PATH_ENTRY(path)	((PATHARR[path].Path)[PATH_I_SIZE(path)-1])
-#define NEXT_PATH_ENTRY(path)	((PATHARR[path].Path)[PATH_I_SIZE(path)])
-#define FILL_NEXT_PATH_ENTRY(path, i, j, pointer)	\
-			do{NEXT_PATH_ENTRY(path)[0]=i;\
-			NEXT_PATH_ENTRY(path)[1]=j;\
-			NEXT_PATH_ENTRY(path)[2]=pointer;}while(0)
-#define N_POINTERS(i, j)	(AlignMatrix->M)[i][j].N_Pointers
-#define POINTER(p, i, j)	(AlignMatrix->M)[i][j].Pointers[p]
-#define VALUE(i, j) (AlignMatrix->M)[i][j].Value
-#define LAST_PATH_POINTER(path)	LAST_PATH_ENTRY(path)[2]
+#define POINTERS(i, j)	GetPointers(AlignMatrix, i, j)
+#define N_POINTERS(i, j)	PointerCount(POINTERS(i, j))
+#define POINTER(p, i, j)	NthPointer(POINTERS(i, j), p)
+#define VALUE(i, j) ((AlignMatrix->Packed) ? (AlignMatrix->EndScore) : GetValue(AlignMatrix, i, j))//Empacada, sólo queda el puntaje inicial
+#define PUSH(node)	do{if(n_open == open_size) open=(const PathNode **) realloc(open, (open_size*=2) * sizeof(*open));\
+			assert(open != NULL);\
+			open[n_open++]=(node);}while(0)
 #define NO_POINTERS -1
 #define DIAG 92
 #define VERT '|'
@@ -227,109 +307,68 @@ Traceback *TracebackFromMatrixEntry(const A_Matrix *AlignMatrix, const int ii, c
 	Traceback *traceback=AllocTracebackForMatrix(AlignMatrix);
 	assert(traceback != NULL);
 
-	int i, j, len1=strlen(STR1), len2=strlen(STR2);//Recupera el tamaño de las cadenas y así, el de la matriz
+	int i, j, pointer;
 	if(ii==-1 && jj==-1)
-		i=len2, j=len1;//La posición inicial es desde la última entrada de la matriz(Alineamiento global)
+		i=(AlignMatrix->Rows)-1, j=(AlignMatrix->Cols)-1;//La posición inicial es desde la última entrada de la matriz(Alineamiento global)
 	else
 		i=ii, j=jj;
-
-	//Comienza a buscar caminos...
-	int path, pointer, temp;//Inicializa contadores
-	//Inicializa los primeros caminos.......................................................................
-	for(pointer=0; pointer<N_POINTERS(i,j); pointer++)//Haz tantos caminos como bifurcaciones haya desde la última entrada de la matriz
-	{
-		PATHSCORE(I_PATHS)=VALUE(i,j);//El score del camino
-		FILL_NEXT_PATH_ENTRY(I_PATHS, i, j, POINTER(pointer,i,j));//Llena correctamente la entrada del camino
-		PATH_I_SIZE(I_PATHS)++;//El nuevo camino tiene 1 entrada
-		PATH_U_SIZE(I_PATHS)--;//El nuevo camino tiene una entrada menos sin inicializar
-		I_PATHS++;//Incrementa los caminos inicializados
-		U_PATHS--;//Decrementa los caminos no inicializados
-	}
-	//Continúa a partir de ellos............................................................................
-	for(path=0; path<I_PATHS; path++)//Busca caminos inconclusos 
+	if(!InBand(AlignMatrix, i, j))
+		return traceback;//La entrada no está en la matriz (o en su banda): no hay caminos
+	float score=VALUE(i,j);//El score de todos los caminos
+
+	//Pila de nodos abiertos: a lo más 3 por cada entrada de un camino
+	int n_open=0, open_size=3*(i+j+1);
+	const PathNode **open=(const PathNode **) malloc(open_size * sizeof(*open));
+	assert(open != NULL);
+	const PathNode *node;
+	//Un nodo por cada puntero de la entrada inicial, en orden inverso para seguir primero el primero
+	for(pointer=N_POINTERS(i,j)-1; pointer>=0; pointer--)
+		PUSH(NewPathNode(traceback, i, j, POINTER(pointer,i,j), NULL));
+	while(n_open > 0)
 	{
-		if( LAST_PATH_POINTER(path) != NO_POINTERS )//Checa si el camino está inconcluso (si todavía hay punteros desde esa entrada)
+		node=open[--n_open];
+		//Encuentra la entrada a la que lleva el puntero del nodo
+		i=(node->I), j=(node->J);
+		switch(node->Pointer)
 		{
-			//El camino path está inconcluso, complétalo
-			i=LAST_PATH_ENTRY(path)[0], j=LAST_PATH_ENTRY(path)[1];//Obtiene las i y j donde el camino se quedó
-			//Encuentra los siguientes valores de i y j
-			switch(LAST_PATH_POINTER(path))//Los siguientes i y j dependen del puntero correspondiente
-			{
-				case DIAG:
-				{
-					i--, j--;
-					break;
-				}
-				case VERT:
-				{
-					i--;
-					break;
-				}
-				case HORI:
-				{
-					j--;
-					break;
-				}
-				default:
-					printf("\nPuntero desconocido en camino %d, posición %d : %c=%d.\n", path, PATH_I_SIZE(path)-1, LAST_PATH_POINTER(path), LAST_PATH_POINTER(path));
-			}
-			//Coloca la siguiente entrada del camino
-			//Verifica que no se necesite hacer espacio para más entradas...
-			if(PATH_U_SIZE(path)==0)
-			{
-				//Se requiere extender el camino
-				ExtendPath(&PATHARR[path], DEFAULT_SIZE);
-			}
-			//Antes de colocar los datos, verifica si es un final de camino
-			if(N_POINTERS(i,j)==0)//Si el número de punteros desde esa posición es 0....
-			{
-				//Llegaste al final del camino!
-				//Llena la entrada con la posición i,j y el marcador NO_POINTERS que indica el fin del camino
-				FILL_NEXT_PATH_ENTRY(path, i, j, NO_POINTERS);
-				PATH_I_SIZE(path)++, PATH_U_SIZE(path)--;//Incrementa el tamaño del camino
-			}
-			else//Si todavía hay punteros desde aquí...
-			{
-				//El camino todavía está inconcluso, coloca los datos correspondientes para ser llenado
-				FILL_NEXT_PATH_ENTRY(path, i, j, POINTER(0, i, j));//Llena la entrada con la posición y el primer puntero
-				PATH_I_SIZE(path)++, PATH_U_SIZE(path)--;//Incrementa el tamaño del camino
-				//Si hay más de un puntero se tienen que inicializar más caminos
-				for(pointer=1; pointer<N_POINTERS(i,j); pointer++)
-				{
-					//Verifica que no se necesite hacer espacio 
-					if(U_PATHS==0)
-					{
-						//Si se requiere espacio
-						AllocMorePaths(traceback, DEFAULT_SIZE, DEFAULT_SIZE);
-					}
-					PathCopy(&PATHARR[path], &PATHARR[I_PATHS], 1);//Copia el camino que bifurca hacia el nuevo camino
-					FILL_NEXT_PATH_ENTRY(I_PATHS, i, j, POINTER(pointer, i, j));//Llena correctamente la última entrada del camino
-					PATH_I_SIZE(I_PATHS)++, PATH_U_SIZE(I_PATHS)--;//Añade la nueva entrada
-					I_PATHS++, U_PATHS--;//Incrementa los caminos inicializados
-				}
-			}
-		path=-1;//No estaba completo, reinicializa por si sigue igual
-		}//El camino ya está completo, sigue buscando
-	}//Ya no hay caminos inconclusos, ya terminaste! :D
-
-	return traceback;//Devuelve los resultados. 
-#undef	STR1
-#undef	STR2
+			case DIAG:
+				i--, j--;
+				break;
+			case VERT:
+				i--;
+				break;
+			case HORI:
+				j--;
+				break;
+		}
+		if(N_POINTERS(i,j)==0)
+		{
+			//Llegaste al final del camino!
+			if(U_PATHS==0)
+				AllocMorePaths(traceback, I_PATHS);//Duplica el espacio
+			PATHARR[I_PATHS].Last=NewPathNode(traceback, i, j, NO_POINTERS, node);
+			PATHARR[I_PATHS].iSize=(node->Depth)+2;
+			PATHARR[I_PATHS].pScore=score;
+			I_PATHS++, U_PATHS--;
+			continue;
+		}
+		//El camino sigue: un hijo por cada puntero, todos comparten el nodo actual
+		for(pointer=N_POINTERS(i,j)-1; pointer>=0; pointer--)
+			PUSH(NewPathNode(traceback, i, j, POINTER(pointer,i,j), node));
+	}
+	free(open);
+	return traceback;//Devuelve los resultados.
 #undef	I_PATHS
 #undef	U_PATHS
 #undef	PATHARR
-#undef	PATH_I_SIZE
-#undef	PATH_U_SIZE
-#undef	PATHSCORE
-#undef	LAST_PATH_ENTRY
-#undef	FILL_LAST_PATH_ENTRY
+#undef POINTERS
 #undef N_POINTERS
 #undef POINTER
-#undef SCORE
-#undef LAST_PATH_POINTER
+#undef VALUE
+#undef PUSH
 #undef NO_POINTERS
-#undef DIAG 
-#undef VERT 
+#undef DIAG
+#undef VERT
 #undef HORI
 }//___________________________________________________________
 #undef DEFAULT_SIZE
@@ -338,104 +377,498 @@ Traceback *TracebackFromMatrixEntry(const A_Matrix *AlignMatrix, const int ii, c
 
 void FreeTraceback(Traceback *traceback)
 /*
- * Libera el espacio ocupado por el camino referenciado por traceback
+ * Libera el espacio ocupado por el camino referenciado por traceback.
+ * Los nodos de todos los caminos se liberan de una sola vez junto con la arena.
  */
-#define	PATH(p)	(traceback->Paths)[p]
 {
-	free(traceback->Str1);
-	free(traceback->Str2);
-	int i, j;
-	for(i=0; i < (traceback->iPaths) + (traceback->uPaths); i++)
-	{
-		for(j=0; j < (PATH(i).iSize)+(PATH(i).uSize); j++)
-			free(PATH(i).Path[j]);
-		free(PATH(i).Path);
-	}
+	freeArena(traceback->Pool);
 	free(traceback->Paths);
-	free(traceback->Str1);
-	free(traceback->Str2);
 	free(traceback);
-#undef PATH
 }//___________________________________________________________
 
 
 
 
-void AllocMorePaths(Traceback *traceback, const int extra_entries, const int path_size)
+void AllocMorePaths(Traceback *traceback, const int extra_paths)
 /*
- * Haz espacio para extra_entries nuevos caminos en la estructura alignments.
- * Cada camino tiene path_size entradas.
+ * Haz espacio para extra_paths nuevos caminos en la estructura traceback (al menos uno).
+ * Cada camino es sólo su último nodo: sus entradas están en la arena.
  */
 #define	I_PATHS	(traceback->iPaths)
 #define	U_PATHS	(traceback->uPaths)
 #define PATHARR	(traceback->Paths)
 {
-	//Incrementa el número de caminos
-	PATHARR=(Path *) realloc(PATHARR, (I_PATHS+U_PATHS+extra_entries) * sizeof(Path));
-	int prev_uninit=U_PATHS;//El número anterior de caminos sin inicializar
-	U_PATHS+=extra_entries;//Ahora hay más caminos sin inicializar
-	
-	//Haz espacio para cada camino nuevo, los caminos nuevos empiezan a partir del N_PATHS+prev_uninit
-	int i, ii;
-	for(i=I_PATHS+prev_uninit; i < I_PATHS+U_PATHS; i++)
-	{
-		//Espacio para cada camino
-		PATHARR[i].Path = (int **) malloc(path_size * sizeof(int *));//Haz espacio para el camino con path_size entradas
-		assert(PATHARR[i].Path != NULL);
-		for(ii=0; ii < path_size; ii++)
-		{
-			PATHARR[i].Path[ii]=(int *) calloc(3, sizeof(int));//Cada entrada consta de tres enteros
-			assert(PATHARR[i].Path[ii] != NULL);
-		}
-		PATHARR[i].uSize=path_size;//Tiene path_size entradas sin inicializar
-		PATHARR[i].iSize=0;//No tiene entradas inicializadas
-	}
+	int extra=(extra_paths > 0 ? extra_paths : 1);
+	PATHARR=(Path *) realloc(PATHARR, (I_PATHS+U_PATHS+extra) * sizeof(Path));
+	assert(PATHARR != NULL);
+	U_PATHS+=extra;//Ahora hay más caminos sin inicializar
 }
-#undef N_PATHS
+#undef I_PATHS
 #undef U_PATHS
 #undef PATHARR
 //___________________________________________________________
 
 
 
-void PathCopy(const Path *p1, Path *p2, const int skip)
+const PathNode *NewPathNode(Traceback *traceback, const int i, const int j, const int pointer, const PathNode *parent)
 /*
- * Copia el camino referenciado por p1 a p2, saltándose las últimas skip entradas.
+ * Aloja en la arena del traceback (en O(1)) un nodo con la entrada (i,j) y el puntero que sigue el camino desde ahí,
+ * hijo del nodo parent (NULL si (i,j) es la entrada inicial). Su profundidad es la de parent más uno.
  */
 {
+	PathNode *node=(PathNode *) arenaAlloc((traceback->Pool), sizeof(PathNode));
+	(node->I)=i, (node->J)=j, (node->Pointer)=pointer;
+	(node->Parent)=parent;
+	(node->Depth)=(parent != NULL ? (parent->Depth)+1 : 0);
+	(traceback->nNodes)++;
+	return node;
+}//___________________________________________________________
+
+
+
+AlignIterator *AllocAlignIterator(const A_Matrix *AlignMatrix, const int i, const int j)
+/*
+ * Genera un iterador sobre los alineamientos óptimos que empiezan en la entrada (i,j) de AlignMatrix; si i y j son -1 empieza en la última entrada
+ * (alineamiento global). La pila del camino y las cadenas del alineamiento se alojan una sola vez, con el tamaño del camino más largo
+ * desde (i,j): i+j pasos, más la entrada donde termina. AlignMatrix no se copia y debe existir mientras se use el iterador.
+ */
+{
+	AlignIterator *iterator=(AlignIterator *) malloc(sizeof(*iterator));
+	assert(iterator != NULL);
+	int i0=i, j0=j;
+	if(i0 == -1 && j0 == -1)
+		i0=(AlignMatrix->Rows)-1, j0=(AlignMatrix->Cols)-1;
+	(iterator->AlignMatrix)=AlignMatrix;
+	(iterator->Stack)=(TracebackFrame *) malloc((size_t)(i0+j0+1) * sizeof(TracebackFrame));
+	assert((iterator->Stack) != NULL);
+	AllocExplAlign(&(iterator->Current), i0+j0);
+	(iterator->Depth)=0, (iterator->Started)=0, (iterator->Count)=0;
+	(iterator->StartI)=i0, (iterator->StartJ)=j0;
+	(iterator->Weights)=NULL, (iterator->Scales)=NULL;//Sólo se calculan si se muestrea
+	AllocCigar(&(iterator->Runs), 16);//Crece conforme se necesita (ver AddCigarRun())
+	(iterator->Current).Score=0;
+	//La entrada inicial, si está en la matriz y tiene punteros (si no, no hay alineamientos, como en TracebackFromMatrixEntry())
+	if(InBand(AlignMatrix, i0, j0) && PointerCount(GetPointers(AlignMatrix, i0, j0)) > 0)
+	{
+		(iterator->Stack)[0].I=i0, (iterator->Stack)[0].J=j0;
+		(iterator->Stack)[0].Pointers=GetPointers(AlignMatrix, i0, j0), (iterator->Stack)[0].Next=0;
+		(iterator->Depth)=1;
+		//Empacada, sólo queda el puntaje inicial
+		(iterator->Current).Score=((AlignMatrix->Packed) ? (AlignMatrix->EndScore) : GetValue(AlignMatrix, i0, j0));
+		(iterator->Runs).Score=(iterator->Current).Score;
+	}
+	return iterator;
+}//___________________________________________________________
+
+
+
+const Align *NextAlign(AlignIterator *iterator)
+/*
+ * Devuelve el siguiente alineamiento óptimo del iterador (ver NextPath()), o NULL si ya no hay más.
+ * Cada entrada de la pila es una columna del alineamiento, de derecha a izquierda, como en ExplAlignFromPath(),
+ * por lo que los alineamientos globales incluyen las cadenas completas y los locales sólo las subcadenas alineadas.
+ * El alineamiento pertenece al iterador y se sobrescribe en la siguiente llamada.
+ */
+{
+	if(!NextPath(iterator))
+		return NULL;
+	AlignFromStack(iterator);
+	(iterator->Count)++;
+	return &(iterator->Current);
+}//___________________________________________________________
+
+
+
+const Cigar *NextCigar(AlignIterator *iterator)
+/*
+ * Devuelve las corridas del siguiente alineamiento óptimo del iterador (ver NextPath()), o NULL si ya no hay más,
+ * sin armar las cadenas con huecos (ver CigarFromStack()). Pertenecen al iterador y se sobrescriben en la siguiente llamada.
+ */
+{
+	if(!NextPath(iterator))
+		return NULL;
+	CigarFromStack(iterator);
+	(iterator->Count)++;
+	return &(iterator->Runs);
+}//___________________________________________________________
+
+
+
+int NextPath(AlignIterator *iterator)
+/*
+ * Deja en la pila del iterador el siguiente camino óptimo; devuelve 0 si ya no hay más.
+ * Los caminos se recorren en profundidad: la pila tiene el camino actual desde la entrada inicial y cada entrada sigue su puntero Next.
+ * Para pasar al siguiente camino se quitan de la pila las entradas que ya no tienen otro puntero y se avanza el de la última que sí;
+ * luego se baja siguiendo el primer puntero de cada entrada hasta llegar a una entrada sin punteros, donde termina el alineamiento.
+ * Los caminos salen en orden de sus punteros (diagonal, vertical, horizontal) desde la entrada inicial.
+ */
+{
+#define STACK (iterator->Stack)
+#define DEPTH (iterator->Depth)
+#define TOP STACK[DEPTH-1]
+#define DIAG '\\'
+#define VERT '|'
+#define HORI '-'
 	int i, j;
-	int p2size = (p2->iSize)+(p2->uSize), p1size=(p1->iSize)+(p1->uSize);
-	//Verifica si se requiere extender el camino
-	if( (p2size < p1size ) )
+	unsigned char pointers;
+	if(DEPTH == 0)
+		return 0;//Ya no hay caminos (o nunca los hubo)
+	if(iterator->Started)
 	{
-		ExtendPath(p2, p1size - p2size);
-		p2size = (p2->iSize)+(p2->uSize);//Recalcula el tamaño del camino
+		//Regresa hasta la última entrada con otro puntero sin recorrer
+		while(DEPTH > 0 && (int)TOP.Next+1 >= PointerCount(TOP.Pointers))
+			DEPTH--;
+		if(DEPTH == 0)
+			return 0;
+		TOP.Next++;
 	}
-	
-	//Prepara para copiar...
-	for(i=0; i < (p1->iSize) - skip; i++)//Copia entrada por entrada
+	(iterator->Started)=1;
+	//Baja por los primeros punteros hasta una entrada sin punteros
+	for(;;)
 	{
-		for(j=0; j<3; j++)
-			(p2->Path)[i][j]=(p1->Path)[i][j];//Coloca lo correspondiente en la entrada
+		i=TOP.I, j=TOP.J;
+		switch(NthPointer(TOP.Pointers, TOP.Next))
+		{
+			case DIAG:
+				i--, j--;
+				break;
+			case VERT:
+				i--;
+				break;
+			case HORI:
+				j--;
+				break;
+		}
+		pointers=GetPointers(iterator->AlignMatrix, i, j);
+		if(PointerCount(pointers) == 0)
+			break;//Aquí empieza el alineamiento
+		DEPTH++;
+		TOP.I=i, TOP.J=j, TOP.Pointers=pointers, TOP.Next=0;
 	}
-	(p2->iSize) = (p1->iSize) - skip;//Copia el tamaño
-	(p2->uSize) = p2size-(p2->iSize);//Recalcula las entradas no inicializadas
-	(p2->pScore) = (p1->pScore);//Copia el puntaje
+	return 1;
+#undef STACK
+#undef DEPTH
+#undef TOP
+#undef DIAG
+#undef VERT
+#undef HORI
+}//___________________________________________________________
+
+
+
+void AlignFromStack(AlignIterator *iterator)
+/*
+ * Arma en iterator->Current el alineamiento del camino que está en la pila del iterador: primero sus corridas (ver CigarFromStack())
+ * y con ellas las cadenas con huecos y el código de edición (ver AlignFromCigar()), en el bloque que se alojó una sola vez con el iterador.
+ */
+{
+	CigarFromStack(iterator);
+	AlignFromCigar(&(iterator->Runs), (iterator->AlignMatrix)->Str1, (iterator->AlignMatrix)->Str2, &(iterator->Current));
+}//___________________________________________________________
+
+
+
+void CigarFromStack(AlignIterator *iterator)
+/*
+ * Coloca en iterator->Runs las corridas del camino que está en la pila del iterador (cada entrada sigue su puntero Next),
+ * directamente desde los punteros: la entrada k de la pila es la columna DEPTH-1-k, así que la pila se recorre desde el fondo.
+ * Los apareamientos son M o R según los caracteres (como en EditOp()). El alineamiento empieza en la entrada (i0,j0) donde termina
+ * el camino, es decir, en Str1[j0] y Str2[i0].
+ */
+{
+#define STACK (iterator->Stack)
+#define DEPTH (iterator->Depth)
+#define STR1 ((iterator->AlignMatrix)->Str1)
+#define STR2 ((iterator->AlignMatrix)->Str2)
+#define RUNS (&(iterator->Runs))
+#define DIAG '\\'
+#define VERT '|'
+#define HORI '-'
+	int i, j, k, i0=(iterator->StartI), j0=(iterator->StartJ);
+	(RUNS->nRuns)=0;
+	for(k=DEPTH-1; k>=0; k--)
+	{
+		i=STACK[k].I, j=STACK[k].J;
+		switch(NthPointer(STACK[k].Pointers, STACK[k].Next))
+		{
+			case DIAG ://Coincidencia o reemplazo
+				AddCigarRun(RUNS, (STR1[j-1] == STR2[i-1] ? 'M' : 'R'), 1);
+				i0--, j0--;
+				break;
+			case VERT ://Inserción de una letra en STR1
+				AddCigarRun(RUNS, 'I', 1);
+				i0--;
+				break;
+			case HORI ://Eliminación de una letra de STR1
+				AddCigarRun(RUNS, 'D', 1);
+				j0--;
+				break;
+		}
+	}
+	(RUNS->Start1)=j0, (RUNS->Start2)=i0;
+#undef STACK
+#undef DEPTH
+#undef STR1
+#undef STR2
+#undef RUNS
+#undef DIAG
+#undef VERT
+#undef HORI
+}//___________________________________________________________
+
+
+
+double *PathWeights(const A_Matrix *AlignMatrix, const int i, const int j, int *scales)
+/*
+ * Devuelve un arreglo con el número de caminos desde cada entrada (r,c) de la matriz, con r<=i y c<=j, hasta una entrada sin punteros,
+ * en la posición EntryIndex(AlignMatrix, r, c) (el mismo orden que los punteros). Es la misma cuenta que CountAlignments(),
+ * pero guarda todas las entradas y usa double: las cuentas enormes pierden precisión en lugar de saturarse, lo que basta para
+ * usarlas como pesos. Las entradas fuera de la banda no se calculan y nunca se leen, porque los punteros no salen de ella.
+ * Las cuentas crecen como coeficientes binomiales y pasan de DBL_MAX con unos cuantos miles de entradas, así que cada fila r
+ * se guarda multiplicada por 2^-scales[r] (scales tiene espacio para i+1 exponentes): cada fila empieza con la escala de la anterior,
+ * cuyas cuentas suma sin convertirlas, y si su máximo pasa de 2^WEIGHT_EXP se multiplica por 2^-WEIGHT_EXP (una potencia de 2: no pierde precisión).
+ * Dentro de una fila las cuentas crecen a lo más linealmente, así que una fila nunca se reescala dos veces ni llega al infinito;
+ * las que se vuelven 0 al escalarlas son de caminos con probabilidad menor a 2^-WEIGHT_EXP.
+ */
+#define WEIGHT_EXP 512
+#define WEIGHT_MAX 0x1p512 //2^WEIGHT_EXP
+#define WEIGHT_SCALE 0x1p-512 //2^-WEIGHT_EXP
+{
+	size_t n=(size_t)(AlignMatrix->Rows) * ((AlignMatrix->Band) < 0 ? (AlignMatrix->Cols) : (AlignMatrix->BandHi) - (AlignMatrix->BandLo) + 1);//Entradas guardadas (ver SetMatrixBand())
+	double *weights=(double *) malloc(n * sizeof(double)), w, row_max;
+	assert(weights != NULL);
+	int r, c, lo, hi;
+	unsigned char pointers;
+	for(r=0; r<=i; r++)
+	{
+		scales[r]=(r > 0 ? scales[r-1] : 0), row_max=0;
+		lo=0, hi=j;
+		if((AlignMatrix->Band) >= 0)//Sólo las columnas de la banda
+			lo=MAX(0, r+(AlignMatrix->BandLo)), hi=MIN(j, r+(AlignMatrix->BandHi));
+		for(c=lo; c<=hi; c++)
+		{
+			pointers=GetPointers(AlignMatrix, r, c);
+			if(PointerCount(pointers) == 0)
+				w=1;//Aquí termina un camino
+			else
+			{
+				w=0;
+				if(pointers & DIAG_BIT)
+					w+=weights[EntryIndex(AlignMatrix, r-1, c-1)];
+				if(pointers & VERT_BIT)
+					w+=weights[EntryIndex(AlignMatrix, r-1, c)];
+				if(pointers & HORI_BIT)
+					w+=weights[EntryIndex(AlignMatrix, r, c-1)];
+			}
+			weights[EntryIndex(AlignMatrix, r, c)]=w;
+			row_max=MAX(row_max, w);
+		}
+		if(row_max > WEIGHT_MAX)//Reescala la fila
+		{
+			for(c=lo; c<=hi; c++)
+				weights[EntryIndex(AlignMatrix, r, c)]*=WEIGHT_SCALE;
+			scales[r]+=WEIGHT_EXP;
+		}
+	}
+	return weights;
+#undef WEIGHT_EXP
+#undef WEIGHT_MAX
+#undef WEIGHT_SCALE
+}//___________________________________________________________
+
+
+
+const Align *SampleAlign(AlignIterator *iterator, unsigned long long *seed)
+/*
+ * Devuelve un alineamiento óptimo elegido al azar con probabilidad uniforme entre todos los del iterador (ver SamplePath()),
+ * o NULL si no hay ninguno. El alineamiento pertenece al iterador, como en NextAlign().
+ */
+{
+	if(!SamplePath(iterator, seed))
+		return NULL;
+	AlignFromStack(iterator);
+	(iterator->Count)++;
+	return &(iterator->Current);
 }//___________________________________________________________
 
 
 
-void ExtendPath(Path *path, const int extra_entries)
+const Cigar *SampleCigar(AlignIterator *iterator, unsigned long long *seed)
 /*
- * Añade extra_entries entradas al camino Path, inicializa el espacio correspondiente a cada entrada
+ * Devuelve las corridas de un alineamiento óptimo elegido al azar con probabilidad uniforme (ver SamplePath()), o NULL si no hay ninguno,
+ * sin armar las cadenas con huecos. Pertenecen al iterador, como en NextCigar().
  */
 {
-	int old_size=(path->uSize)+(path->iSize);
-	(path->Path)=(int **) realloc((path->Path), old_size+extra_entries);//Genera espacio
-	int ii;
-	for(ii=old_size; ii < old_size+extra_entries; ii++)
-		(path->Path)[ii]=(int *) calloc(3, sizeof(int));//Cada entrada consta de tres enteros
-	(path->uSize)+=extra_entries;//Tiene extra_entries entradas nuevas sin inicializar
+	if(!SamplePath(iterator, seed))
+		return NULL;
+	CigarFromStack(iterator);
+	(iterator->Count)++;
+	return &(iterator->Runs);
+}//___________________________________________________________
+
+
+
+int SamplePath(AlignIterator *iterator, unsigned long long *seed)
+/*
+ * Deja en la pila del iterador un camino óptimo elegido al azar con probabilidad uniforme entre todos los del iterador; devuelve 0 si no hay ninguno.
+ * La primera llamada cuenta los caminos desde cada entrada (ver PathWeights(), tiempo O(mn)); después cada alineamiento
+ * cuesta O(m+n): desde la entrada inicial se elige cada puntero con probabilidad proporcional a los caminos desde la entrada
+ * a la que lleva, así que cada camino completo sale con probabilidad 1/(caminos desde la entrada inicial).
+ * Los caminos de la entrada de la fila anterior están en la escala de esa fila (ver PathWeights()) y se pasan a la de la fila actual.
+ * Los caminos son independientes (se pueden repetir). seed es la semilla de randUnit() y avanza.
+ * La pila se sobrescribe: no se deben mezclar llamadas a NextPath() y SamplePath() en el mismo iterador.
+ */
+{
+#define A (iterator->AlignMatrix)
+#define STACK (iterator->Stack)
+#define DEPTH (iterator->Depth)
+#define WEIGHT(i, j) (iterator->Weights)[EntryIndex(A, i, j)]
+#define SCALE(i) (iterator->Scales)[i]
+#define WEIGHT_SCALE 0x1p-512 //Ver PathWeights()
+#define DIAG '\\'
+#define VERT '|'
+#define HORI '-'
+	int i=(iterator->StartI), j=(iterator->StartJ), p, n, pi, pj;
+	unsigned char pointers;
+	double r, w;
+	if(!InBand(A, i, j) || PointerCount(GetPointers(A, i, j)) == 0)
+		return 0;//No hay alineamientos
+	if((iterator->Weights) == NULL)
+	{
+		(iterator->Scales)=(int *) malloc((size_t)(i+1) * sizeof(int));
+		assert((iterator->Scales) != NULL);
+		(iterator->Weights)=PathWeights(A, i, j, (iterator->Scales));
+	}
+	for(DEPTH=0; (n=PointerCount(pointers=GetPointers(A, i, j))) > 0; DEPTH++)
+	{
+		//Elige el puntero p con probabilidad (caminos por p)/(caminos desde (i,j))
+		r=randUnit(seed) * WEIGHT(i, j);
+		for(p=0; p<n; p++)
+		{
+			pi=i, pj=j;
+			switch(NthPointer(pointers, p))
+			{
+				case DIAG:
+					pi--, pj--;
+					break;
+				case VERT:
+					pi--;
+					break;
+				case HORI:
+					pj--;
+					break;
+			}
+			w=WEIGHT(pi, pj);
+			if(SCALE(pi) != SCALE(i))//La fila i se reescaló una vez más que la anterior
+				w*=WEIGHT_SCALE;
+			if(r < w || p == n-1)//El último absorbe el redondeo
+				break;
+			r-=w;
+		}
+		STACK[DEPTH].I=i, STACK[DEPTH].J=j, STACK[DEPTH].Pointers=pointers, STACK[DEPTH].Next=p;
+		i=pi, j=pj;
+	}
+	return 1;
+#undef A
+#undef STACK
+#undef DEPTH
+#undef WEIGHT
+#undef SCALE
+#undef WEIGHT_SCALE
+#undef DIAG
+#undef VERT
+#undef HORI
+}//___________________________________________________________
+
+
+
+void FreeAlignIterator(AlignIterator *iterator)
+/*
+ * Libera el espacio ocupado por el iterador (pero no la matriz de alineamiento que recorre).
+ */
+{
+	free(iterator->Stack);
+	free(iterator->Weights);
+	free(iterator->Scales);
+	FreeExplAlign(&(iterator->Current));
+	FreeCigar(&(iterator->Runs));
+	free(iterator);
+}//___________________________________________________________
+
+
+
+PathCount CountAlignments(const A_Matrix *AlignMatrix, const int i, const int j)
+/*
+ * Cuenta los caminos desde la entrada (i,j) (la última entrada si i y j son -1) que siguen los punteros hasta una entrada sin punteros,
+ * es decir, los alineamientos que devolvería NextAlign() con AllocAlignIterator(AlignMatrix, i, j), sin obtenerlos.
+ * Los caminos desde una entrada sin punteros son 1 (el camino vacío) y desde cualquier otra, la suma de los caminos desde las entradas
+ * a las que apuntan sus punteros, que están en la misma fila o en la anterior: se calculan fila por fila guardando sólo dos filas de cuentas.
+ * En una matriz por bandas sólo se recorre la banda, porque los punteros nunca salen de ella. Las sumas se saturan en PATH_COUNT_MAX.
+ * Si (i,j) no está en la matriz o no tiene punteros devuelve 0, igual que el iterador.
+ */
+{
+#define ADD_SAT(a, b) ((a) > PATH_COUNT_MAX-(b) ? PATH_COUNT_MAX : (a)+(b))
+	int i0=i, j0=j, r, c, lo, hi;
+	unsigned char pointers;
+	if(i0 == -1 && j0 == -1)
+		i0=(AlignMatrix->Rows)-1, j0=(AlignMatrix->Cols)-1;
+	if(!InBand(AlignMatrix, i0, j0) || PointerCount(GetPointers(AlignMatrix, i0, j0)) == 0)
+		return 0;
+	PathCount *up=(PathCount *) calloc((size_t)j0+1, sizeof(PathCount));
+	PathCount *row=(PathCount *) calloc((size_t)j0+1, sizeof(PathCount));
+	PathCount *temp, count;
+	assert(up != NULL && row != NULL);
+	for(r=0; r<=i0; r++)
+	{
+		lo=0, hi=j0;
+		if((AlignMatrix->Band) >= 0)//Sólo las columnas de la banda
+			lo=MAX(0, r+(AlignMatrix->BandLo)), hi=MIN(j0, r+(AlignMatrix->BandHi));
+		for(c=lo; c<=hi; c++)
+		{
+			pointers=GetPointers(AlignMatrix, r, c);
+			if(PointerCount(pointers) == 0)
+			{
+				row[c]=1;//Aquí termina un camino
+				continue;
+			}
+			count=0;
+			if(pointers & DIAG_BIT)
+				count=ADD_SAT(count, up[c-1]);
+			if(pointers & VERT_BIT)
+				count=ADD_SAT(count, up[c]);
+			if(pointers & HORI_BIT)
+				count=ADD_SAT(count, row[c-1]);
+			row[c]=count;
+		}
+		temp=up, up=row, row=temp;
+	}
+	count=up[j0];
+	free(up);
+	free(row);
+	return count;
+#undef ADD_SAT
+}//___________________________________________________________
+
+
+
+char *PathCountStr(const PathCount count, char *str)
+/*
+ * Escribe count en decimal en str (printf() no tiene formato para enteros de 128 bits) y devuelve str.
+ * str debe tener espacio para PATH_COUNT_DIGITS caracteres.
+ */
+{
+	char digits[PATH_COUNT_DIGITS];
+	PathCount n=count;
+	int k=0, pos=0;
+	do
+	{
+		digits[k++]='0' + (int)(n % 10);
+		n/=10;
+	}while(n > 0);
+	while(k > 0)
+		str[pos++]=digits[--k];
+	str[pos]='\0';
+	return str;
 }//___________________________________________________________
 
 # endif
\ No newline at end of file
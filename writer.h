@@ -0,0 +1,463 @@
+# ifndef STRING_ALIGN_WRITER
+# define STRING_ALIGN_WRITER
+/*
+===========================================
+Librería: Salida con búfer y sus formatos.
+===========================================
+
+Con millones de alineamientos, imprimirlos caracter por caracter con printf() cuesta más que obtenerlos.
+Un Writer junta la salida en un búfer grande (WRITER_SIZE bytes) y lo escribe con una sola llamada a write() cada vez que se llena,
+además de elegir el formato de los alineamientos (opción --format):
+
+	FORMAT_TEXT		El formato para leerse: cada alineamiento con su número, sus cadenas con huecos y su código de edición (o su CIGAR).
+	FORMAT_TSV		Un registro por línea separado por tabuladores, después de una línea con los nombres de las columnas:
+					number, name1, start1, end1, name2, start2, end2, score, cigar.
+	FORMAT_JSONL	Un objeto JSON por línea con los mismos campos.
+	FORMAT_SAM		Un registro SAM por línea (Str1 es la referencia y Str2 la lectura), después del encabezado @HD/@SQ/@PG.
+	FORMAT_BIN		Un registro binario de tamaño fijo por alineamiento, seguido de sus corridas empacadas (ver binary.h).
+
+Las coordenadas de los registros empiezan en 0 y no incluyen el final (Str1[start1..end1) y Str2[start2..end2)), salvo POS de SAM,
+que empieza en 1. El CIGAR de TSV y JSONL usa las letras del código de edición (M, R, I, D, ver cigar.h); el de SAM usa = y X
+en lugar de M y R, y recorta (S) las partes de Str2 fuera del alineamiento. En SAM el puntaje va en la etiqueta AS:i
+(ZS:f si no es entero) y el número de ediciones en NM:i.
+
+El Writer escribe directamente en su descriptor; antes de cada escritura vacía stdout, así que lo impreso con printf() antes
+sale antes, siempre que el Writer se vacíe (FlushWriter()) antes de volver a usar printf().
+
+Esta librería utiliza las siguientes estructuras como base::
+
+		typedef struct Writer_struct
+		//Salida con búfer: junta lo escrito y lo escribe en su descriptor con una llamada a write() por bloque
+		{
+			int Fd;//Descriptor donde se escribe (STDOUT_FILENO normalmente)
+			int Format;//Formato de los alineamientos: FORMAT_TEXT, FORMAT_TSV, FORMAT_JSONL, FORMAT_SAM o FORMAT_BIN
+			char *Buffer;//Búfer de WRITER_SIZE bytes
+			size_t Used;//Bytes del búfer pendientes de escribir
+			const char *Name1, *Name2;//Nombres de Str1 y Str2 en los registros, no pertenecen al Writer
+			unsigned int Id1, Id2;//Números de los registros de Str1 y Str2 en sus archivos para los registros binarios, desde 1 (0 para las cadenas de la línea de comandos)
+			long long Records;//Registros escritos
+			int Header;//Verdadero si ya se escribió el encabezado del formato (antes del primer registro, ver WriteSamHeader())
+
+		} Writer;
+		//___________________________________________________________
+
+
+		typedef struct Sequence_struct
+		//Registro de un archivo FASTA o FASTQ, separado en su lugar dentro de la proyección del archivo
+		{
+			const char *Name;//Nombre: la primera palabra del encabezado, sin '>' ni '@'
+			const char *Seq;//Secuencia, terminada en '\0'
+			size_t Length;//Longitud de la secuencia
+
+		} Sequence;
+		//___________________________________________________________
+
+
+		typedef struct Cigar_struct
+		//Alineamiento compacto: las corridas de su código de edición (como el CIGAR de SAM, p. ej. 5M1I3M2D)
+		{
+			float Score;
+			int Start1, Start2;//Posición de Str1 y de Str2 donde empieza el alineamiento (0 en los globales)
+			int nRuns;//Número de corridas
+			int Size;//Corridas alojadas
+			int *Lengths;//Longitud de cada corrida
+			char *Ops;//Letra de cada corrida: M, R, I o D (ver EditOp())
+
+		} Cigar;
+		//___________________________________________________________
+
+
+
+Las siguientes son las funciones declaradas aquí:
+
+:Writer *AllocWriter(const int fd, const int format):
+	Genera un Writer vacío que escribe en el descriptor fd con el formato format.
+
+:int ParseFormat(const char *name):
+	El formato con ese nombre ("text", "tsv", "jsonl", "sam" o "bin"), o -1 si no existe.
+
+:void WriteBytes(Writer *out, const char *bytes, const size_t n):
+	Agrega n bytes a la salida, escribiendo el búfer cuando se llena.
+
+:void WriteChar(Writer *out, const char c):
+	Agrega un caracter a la salida.
+
+:void WriteStr(Writer *out, const char *str):
+	Agrega una cadena a la salida.
+
+:void WriteInt(Writer *out, const int n):
+	Agrega a la salida el entero n en decimal, sin pasar por printf().
+
+:void WriteFormat(Writer *out, const char *format, ...):
+	Agrega a la salida el texto de printf(format, ...).
+
+:void WriteScore(Writer *out, const float score):
+	Agrega el puntaje a la salida: en decimal si es entero y, si no, con los dígitos suficientes para recuperar el float exacto.
+
+:void WriteJsonStr(Writer *out, const char *str):
+	Agrega str como cadena de JSON, entre comillas y con los caracteres especiales escapados.
+
+:void WriteSamHeader(Writer *out, const Sequence *refs, const int n):
+	Escribe el encabezado SAM (@HD, una línea @SQ por cada una de las n referencias y @PG).
+
+:void WriteAlignRecord(Writer *out, const Cigar *cigar, const int number, const char *str1, const char *str2):
+	Escribe el alineamiento compacto cigar de str1 y str2 como un registro del formato de out (TSV, JSONL, SAM o binario).
+
+:void FlushWriter(Writer *out):
+	Escribe todo lo pendiente en el descriptor (después de vaciar stdout).
+
+:void FreeWriter(Writer *out):
+	Escribe lo pendiente y libera el Writer (pero no cierra su descriptor).
+
+
+Los prototipos de las funciones y las estructuras están declarados en el archivo alignments_headers.h
+
+Los formatos están basados en:
+	*The Sequence Alignment/Map format and SAMtools*
+	Heng Li et al., Bioinformatics 25(16) (2009)
+	*JSON Lines* (https://jsonlines.org)
+
+:Autor:
+	Andrés García García @ 28/Feb/'16 (Inicio 19 Oct 2015)
+*/
+
+//Librerías
+# include <stdio.h>
+# include <assert.h>//Para verificar errores con la función assert()
+# include <stdlib.h>//Para usar malloc(), free()
+# include <string.h>//Para usar strlen() y memcpy()
+# include <stdarg.h>//Para usar va_list en WriteFormat()
+# include <unistd.h>//Para usar write()
+# include "alignments_headers.h"
+//Definiciones globales
+#define WRITER_SIZE (1<<20) //Bytes del búfer de un Writer
+
+
+/*
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Funciones para la salida con búfer.
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+
+Writer *AllocWriter(const int fd, const int format)
+/*
+ * Genera un Writer con un búfer vacío de WRITER_SIZE bytes que escribe en el descriptor fd con el formato format (ver ParseFormat()).
+ * Los registros nombran a las cadenas "Str1" y "Str2" (con los índices 0 y 0) hasta que se cambien Name1 y Name2 (o Id1 e Id2).
+ * En el formato binario el encabezado del archivo queda en el búfer desde aquí, así que la salida es válida aunque no haya alineamientos.
+ */
+{
+	Writer *out=(Writer *) malloc(sizeof(Writer));
+	assert(out != NULL);
+	(out->Buffer)=(char *) malloc(WRITER_SIZE * sizeof(char));
+	assert((out->Buffer) != NULL);
+	(out->Fd)=fd, (out->Format)=format, (out->Used)=0, (out->Records)=0, (out->Header)=0;
+	(out->Name1)="Str1", (out->Name2)="Str2", (out->Id1)=0, (out->Id2)=0;
+	if(format == FORMAT_BIN)
+	{
+		PackBinHeader((unsigned char *)(out->Buffer));
+		(out->Used)=BIN_HEADER_SIZE, (out->Header)=1;
+	}
+	return out;
+}//___________________________________________________________
+
+
+
+int ParseFormat(const char *name)
+/*
+ * Devuelve el formato con el nombre name ("text", "tsv", "jsonl", "sam" o "bin"), o -1 si no es ninguno.
+ */
+{
+	if(equStr(name, "text"))
+		return FORMAT_TEXT;
+	if(equStr(name, "tsv"))
+		return FORMAT_TSV;
+	if(equStr(name, "jsonl"))
+		return FORMAT_JSONL;
+	if(equStr(name, "sam"))
+		return FORMAT_SAM;
+	if(equStr(name, "bin"))
+		return FORMAT_BIN;
+	return -1;
+}//___________________________________________________________
+
+
+
+void WriteBytes(Writer *out, const char *bytes, const size_t n)
+/*
+ * Agrega n bytes a la salida. Si no caben en el búfer lo escribe primero; si ni así caben, los escribe directamente.
+ */
+{
+	if((out->Used) + n > WRITER_SIZE)
+		FlushWriter(out);
+	if(n > WRITER_SIZE)
+	{
+		size_t done;
+		ssize_t w;
+		for(done=0; done < n; done+=w)
+			if((w=write((out->Fd), bytes+done, n-done)) <= 0)
+				break;//Error de escritura (p. ej. se cerró la tubería)
+		return;
+	}
+	memcpy((out->Buffer) + (out->Used), bytes, n);
+	(out->Used)+=n;
+}//___________________________________________________________
+
+
+
+void WriteChar(Writer *out, const char c)
+/*
+ * Agrega el caracter c a la salida.
+ */
+{
+	if((out->Used) == WRITER_SIZE)
+		FlushWriter(out);
+	(out->Buffer)[(out->Used)++]=c;
+}//___________________________________________________________
+
+
+
+void WriteStr(Writer *out, const char *str)
+/*
+ * Agrega la cadena str (sin el caracter nulo) a la salida.
+ */
+{
+	WriteBytes(out, str, strlen(str));
+}//___________________________________________________________
+
+
+
+void WriteInt(Writer *out, const int n)
+/*
+ * Agrega a la salida el entero n en decimal. Las longitudes de las corridas de un CIGAR se escriben con ésta
+ * y no con WriteFormat(), que formatea con vsnprintf() y es varias veces más lenta para un solo número.
+ */
+{
+	char digits[11];//Los 10 dígitos de un int y el signo
+	int k=sizeof(digits);
+	unsigned int u=(n < 0 ? -(unsigned int)n : (unsigned int)n);
+	do
+		digits[--k]='0' + u%10;
+	while((u/=10) > 0);
+	if(n < 0)
+		digits[--k]='-';
+	WriteBytes(out, digits+k, sizeof(digits)-k);
+}//___________________________________________________________
+
+
+
+void WriteFormat(Writer *out, const char *format, ...)
+/*
+ * Agrega a la salida el texto que imprimiría printf(format, ...), formateándolo directamente en el búfer si cabe.
+ */
+{
+	va_list args, retry;
+	va_start(args, format);
+	va_copy(retry, args);
+	int n=vsnprintf((out->Buffer) + (out->Used), WRITER_SIZE - (out->Used), format, args);
+	assert(n >= 0);
+	if((size_t)n < WRITER_SIZE - (out->Used))
+		(out->Used)+=n;
+	else if(n < WRITER_SIZE)
+	{
+		//No cupo en lo que quedaba: se escribe el búfer y se formatea de nuevo al principio
+		FlushWriter(out);
+		(out->Used)=vsnprintf((out->Buffer), WRITER_SIZE, format, retry);
+	}
+	else
+	{
+		//Más grande que el búfer: se formatea aparte
+		char *text=(char *) malloc((size_t)n+1);
+		assert(text != NULL);
+		vsnprintf(text, (size_t)n+1, format, retry);
+		WriteBytes(out, text, n);
+		free(text);
+	}
+	va_end(retry);
+	va_end(args);
+}//___________________________________________________________
+
+
+
+void WriteScore(Writer *out, const float score)
+/*
+ * Agrega el puntaje score a la salida. Los puntajes de las matrices de tipo entero (SCORE_INT16, SCORE_INT32) y los de costos
+ * enteros siempre son enteros y se escriben con %d; los demás, con %.9g: 9 dígitos significativos bastan para que el float
+ * leído sea exactamente el mismo (%g sólo escribe 6 y redondea, p. ej. 1234567 como 1.23457e+06).
+ */
+{
+	if(score > -2e9f && score < 2e9f && score == (float)(int)score)
+		WriteFormat(out, "%d", (int)score);
+	else
+		WriteFormat(out, "%.9g", score);
+}//___________________________________________________________
+
+
+
+void WriteJsonStr(Writer *out, const char *str)
+/*
+ * Agrega str entre comillas como cadena de JSON: las comillas, la diagonal invertida y los caracteres de control se escapan.
+ */
+{
+	const unsigned char *c;
+	WriteChar(out, '"');
+	for(c=(const unsigned char *)str; *c != '\0'; c++)
+	{
+		if(*c == '"' || *c == '\\')
+			WriteChar(out, '\\'), WriteChar(out, *c);
+		else if(*c < 0x20)
+			WriteFormat(out, "\\u%04x", *c);
+		else
+			WriteChar(out, *c);
+	}
+	WriteChar(out, '"');
+}//___________________________________________________________
+
+
+
+void WriteSamHeader(Writer *out, const Sequence *refs, const int n)
+/*
+ * Escribe el encabezado SAM con las n referencias de refs (una línea @SQ con el nombre y la longitud de cada una)
+ * y lo marca como escrito, para que WriteAlignRecord() no escriba el suyo (sólo con Str1).
+ */
+{
+	int k;
+	WriteStr(out, "@HD\tVN:1.6\tSO:unsorted\n");
+	for(k=0; k<n; k++)
+		WriteFormat(out, "@SQ\tSN:%s\tLN:%zu\n", refs[k].Name, refs[k].Length);
+	WriteStr(out, "@PG\tID:global-align\tPN:global-align\n");
+	(out->Header)=1;
+}//___________________________________________________________
+
+
+
+void WriteAlignRecord(Writer *out, const Cigar *cigar, const int number, const char *str1, const char *str2)
+/*
+ * Escribe el alineamiento compacto cigar de str1 (columnas de la matriz) y str2 (filas) como un registro de una línea
+ * en el formato de out: TSV, JSONL o SAM (ver el principio del archivo), o como un registro binario (ver binary.h).
+ * Antes del primer registro escribe el encabezado del formato (los nombres de las columnas en TSV, las líneas @HD, @SQ y @PG en SAM;
+ * el del formato binario ya lo escribió AllocWriter()).
+ */
+{
+	int k, len1, len2, edits=0, clip, first, last;
+	unsigned char bytes[BIN_RECORD_SIZE];
+	BinRecord record;
+	CigarSpan(cigar, &len1, &len2);
+	for(k=0; k<(cigar->nRuns); k++)
+		if((cigar->Ops)[k] != 'M')
+			edits+=(cigar->Lengths)[k];
+	switch(out->Format)
+	{
+		case FORMAT_TSV:
+			if(!(out->Header))
+				WriteStr(out, "number\tname1\tstart1\tend1\tname2\tstart2\tend2\tscore\tcigar\n"), (out->Header)=1;
+			WriteFormat(out, "%d\t%s\t%d\t%d\t%s\t%d\t%d\t", number, (out->Name1), (cigar->Start1), (cigar->Start1)+len1,
+						(out->Name2), (cigar->Start2), (cigar->Start2)+len2);
+			WriteScore(out, (cigar->Score));
+			WriteChar(out, '\t');
+			for(k=0; k<(cigar->nRuns); k++)
+				WriteInt(out, (cigar->Lengths)[k]), WriteChar(out, (cigar->Ops)[k]);
+			WriteChar(out, '\n');
+			break;
+		case FORMAT_JSONL:
+			WriteFormat(out, "{\"number\":%d,\"name1\":", number);
+			WriteJsonStr(out, (out->Name1));
+			WriteFormat(out, ",\"start1\":%d,\"end1\":%d,\"name2\":", (cigar->Start1), (cigar->Start1)+len1);
+			WriteJsonStr(out, (out->Name2));
+			WriteFormat(out, ",\"start2\":%d,\"end2\":%d,\"score\":", (cigar->Start2), (cigar->Start2)+len2);
+			WriteScore(out, (cigar->Score));
+			WriteStr(out, ",\"cigar\":\"");
+			for(k=0; k<(cigar->nRuns); k++)
+				WriteInt(out, (cigar->Lengths)[k]), WriteChar(out, (cigar->Ops)[k]);
+			WriteStr(out, "\"}\n");
+			break;
+		case FORMAT_SAM:
+			if(!(out->Header))//Sólo Str1 como referencia; con varias, el llamador escribe antes el encabezado con todas
+			{
+				Sequence ref;
+				(ref.Name)=(out->Name1), (ref.Seq)=str1, (ref.Length)=strlen(str1);
+				WriteSamHeader(out, &ref, 1);
+			}
+			//Los huecos de Str2 en los extremos no son parte del read: la corrida D inicial recorre POS (si queda algo) y la final se descarta
+			first=0, last=(cigar->nRuns), edits=0;
+			if(first < last && (cigar->Ops)[first] == 'D')
+				first++;
+			if(first < last && (cigar->Ops)[last-1] == 'D')
+				last--;
+			for(k=first; k<last; k++)
+				if((cigar->Ops)[k] != 'M')
+					edits+=(cigar->Lengths)[k];
+			//QNAME, FLAG, RNAME, POS, MAPQ (no disponible)
+			WriteFormat(out, "%s\t0\t%s\t%d\t255\t", (out->Name2), (out->Name1), (cigar->Start1)+(0 < first && first < last ? (cigar->Lengths)[0] : 0)+1);
+			//CIGAR, con = y X en lugar de M y R y las partes de Str2 fuera del alineamiento recortadas ('*' sin corridas, p. ej. con --score-only)
+			clip=(int)strlen(str2) - (cigar->Start2) - len2;
+			if(first == last)
+				WriteChar(out, '*');
+			else
+			{
+				if((cigar->Start2) > 0)
+					WriteFormat(out, "%dS", (cigar->Start2));
+				for(k=first; k<last; k++)
+					WriteInt(out, (cigar->Lengths)[k]), WriteChar(out, ((cigar->Ops)[k] == 'M' ? '=' : ((cigar->Ops)[k] == 'R' ? 'X' : (cigar->Ops)[k])));
+				if(clip > 0)
+					WriteFormat(out, "%dS", clip);
+			}
+			//RNEXT, PNEXT, TLEN, SEQ, QUAL
+			WriteStr(out, "\t*\t0\t0\t");
+			WriteStr(out, (str2[0] != '\0' ? str2 : "*"));
+			WriteStr(out, "\t*\t");
+			if((cigar->Score) == (float)(int)(cigar->Score))
+				WriteFormat(out, "AS:i:%d", (int)(cigar->Score));
+			else
+				WriteFormat(out, "ZS:f:%.9g", (cigar->Score));//Todos los dígitos del float (ver WriteScore())
+			WriteFormat(out, "\tNM:i:%d\n", edits);
+			break;
+		case FORMAT_BIN:
+			(record.Number)=number, (record.Id1)=(out->Id1), (record.Id2)=(out->Id2), (record.Score)=(cigar->Score);
+			(record.Start1)=(cigar->Start1), (record.End1)=(cigar->Start1)+len1;
+			(record.Start2)=(cigar->Start2), (record.End2)=(cigar->Start2)+len2;
+			(record.nRuns)=(cigar->nRuns), (record.Edits)=edits;
+			PackBinRecord(bytes, &record);
+			WriteBytes(out, (const char *)bytes, BIN_RECORD_SIZE);
+			for(k=0; k<(cigar->nRuns); k++)
+			{
+				PutU32(bytes, PackBinRun((cigar->Ops)[k], (cigar->Lengths)[k]));
+				WriteBytes(out, (const char *)bytes, 4);
+			}
+			break;
+		default:
+			assert(0 && "WriteAlignRecord() no escribe el formato de texto");
+	}
+	(out->Records)++;
+}//___________________________________________________________
+
+
+
+void FlushWriter(Writer *out)
+/*
+ * Vacía stdout (lo impreso con printf() va antes) y escribe todo lo pendiente del búfer en el descriptor, con una llamada a write()
+ * (o más si el descriptor acepta menos bytes, como una tubería llena).
+ */
+{
+	size_t done;
+	ssize_t w;
+	fflush(stdout);
+	for(done=0; done < (out->Used); done+=w)
+		if((w=write((out->Fd), (out->Buffer)+done, (out->Used)-done)) <= 0)
+			break;//Error de escritura (p. ej. se cerró la tubería)
+	(out->Used)=0;
+}//___________________________________________________________
+
+
+
+void FreeWriter(Writer *out)
+/*
+ * Escribe lo pendiente y libera el Writer, sin cerrar su descriptor. out puede ser NULL.
+ */
+{
+	if(out == NULL)
+		return;
+	FlushWriter(out);
+	free(out->Buffer);
+	free(out);
+}//___________________________________________________________
+# endif
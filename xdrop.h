@@ -0,0 +1,92 @@
+# ifndef STRING_ALIGN_XDROP
+# define STRING_ALIGN_XDROP
+/*
+=========================================
+Librería: Terminación temprana (X-drop).
+=========================================
+
+Llenado de matrices de similaridad (A_Matrix con Type "max") con la terminación X-drop, para extender semillas:
+los alineamientos que empiezan en la entrada (0,0) y cuyo puntaje cae X por debajo del mejor ya calculado casi nunca
+vuelven a ser buenos, así que esas entradas se descartan (DEAD_BIT) y ya no se usan como vecinos. Cada fila sólo se recorre
+en el tramo al que llegan las entradas vivas de la anterior y el llenado termina en la primera fila sin entradas vivas.
+El resultado es la mejor extensión: el alineamiento de los prefijos de Str1 y Str2 que termina en la mejor entrada
+(AlignMatrix->BestRow, BestCol). AlignMatrix->Skipped cuenta las entradas que no se calcularon, para ajustar X.
+
+Los núcleos se generan a partir de la plantilla xdrop_kernel.h, incluida una vez por cada tipo de puntaje.
+
+Las siguientes son las funciones declaradas aquí:
+
+:void FillAlignMatrixXDrop(A_Matrix *AlignMatrix):
+	Llena la matriz completa de similaridad AlignMatrix, incluidas las orillas, con la terminación X-drop de umbral AlignMatrix->XDrop.
+
+:void FillXDropInt16(A_Matrix *AlignMatrix):
+:void FillXDropInt32(A_Matrix *AlignMatrix):
+:void FillXDropFloat(A_Matrix *AlignMatrix):
+	Núcleos X-drop para puntajes int16, int32 o float.
+
+
+Los prototipos de las funciones y las estructuras están declarados en el archivo alignments_headers.h
+
+Los algoritmos están basados en:
+	*Gapped BLAST and PSI-BLAST: a new generation of protein database search programs*
+	Stephen F. Altschul et al., Nucleic Acids Research 25(17) (1997)
+	*A greedy algorithm for aligning DNA sequences*
+	Zheng Zhang, Scott Schwartz, Lukas Wagner y Webb Miller, Journal of Computational Biology 7 (2000)
+
+:Autor:
+	Andrés García García @ 28/Feb/'16 (Inicio 19 Oct 2015)
+*/
+
+//Librerías
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>//Para usar memset()
+# include "alignments_headers.h"
+
+
+/*
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Núcleos X-drop (generados con xdrop_kernel.h).
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+
+#define KERNEL_NAME FillXDropInt16
+#define SCORE_T short
+# include "xdrop_kernel.h"
+
+#define KERNEL_NAME FillXDropInt32
+#define SCORE_T int
+# include "xdrop_kernel.h"
+
+#define KERNEL_NAME FillXDropFloat
+#define SCORE_T float
+# include "xdrop_kernel.h"
+
+
+
+/*
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Selección del núcleo X-drop.
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+
+void FillAlignMatrixXDrop(A_Matrix *AlignMatrix)
+/*
+ * Llena la matriz de similaridad AlignMatrix (completa, no por bandas) con el núcleo X-drop de su tipo de puntaje.
+ * Al terminar, AlignMatrix->BestRow y BestCol indican el final de la mejor extensión y AlignMatrix->Skipped las entradas omitidas.
+ */
+{
+	switch(AlignMatrix->ScoreType)
+	{
+		case SCORE_INT16:
+			FillXDropInt16(AlignMatrix);
+			break;
+		case SCORE_INT32:
+			FillXDropInt32(AlignMatrix);
+			break;
+		default:
+			FillXDropFloat(AlignMatrix);
+	}
+	(AlignMatrix->Engine)="xdrop";
+}//___________________________________________________________
+# endif
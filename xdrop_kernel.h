@@ -0,0 +1,107 @@
+/*
+========================================================================
+Plantilla: Núcleo escalar con terminación X-drop (xdrop_kernel.h).
+========================================================================
+
+Este archivo NO tiene guardas de inclusión: se incluye desde xdrop.h una vez por cada tipo de puntaje,
+definiendo antes las siguientes macros, y genera la función KERNEL_NAME(A_Matrix *AlignMatrix).
+Al final elimina (#undef) todas las macros, para poder incluirse de nuevo con otras definiciones.
+
+	KERNEL_NAME		Nombre de la función generada.
+	SCORE_T			Tipo de los puntajes (short, int o float), debe coincidir con AlignMatrix->ScoreType.
+
+La función llena una matriz de similaridad completa fila por fila, incluidas las orillas. En cada fila sólo se recorren las columnas
+desde la primera entrada viva de la fila anterior hasta donde ya ninguna entrada puede tener un vecino vivo; una entrada está viva
+si su puntaje no es menor que el mejor calculado hasta ese momento menos AlignMatrix->XDrop. Las entradas muertas (o no calculadas)
+se marcan con DEAD_BIT y no se usan como vecinos, por lo que los punteros de una entrada viva siempre llevan a entradas vivas.
+Los puntajes de apareamiento o reemplazo se leen del perfil de Str1 (ver BuildProfile()). Si una fila no tiene entradas vivas se termina el llenado. Coloca la mejor entrada en AlignMatrix->BestRow y BestCol
+(la primera por columnas, como FindBestEntry()) y el número de entradas no calculadas en AlignMatrix->Skipped.
+*/
+
+void KERNEL_NAME(A_Matrix *AlignMatrix)
+{
+#define STR2 (AlignMatrix->Str2)
+#define LIVE(ptr, j) (!((ptr)[j] & DEAD_BIT))
+	const int rows=(AlignMatrix->Rows), cols=(AlignMatrix->Cols);
+	const SCORE_T ins=(SCORE_T)(AlignMatrix->Scores)[2], del=(SCORE_T)(AlignMatrix->Scores)[3];
+	const float x=(AlignMatrix->XDrop);
+	SCORE_T *row=(SCORE_T *)(AlignMatrix->Values), *up;
+	const SCORE_T *prof;//Fila del perfil de Str1 (ver BuildProfile())
+	unsigned char *pointers=(AlignMatrix->Pointers), *up_pointers;
+	SCORE_T cand[3], best, top=0;//top es el mejor puntaje calculado hasta ahora
+	unsigned char bits[3];
+	int i=0, j, k, n, lo=0, hi, new_lo, new_hi, best_i=0, best_j=0;
+	double computed=1;//Entradas calculadas, empezando por la (0,0)
+
+	//Primera fila: sólo deleciones, mientras estén vivas
+	row[0]=0, pointers[0]=0;
+	for(j=1; j<cols && row[j-1]+del >= top - x; j++)
+	{
+		row[j]=row[j-1]+del, pointers[j]=HORI_BIT;
+		if(row[j] > top)
+			top=row[j], best_i=0, best_j=j;
+	}
+	computed+=j-1, hi=j-1;
+	memset(pointers+hi+1, DEAD_BIT, cols-hi-1);
+
+	for(i=1; i<rows; i++)
+	{
+		up=row, up_pointers=pointers;
+		row=(SCORE_T *)(AlignMatrix->Values) + (size_t)i*cols, pointers=(AlignMatrix->Pointers) + (size_t)i*cols;
+		prof=(const SCORE_T *)(AlignMatrix->Profile) + (size_t)(AlignMatrix->ProfileRow)[(unsigned char)STR2[i-1]]*cols;
+		new_lo=-1, new_hi=-1;
+		for(j=lo; j<cols; j++)
+		{
+			//Los candidatos, sólo desde vecinos vivos, en el orden diagonal, vertical, horizontal
+			n=0;
+			if(j > lo && j-1 <= hi && LIVE(up_pointers, j-1))
+				cand[n]=up[j-1] + prof[j], bits[n++]=DIAG_BIT;
+			if(j <= hi && LIVE(up_pointers, j))
+				cand[n]=up[j] + ins, bits[n++]=VERT_BIT;
+			if(j > lo && LIVE(pointers, j-1))
+				cand[n]=row[j-1] + del, bits[n++]=HORI_BIT;
+			if(n == 0 && j > hi)
+				break;//A la derecha ya no hay vecinos vivos
+			computed++;
+			if(n == 0)
+			{
+				pointers[j]=DEAD_BIT;
+				continue;
+			}
+			best=cand[0];
+			for(k=1; k<n; k++)
+				best=MAX(best, cand[k]);
+			if(best < top - x)//Cayó X por debajo del mejor: se descarta
+			{
+				pointers[j]=DEAD_BIT;
+				continue;
+			}
+			row[j]=best, pointers[j]=0;
+			for(k=0; k<n; k++)
+				if(cand[k] == best)
+					pointers[j]|=bits[k];
+			if(new_lo < 0)
+				new_lo=j;
+			new_hi=j;
+			if(best > top || (best == top && j < best_j))//La primera por columnas (ver FindBestEntry())
+				top=best, best_i=i, best_j=j;
+		}
+		//Las entradas no recorridas de la fila también están muertas
+		memset(pointers, DEAD_BIT, lo);
+		if(j < cols)
+			memset(pointers+j, DEAD_BIT, cols-j);
+		if(new_lo < 0)
+			break;//Ninguna entrada viva: termina el llenado
+		lo=new_lo, hi=new_hi;
+	}
+	for(i++; i<rows; i++)//Las filas que ya no se calcularon
+		memset((AlignMatrix->Pointers) + (size_t)i*cols, DEAD_BIT, cols);
+
+	(AlignMatrix->BestRow)=best_i, (AlignMatrix->BestCol)=best_j;
+	(AlignMatrix->Skipped)=(double)rows*cols - computed;
+#undef STR2
+#undef LIVE
+}//___________________________________________________________
+
+#undef KERNEL_NAME
+#undef SCORE_T